@@ -0,0 +1,161 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+// Throughput of each playback kernel per variant, as samples/s, for the
+// variants this CPU can run. The block sizes are a PipeWire quantum, an
+// ALSA period and a whole decoded sentence.
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <DspKernels.h>
+
+#if defined(__arm__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+namespace {
+
+const int BLOCK_SIZES[] = { 256, 1024, 65536 };
+
+// Same checks getDspKernels() makes before handing a variant out
+std::vector<const DspKernels*> getVariants()
+{
+    std::vector<const DspKernels*> variants = { &getScalarDspKernels() };
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (getSse2DspKernels() && __builtin_cpu_supports("sse2"))
+        variants.push_back(getSse2DspKernels());
+    if (getAvx2DspKernels() && __builtin_cpu_supports("avx2"))
+        variants.push_back(getAvx2DspKernels());
+#elif defined(__aarch64__)
+    variants.push_back(getNeonDspKernels());
+#elif defined(__arm__)
+    if (getNeonDspKernels() && (getauxval(AT_HWCAP) & HWCAP_NEON))
+        variants.push_back(getNeonDspKernels());
+#endif
+    return variants;
+}
+
+void setRate(benchmark::State& state, size_t count)
+{
+    state.counters["samples/s"] = benchmark::Counter((double) count, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void benchS16ToFloat(benchmark::State& state, const DspKernels* dsp)
+{
+    size_t count = state.range(0);
+    std::vector<int16_t> in(count, 1234);
+    std::vector<float> out(count);
+    for (auto _ : state) {
+        dsp->s16ToFloat(in.data(), out.data(), count);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    setRate(state, count);
+}
+
+void benchFloatToS16(benchmark::State& state, const DspKernels* dsp)
+{
+    size_t count = state.range(0);
+    std::vector<float> in(count, 0.3f);
+    std::vector<int16_t> out(count);
+    for (auto _ : state) {
+        dsp->floatToS16(in.data(), out.data(), count);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    setRate(state, count);
+}
+
+void benchGainRamp(benchmark::State& state, const DspKernels* dsp)
+{
+    size_t count = state.range(0);
+    std::vector<float> buf(count, 0.5f);
+    for (auto _ : state) {
+        // Unity gain keeps the samples from decaying to denormals
+        dsp->gainRamp(buf.data(), count, 1.0f, 0.0f);
+        benchmark::DoNotOptimize(buf.data());
+        benchmark::ClobberMemory();
+    }
+    setRate(state, count);
+}
+
+void benchMixAdd(benchmark::State& state, const DspKernels* dsp)
+{
+    size_t count = state.range(0);
+    std::vector<float> src(count, 0.5f);
+    std::vector<float> dst(count, 0.0f);
+    for (auto _ : state) {
+        dsp->mixAdd(dst.data(), src.data(), count, 0.0f);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    setRate(state, count);
+}
+
+void benchDot(benchmark::State& state, const DspKernels* dsp)
+{
+    size_t count = state.range(0);
+    std::vector<float> a(count, 0.5f);
+    std::vector<float> b(count, 0.25f);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(dsp->dot(a.data(), b.data(), count));
+    setRate(state, count);
+}
+
+void benchPeakS16(benchmark::State& state, const DspKernels* dsp)
+{
+    size_t count = state.range(0);
+    std::vector<int16_t> in(count, -1234);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(dsp->peakS16(in.data(), count));
+    setRate(state, count);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    typedef void (*Bench)(benchmark::State&, const DspKernels*);
+    const std::pair<const char*, Bench> kernels[] = {
+        { "s16ToFloat", benchS16ToFloat },
+        { "floatToS16", benchFloatToS16 },
+        { "gainRamp", benchGainRamp },
+        { "mixAdd", benchMixAdd },
+        { "dot", benchDot },
+        { "peakS16", benchPeakS16 },
+    };
+    // Grouped by kernel, so the variants of one sit next to each other
+    for (const auto &kernel : kernels) {
+        for (const DspKernels *dsp : getVariants()) {
+            benchmark::internal::Benchmark *bench = benchmark::RegisterBenchmark(
+                    (std::string(kernel.first) + "/" + dsp->name).c_str(), kernel.second, dsp);
+            for (int size : BLOCK_SIZES)
+                bench->Arg(size);
+        }
+    }
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+// Payload parsing and validation cost per Luna method: the schema built
+// and compiled on every call, as the handlers used to, against the schema
+// TTSLunaService compiles once. Both run LSUtils::parsePayload itself.
+// The invalid payloads take the schema error path, which parses again
+// without a schema to classify the error.
+
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <TTSLunaSchemas.h>
+
+namespace {
+
+struct Method
+{
+    const char *name;
+    const char *schema;
+    const char *payload;
+};
+
+const Method METHODS[] = {
+    { "speak", SPEAK_SCHEMA,
+      "{\"text\":\"The next train to Seoul Station arrives in three minutes.\",\"language\":\"en-US\","
+      "\"displayId\":0,\"feedback\":true,\"appID\":\"com.webos.app.test\"}" },
+    { "speakBatch", SPEAK_BATCH_SCHEMA,
+      "{\"items\":[{\"text\":\"First sentence.\"},{\"text\":\"Second sentence.\"},"
+      "{\"text\":\"Third sentence.\",\"language\":\"en-US\"}],\"displayId\":0}" },
+    { "stop", STOP_SCHEMA, "{\"msgID\":\"a1b2c3d4e5f6\",\"displayId\":0}" },
+    { "getStatus", STATUS_SCHEMA, "{\"displayId\":0,\"subscribe\":true}" },
+    { "getAvailableLanguages", DISPLAY_SCHEMA, "{\"displayId\":0}" },
+    { "speakInvalid", SPEAK_SCHEMA, "{\"text\":\"Hello\",\"volume\":3}" },
+};
+
+void BM_SchemaPerCall(benchmark::State& state)
+{
+    const Method &method = METHODS[state.range(0)];
+    std::string payload = method.payload;
+    for (auto _ : state) {
+        // What each handler did before: a schema string and a fresh
+        // JSchemaFragment per request
+        const std::string schema = method.schema;
+        pbnjson::JValue requestObj;
+        int parseError = 0;
+        benchmark::DoNotOptimize(LSUtils::parsePayload(payload, requestObj, schema, &parseError));
+        benchmark::DoNotOptimize(requestObj);
+    }
+    state.SetLabel(method.name);
+}
+
+void BM_SchemaCompiled(benchmark::State& state)
+{
+    const Method &method = METHODS[state.range(0)];
+    std::string payload = method.payload;
+    const pbnjson::JSchemaFragment schema(method.schema);
+    for (auto _ : state) {
+        pbnjson::JValue requestObj;
+        int parseError = 0;
+        benchmark::DoNotOptimize(LSUtils::parsePayload(payload, requestObj, schema, &parseError));
+        benchmark::DoNotOptimize(requestObj);
+    }
+    state.SetLabel(method.name);
+}
+
+void methodArgs(benchmark::internal::Benchmark* bench)
+{
+    for (size_t i = 0; i < sizeof(METHODS) / sizeof(METHODS[0]); i++)
+        bench->Arg((int64_t) i);
+    bench->ArgName("method");
+}
+
+}
+
+BENCHMARK(BM_SchemaPerCall)->Apply(methodArgs);
+BENCHMARK(BM_SchemaCompiled)->Apply(methodArgs);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,248 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+// Producer cost of the request queue ingress under contention: the
+// mutex/condvar queue the dispatcher shared with every producer, against
+// the MPSC ring with eventfd wakeup that RequestQueue uses now. Producers
+// stand in for the Luna main loop; the consumer stands in for the
+// dispatcher and holds its lock for holdNs per request, like its scans
+// and status notifications did. push_ns_avg and push_us_max are what a
+// producer pays per push call; ring_full counts pushes a full ring
+// rejected.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+#include <MPSCRing.h>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const int ITEMS_PER_PRODUCER = 20000;
+const size_t RING_CAPACITY = 256;
+
+struct Item
+{
+    int value = 0;
+};
+
+void spinFor(std::chrono::nanoseconds duration)
+{
+    Clock::time_point end = Clock::now() + duration;
+    while (Clock::now() < end)
+        ;
+}
+
+// Walks what is waiting, as removeRequest() and coalescing do
+int scan(const std::list<Item*>& pending)
+{
+    int sum = 0;
+    for (const Item *item : pending)
+        sum += item->value;
+    return sum;
+}
+
+// The queue before the ring: one lock for producers and the dispatcher
+class MutexQueue
+{
+public:
+    bool push(Item* item)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mPending.push_back(item);
+        }
+        mCond.notify_one();
+        return true;
+    }
+
+    Item* take(std::chrono::nanoseconds hold)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCond.wait(lock, [this] { return !mPending.empty() || mQuit; });
+        if (mPending.empty())
+            return nullptr;
+        Item *item = mPending.front();
+        mPending.pop_front();
+        benchmark::DoNotOptimize(scan(mPending));
+        spinFor(hold);
+        return item;
+    }
+
+    void quit()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mQuit = true;
+        }
+        mCond.notify_all();
+    }
+
+private:
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    std::list<Item*> mPending;
+    bool mQuit = false;
+};
+
+// Producers only touch the ring and the eventfd, the lock is the consumer's
+class RingQueue
+{
+public:
+    RingQueue() : mIngress(RING_CAPACITY), mEventFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {}
+    ~RingQueue()
+    {
+        if (mEventFd >= 0)
+            close(mEventFd);
+    }
+
+    bool push(Item* item)
+    {
+        if (!mIngress.push(item))
+            return false;
+        (void) eventfd_write(mEventFd, 1);
+        return true;
+    }
+
+    Item* take(std::chrono::nanoseconds hold)
+    {
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                Item *item = nullptr;
+                while (mIngress.pop(item))
+                    mPending.push_back(item);
+                if (!mPending.empty()) {
+                    item = mPending.front();
+                    mPending.pop_front();
+                    benchmark::DoNotOptimize(scan(mPending));
+                    spinFor(hold);
+                    return item;
+                }
+            }
+            if (mQuit)
+                return nullptr;
+            struct pollfd pfd = { mEventFd, POLLIN, 0 };
+            if (poll(&pfd, 1, 1) > 0) {
+                eventfd_t count = 0;
+                (void) eventfd_read(mEventFd, &count);
+            }
+        }
+    }
+
+    void quit()
+    {
+        mQuit = true;
+        (void) eventfd_write(mEventFd, 1);
+    }
+
+private:
+    MPSCRing<Item*> mIngress;
+    int mEventFd;
+    std::mutex mMutex;
+    std::list<Item*> mPending;
+    std::atomic<bool> mQuit {false};
+};
+
+// Args: producer threads, ns the consumer holds its lock per request
+template <typename Queue>
+void BM_IngressContention(benchmark::State& state)
+{
+    const int producers = static_cast<int>(state.range(0));
+    const std::chrono::nanoseconds hold(state.range(1));
+    std::vector<std::vector<Item>> items(producers, std::vector<Item>(ITEMS_PER_PRODUCER));
+    int64_t pushNs = 0;
+    int64_t pushMaxNs = 0;
+    int64_t retries = 0;
+
+    for (auto _ : state) {
+        Queue queue;
+        std::atomic<int64_t> iterationNs {0};
+        std::atomic<int64_t> iterationMaxNs {0};
+        std::atomic<int64_t> iterationRetries {0};
+        const int total = producers * ITEMS_PER_PRODUCER;
+
+        std::thread consumer([&queue, hold, total]() {
+            for (int taken = 0; taken < total && queue.take(hold); taken++)
+                ;
+        });
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&, p]() {
+                int64_t sum = 0;
+                int64_t worst = 0;
+                int64_t full = 0;
+                for (Item& item : items[p]) {
+                    // A full ring rejects the request, which is counted and
+                    // retried so both queues move the same items
+                    for (;;) {
+                        Clock::time_point start = Clock::now();
+                        bool pushed = queue.push(&item);
+                        int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                Clock::now() - start).count();
+                        sum += ns;
+                        worst = std::max(worst, ns);
+                        if (pushed)
+                            break;
+                        full++;
+                        std::this_thread::yield();
+                    }
+                }
+                iterationNs += sum;
+                iterationRetries += full;
+                int64_t seen = iterationMaxNs.load();
+                while (worst > seen && !iterationMaxNs.compare_exchange_weak(seen, worst))
+                    ;
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        consumer.join();
+        queue.quit();
+
+        pushNs += iterationNs;
+        pushMaxNs = std::max(pushMaxNs, iterationMaxNs.load());
+        retries += iterationRetries;
+    }
+
+    int64_t pushes = state.iterations() * producers * ITEMS_PER_PRODUCER;
+    state.SetItemsProcessed(pushes);
+    state.counters["push_ns_avg"] = static_cast<double>(pushNs) / (pushes + retries);
+    state.counters["push_us_max"] = pushMaxNs / 1000.0;
+    state.counters["ring_full"] = static_cast<double>(retries);
+}
+
+BENCHMARK_TEMPLATE(BM_IngressContention, MutexQueue)
+    ->ArgsProduct({{1, 2, 4}, {0, 2000}})->ArgNames({"producers", "holdNs"})
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_IngressContention, RingQueue)
+    ->ArgsProduct({{1, 2, 4}, {0, 2000}})->ArgNames({"producers", "holdNs"})
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,131 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+// Allocations and CPU per speak request, from the payload to filled-in
+// Parameters. BM_SpeakTwoParses is the old path: speak() validated the
+// payload, addParameters() parsed it a second time without a schema, and
+// the text was copied into both Parameters and SpeakRequest. BM_SpeakOneParse
+// is the current one: one validated parse, one copy of the text.
+// Both fill Parameters with LSUtils::parseSpeakParameters, as addParameters()
+// does. allocs counts every malloc, including pbnjson's own.
+
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <benchmark/benchmark.h>
+#include <TTSLunaSchemas.h>
+#include <TTSLunaUtils.h>
+#include <TTSParameters.h>
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+namespace {
+
+std::atomic<long> gAllocs { 0 };
+
+}
+
+// glibc lets the executable interpose these; operator new ends up here too
+extern "C" void* malloc(size_t size)
+{
+    gAllocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+    gAllocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size)
+{
+    gAllocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+namespace {
+
+std::string makePayload(size_t textLength)
+{
+    std::string text;
+    const std::string sentence = "The next train to Seoul Station arrives in three minutes. ";
+    while (text.size() < textLength)
+        text += sentence;
+    text.resize(textLength);
+    return "{\"text\":\"" + text + "\",\"language\":\"en-US\",\"displayId\":0,\"feedback\":true,"
+            "\"appID\":\"com.webos.app.test\"}";
+}
+
+void report(benchmark::State& state, long allocs)
+{
+    state.counters["allocs"] = benchmark::Counter((double) allocs, benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_SpeakTwoParses(benchmark::State& state)
+{
+    std::string payload = makePayload(state.range(0));
+    const pbnjson::JSchemaFragment schema(SPEAK_SCHEMA);
+    long before = gAllocs.load();
+    for (auto _ : state) {
+        pbnjson::JValue requestObj;
+        int parseError = 0;
+        if (!LSUtils::parsePayload(payload, requestObj, schema, &parseError))
+            state.SkipWithError("speak payload rejected");
+        // addParameters() wrapped the message again and parsed the payload
+        pbnjson::JValue paramsObj = pbnjson::Object();
+        (void) LSUtils::parsePayload(payload, paramsObj);
+        Parameters *params = new Parameters;
+        (void) LSUtils::parseSpeakParameters(paramsObj, *params);
+        // SpeakRequest::text_to_speak
+        std::string textToSpeak = requestObj["text"].asString();
+        benchmark::DoNotOptimize(textToSpeak.data());
+        benchmark::DoNotOptimize(params);
+        delete params;
+    }
+    report(state, gAllocs.load() - before);
+}
+
+void BM_SpeakOneParse(benchmark::State& state)
+{
+    std::string payload = makePayload(state.range(0));
+    const pbnjson::JSchemaFragment schema(SPEAK_SCHEMA);
+    long before = gAllocs.load();
+    for (auto _ : state) {
+        pbnjson::JValue requestObj;
+        int parseError = 0;
+        if (!LSUtils::parsePayload(payload, requestObj, schema, &parseError))
+            state.SkipWithError("speak payload rejected");
+        Parameters *params = new Parameters;
+        (void) LSUtils::parseSpeakParameters(requestObj, *params);
+        benchmark::DoNotOptimize(params);
+        delete params;
+    }
+    report(state, gAllocs.load() - before);
+}
+
+}
+
+// Text length: a short prompt and a long paragraph
+BENCHMARK(BM_SpeakTwoParses)->Arg(40)->Arg(2000)->ArgName("textLength");
+BENCHMARK(BM_SpeakOneParse)->Arg(40)->Arg(2000)->ArgName("textLength");
+
+BENCHMARK_MAIN();
@@ -0,0 +1,74 @@
+#!/bin/sh
+# Copyright (c) 2026 LG Electronics, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# SPDX-License-Identifier: Apache-2.0
+
+# Thread count, RSS and context switches per utterance, in the threaded
+# and the reactor execution mode. Runs on the target as root: it sets
+# engine.executionMode in the config, restarts the service, speaks the
+# utterances one after another and diffs the "process" section of
+# getMetrics taken before and after. metrics.utteranceStats is turned on
+# so the peak thread count is sampled at every utterance. The config is
+# restored on exit.
+#
+# Usage: utterance-cost.sh [utterances] [text]
+
+UTTERANCES=${1:-20}
+TEXT=${2:-"The quick brown fox jumps over the lazy dog."}
+CONFIG=/etc/palm/tts/tts_config.json
+SERVICE=luna://com.webos.service.tts
+
+cp "$CONFIG" "$CONFIG.orig" || exit 1
+trap 'mv "$CONFIG.orig" "$CONFIG"; systemctl restart com.webos.service.tts' EXIT
+
+# Value of a numeric key in luna-send -f output
+field() {
+    sed -n "s/.*\"$1\": *\([0-9][0-9]*\).*/\1/p" | head -n 1
+}
+
+process_metrics() {
+    luna-send -n 1 -f "$SERVICE/getMetrics" '{}'
+}
+
+measure() {
+    mode=$1
+    sed -e "s/\"executionMode\" *: *\"[a-z]*\"/\"executionMode\" : \"$mode\"/" \
+        -e "s/\"utteranceStats\" *: *false/\"utteranceStats\" : true/" \
+        "$CONFIG.orig" > "$CONFIG"
+    systemctl restart com.webos.service.tts
+    sleep 2
+    # The first utterance pays for engine start up, connections and caches
+    luna-send -n 2 "$SERVICE/speak" "{\"text\":\"$TEXT\",\"subscribe\":true}" > /dev/null
+
+    before=$(process_metrics)
+    i=0
+    while [ $i -lt "$UTTERANCES" ]; do
+        # The second reply is the final status of the utterance
+        luna-send -n 2 "$SERVICE/speak" "{\"text\":\"$TEXT\",\"subscribe\":true}" > /dev/null
+        i=$((i + 1))
+    done
+    after=$(process_metrics)
+
+    ctxsw=$(( $(echo "$after" | field contextSwitches) - $(echo "$before" | field contextSwitches) ))
+    rss=$(( $(echo "$after" | field rssKb) - $(echo "$before" | field rssKb) ))
+    echo "$mode: utterances $UTTERANCES" \
+        "idle threads $(echo "$after" | field threads)" \
+        "peak threads $(echo "$after" | field peakThreads)" \
+        "rss $(echo "$after" | field rssKb)kB (${rss}kB over the run)" \
+        "ctxsw/utterance $((ctxsw / UTTERANCES))"
+}
+
+measure threaded
+measure reactor
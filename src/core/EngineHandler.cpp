@@ -14,6 +14,7 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
 #include <iostream>
 #include <stdint.h>
 #include <AudioEngineFactory.h>
@@ -23,16 +24,20 @@
 #include <TTSLog.h>
 #include <TTSLunaUtils.h>
 #include <TTSRequest.h>
+#include <TTSUtils.h>
 #include <StatusHandler.h>
 
+#define DEFAULT_DISPLAY_COUNT 1
+#define EXECUTION_MODE_REACTOR "reactor"
+
 EngineHandler::EngineHandler()
 {
     LOG_INFO(MSGID_ENGINE_HANDLER, 0, "%s", __FUNCTION__);
-    mCurrentLanguage[DISPLAY_0] = "en-US";
-    mCurrentLanguage[DISPLAY_1] = "en-US";
-    meTTSTaskStatus[DISPLAY_0] = TTS_TASK_NOT_READY;
-    meTTSTaskStatus[DISPLAY_1] = TTS_TASK_NOT_READY;
     loadEngine();
+    // Keep at least one pipeline so requests fail on the missing engine
+    // rather than being rejected as an invalid display
+    if (mDisplays.empty())
+        mDisplays.emplace_back(new DisplayState);
 }
 
 EngineHandler::~EngineHandler()
@@ -46,8 +51,18 @@ bool EngineHandler::handleRequest(TTSRequest* request, unsigned int displayId)
     LOG_INFO(MSGID_ENGINE_HANDLER, 0, "%s type: %d disp: %u", __FUNCTION__,
             request->getType(), displayId);
 
-    if (!mTTSEngine[displayId] || !mAudioEngine[displayId]) {
-        meTTSTaskStatus[displayId] = TTS_TASK_ERROR;
+    if (displayId >= mDisplays.size()) {
+        LOG_INFO(MSGID_ENGINE_HANDLER, 0, "%s Invalid display: %u",
+                __FUNCTION__, displayId);
+        return false;
+    }
+    DisplayState &display = *mDisplays[displayId];
+
+    if (!mTTSEngine || !mAudioEngine) {
+        {
+            std::lock_guard<std::mutex> lock(display.statusMutex);
+            display.eTaskStatus = TTS_TASK_ERROR;
+        }
         LOG_INFO(MSGID_ENGINE_HANDLER, 0, "Engine/(s) Not Created %s",
                 __FUNCTION__);
         return false;
@@ -56,81 +71,210 @@ bool EngineHandler::handleRequest(TTSRequest* request, unsigned int displayId)
     if (request->getType() == SPEAK) {
         int ttsRet = false;
         bool audioRet = false;
-        unsigned int displayID = 0;
 
         RequestType *pRequestType = request->getRequest();
         SpeakRequest *pSpeakRequest =
                 reinterpret_cast<SpeakRequest*>(pRequestType);
 
-        pSpeakRequest->msgParameters->eTaskStatus = TTS_TASK_READY;
-        saveSpeakRequestInfo(pSpeakRequest, displayId);
-        meTTSTaskStatus[displayId] = TTS_TASK_READY;
-        mCurrentLanguage[displayId] = pSpeakRequest->msgParameters->sLangStr;
-        displayID = pSpeakRequest->msgParameters->displayId;
-
-        pSpeakRequest->msgParameters->eStatus = TTS_MSG_PLAY;
-
-        LOG_INFO(MSGID_ENGINE_HANDLER, 0,
-                "Delegate Speak Request to speech engine on display: %u",
-                displayID);
-        ttsRet = mTTSEngine[displayID]->speak(pSpeakRequest->text_to_speak,
-                pSpeakRequest->sh, pSpeakRequest->msgParameters->sLangStr,
-                displayID);
+        AudioVoice voice = getVoice(pSpeakRequest);
+        beginSpeak(pSpeakRequest, displayId);
+        unsigned int slot = TTSUtils::getVoiceSlot(displayId, voice, mDisplays.size());
+        AudioMetrics::Clock::time_point synthStart = AudioMetrics::Clock::now();
+        ttsRet = mTTSEngine->speak(pSpeakRequest->msgParameters->sText,
+                pSpeakRequest->sh, pSpeakRequest->msgParameters->sLangStr, slot);
+        display.synthesis.record(AudioMetrics::elapsedUs(synthStart));
         if (ttsRet == TTSErrors::ERROR_NONE) {
+            // The next batch item is synthesized while this one plays
+            if (!pSpeakRequest->msgParameters->sLookahead.empty())
+                mTTSEngine->prefetch(pSpeakRequest->msgParameters->sLookahead,
+                        pSpeakRequest->msgParameters->sLangStr, slot);
             LOG_INFO(MSGID_ENGINE_HANDLER, 0,
-                    "Play speak request on audio engine on display: %u",
-                    displayID);
-            audioRet = mAudioEngine[displayID]->play(displayID);
-        } else if (ttsRet == TTSErrors::LANG_NOT_SUPPORTED) {
-            LOG_INFO(MSGID_ENGINE_HANDLER, 0, "%s Language Not Supported",
-                    __FUNCTION__);
-            pSpeakRequest->msgParameters->eTaskStatus = TTS_TASK_ERROR;
-            pSpeakRequest->msgParameters->eLang = LANG_ERR;
-            meTTSTaskStatus[displayId] = TTS_TASK_ERROR;
+                    "Play speak request on audio engine on display: %u voice: %d",
+                    displayId, (int )voice);
+            if (voice == VOICE_SPEECH)
+                mAudioEngine->setNextPending(displayId,
+                        pSpeakRequest->msgParameters->bHasNext);
+            audioRet = mAudioEngine->play(displayId, voice);
         }
-
-        if (audioRet) {
-            if (TTS_MSG_PLAY == pSpeakRequest->msgParameters->eStatus)
-                pSpeakRequest->msgParameters->eStatus = TTS_MSG_DONE;
-            meTTSTaskStatus[displayId] = TTS_TASK_DONE;
-        } else {
-            meTTSTaskStatus[displayId] = TTS_TASK_ERROR;
-            LOG_INFO(MSGID_ENGINE_HANDLER, 0, "Play Error %s", __FUNCTION__);
-            pSpeakRequest->msgParameters->eTaskStatus = TTS_TASK_ERROR;
-            pSpeakRequest->msgParameters->eStatus = TTS_MSG_ERROR;
-        }
-
-        {
-            std::lock_guard < std::mutex > lck(mRunningInfoMutex[displayID]);
-            auto found = mSpeakRequestInfoMap.find(displayId);
-            if (found != mSpeakRequestInfoMap.end()) {
-                if (found->second.msgStatus == TTS_MSG_STOP)
-                    pSpeakRequest->msgParameters->eStatus = TTS_MSG_STOP;
-            }
-        }
-
-        if (pSpeakRequest->msgParameters->bSubscribed) {
-            LOG_INFO(MSGID_ENGINE_HANDLER, 0, "%s notify speak update",
-                    __FUNCTION__);
-            pSpeakRequest->replyCB(pSpeakRequest->msgParameters,
-                    pSpeakRequest->message);
-        }
-
-        removeSpeakRequestInfo(displayID);
+        finishSpeak(pSpeakRequest, displayId, ttsRet, audioRet);
     } else if (request->getType() == STOP) {
+        StopRequest *pStopRequest =
+                reinterpret_cast<StopRequest*>(request->getRequest());
         SpeakRequestInfo info;
-        bool speakRequestFound = getSpeakRequestInfo(displayId, info);
-        if (speakRequestFound) {
+        if (pStopRequest->stopSpeech && getSpeakRequestInfo(displayId, info)) {
             LOG_INFO(MSGID_ENGINE_HANDLER, 0,
                     "Stop running speak request on display: %u", displayId);
             updateSpeakRequestInfo(displayId, TTS_MSG_STOP);
-            (void) mTTSEngine[displayId]->stop(displayId);
-            (void) mAudioEngine[displayId]->stop(displayId);
+            (void) mTTSEngine->stop(displayId);
+            (void) mAudioEngine->stop(displayId, VOICE_SPEECH);
         }
+        if (pStopRequest->stopAlert
+                && getSpeakRequestInfo(displayId, info, VOICE_ALERT)) {
+            LOG_INFO(MSGID_ENGINE_HANDLER, 0,
+                    "Stop running urgent request on display: %u", displayId);
+            updateSpeakRequestInfo(displayId, TTS_MSG_STOP, VOICE_ALERT);
+            (void) mTTSEngine->stop(TTSUtils::getVoiceSlot(displayId,
+                    VOICE_ALERT, mDisplays.size()));
+            (void) mAudioEngine->stop(displayId, VOICE_ALERT);
+        }
+    } else if (request->getType() == PAUSE) {
+        // Pausing during synthesis holds the utterance once it plays
+        SpeakRequestInfo info;
+        if (!getSpeakRequestInfo(displayId, info))
+            return false;
+        LOG_INFO(MSGID_ENGINE_HANDLER, 0, "Pause speech on display: %u",
+                displayId);
+        return mAudioEngine->pause(displayId);
+    } else if (request->getType() == RESUME) {
+        LOG_INFO(MSGID_ENGINE_HANDLER, 0, "Resume speech on display: %u",
+                displayId);
+        return mAudioEngine->resume(displayId);
     }
     return true;
 }
 
+void EngineHandler::handleRequestAsync(TTSRequest* request,
+        unsigned int displayId, std::function<void(bool)> done)
+{
+    // Only speaking takes time, everything else completes in place
+    if (request->getType() != SPEAK || displayId >= mDisplays.size()
+            || !mTTSEngine || !mAudioEngine) {
+        done(handleRequest(request, displayId));
+        return;
+    }
+
+    SpeakRequest *pSpeakRequest =
+            reinterpret_cast<SpeakRequest*>(request->getRequest());
+    AudioVoice voice = getVoice(pSpeakRequest);
+    beginSpeak(pSpeakRequest, displayId);
+    AudioMetrics::Clock::time_point synthStart = AudioMetrics::Clock::now();
+    mTTSEngine->speakAsync(pSpeakRequest->msgParameters->sText, pSpeakRequest->sh,
+            pSpeakRequest->msgParameters->sLangStr,
+            TTSUtils::getVoiceSlot(displayId, voice, mDisplays.size()),
+            [this, pSpeakRequest, displayId, voice, done, synthStart](int ttsRet) {
+        mDisplays[displayId]->synthesis.record(AudioMetrics::elapsedUs(synthStart));
+        if (ttsRet != TTSErrors::ERROR_NONE) {
+            finishSpeak(pSpeakRequest, displayId, ttsRet, false);
+            done(true);
+            return;
+        }
+        LOG_INFO(MSGID_ENGINE_HANDLER, 0,
+                "Play speak request on audio engine on display: %u voice: %d",
+                displayId, (int )voice);
+        if (voice == VOICE_SPEECH)
+            mAudioEngine->setNextPending(displayId,
+                    pSpeakRequest->msgParameters->bHasNext);
+        mAudioEngine->playAsync(displayId, voice,
+                [this, pSpeakRequest, displayId, done](bool audioRet) {
+            finishSpeak(pSpeakRequest, displayId, TTSErrors::ERROR_NONE,
+                    audioRet);
+            done(true);
+        });
+    });
+}
+
+void EngineHandler::beginSpeak(SpeakRequest* pSpeakRequest,
+        unsigned int displayId)
+{
+    DisplayState &display = *mDisplays[displayId];
+
+    pSpeakRequest->msgParameters->eTaskStatus = TTS_TASK_READY;
+    pSpeakRequest->msgParameters->eStatus = TTS_MSG_PLAY;
+    // Urgent prompts overlay the display's speech and leave its state alone
+    AudioVoice voice = getVoice(pSpeakRequest);
+    saveSpeakRequestInfo(pSpeakRequest, displayId, voice);
+    if (voice == VOICE_SPEECH) {
+        if (mUtteranceStats)
+            (void) TTSUtils::getProcessStats(display.utteranceStats);
+        {
+            std::lock_guard<std::mutex> lock(display.statusMutex);
+            display.eTaskStatus = TTS_TASK_READY;
+            display.currentLanguage = pSpeakRequest->msgParameters->sLangStr;
+        }
+        if (mStatusListener)
+            mStatusListener(displayId);
+    }
+
+    LOG_INFO(MSGID_ENGINE_HANDLER, 0,
+            "Delegate Speak Request to speech engine on display: %u",
+            displayId);
+}
+
+void EngineHandler::finishSpeak(SpeakRequest* pSpeakRequest,
+        unsigned int displayId, int ttsRet, bool audioRet)
+{
+    DisplayState &display = *mDisplays[displayId];
+    AudioVoice voice = getVoice(pSpeakRequest);
+    bool speech = (voice == VOICE_SPEECH);
+    Task_Status_t taskStatus = TTS_TASK_ERROR;
+
+    if (ttsRet == TTSErrors::LANG_NOT_SUPPORTED) {
+        LOG_INFO(MSGID_ENGINE_HANDLER, 0, "%s Language Not Supported",
+                __FUNCTION__);
+        pSpeakRequest->msgParameters->eTaskStatus = TTS_TASK_ERROR;
+        pSpeakRequest->msgParameters->eLang = LANG_ERR;
+    }
+
+    if (audioRet) {
+        if (TTS_MSG_PLAY == pSpeakRequest->msgParameters->eStatus)
+            pSpeakRequest->msgParameters->eStatus = TTS_MSG_DONE;
+        taskStatus = TTS_TASK_DONE;
+    } else {
+        taskStatus = TTS_TASK_ERROR;
+        LOG_INFO(MSGID_ENGINE_HANDLER, 0, "Play Error %s", __FUNCTION__);
+        pSpeakRequest->msgParameters->eTaskStatus = TTS_TASK_ERROR;
+        pSpeakRequest->msgParameters->eStatus = TTS_MSG_ERROR;
+    }
+
+    if (speech) {
+        std::lock_guard<std::mutex> lock(display.statusMutex);
+        display.eTaskStatus = taskStatus;
+    }
+    {
+        std::lock_guard < std::mutex > lck(display.runningInfoMutex);
+        if (display.hasSpeakRequestInfo[voice]
+                && display.speakRequestInfo[voice].msgStatus == TTS_MSG_STOP)
+            pSpeakRequest->msgParameters->eStatus = TTS_MSG_STOP;
+    }
+
+    if (pSpeakRequest->msgParameters->bSubscribed) {
+        LOG_INFO(MSGID_ENGINE_HANDLER, 0, "%s notify speak update",
+                __FUNCTION__);
+        pSpeakRequest->replyCB(pSpeakRequest->msgParameters,
+                pSpeakRequest->message);
+    }
+
+    if (!speech) {
+        removeSpeakRequestInfo(displayId, voice);
+        return;
+    }
+    // A pause taken during synthesis must not hold the next utterance
+    if (ttsRet != TTSErrors::ERROR_NONE)
+        (void) mAudioEngine->resume(displayId);
+    removeSpeakRequestInfo(displayId);
+    if (mStatusListener)
+        mStatusListener(displayId);
+
+    mUtterances++;
+    ProcessStats stats;
+    if (mUtteranceStats && TTSUtils::getProcessStats(stats)) {
+        int peak = mPeakThreads.load();
+        while (stats.threads > peak
+                && !mPeakThreads.compare_exchange_weak(peak, stats.threads))
+            ;
+        LOG_DEBUG("utterance stats mode: %s disp: %u threads: %d rss: %ldkB (%+ldkB) ctxsw: %ld",
+                mReactorMode ? "reactor" : "threaded", displayId,
+                stats.threads, stats.rssKb,
+                stats.rssKb - display.utteranceStats.rssKb,
+                stats.contextSwitches - display.utteranceStats.contextSwitches);
+    }
+}
+
+AudioVoice EngineHandler::getVoice(SpeakRequest* pSpeakRequest)
+{
+    return pSpeakRequest->msgParameters->bUrgent ? VOICE_ALERT : VOICE_SPEECH;
+}
+
 void EngineHandler::loadEngine()
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
@@ -165,33 +309,43 @@ void EngineHandler::loadEngine()
     if(err != TTSErrors::TTS_CONFIG_ERROR_NONE)
     {
         LOG_DEBUG("Error In Reading Config for displayCount: %d ", err);
+    }
+    pbnjson::JValue executionMode;
+    if (getConfigValue("engine", "executionMode", executionMode)
+            && executionMode.isString())
+        mReactorMode = (executionMode.asString() == EXECUTION_MODE_REACTOR);
+    LOG_DEBUG("executionMode = %s", mReactorMode ? "reactor" : "threaded");
+    pbnjson::JValue utteranceStats;
+    if (getConfigValue("metrics", "utteranceStats", utteranceStats)
+            && utteranceStats.isBoolean())
+        mUtteranceStats = utteranceStats.asBool();
+    unsigned int displayCount = DEFAULT_DISPLAY_COUNT;
+    if (mDisplayCount.isNumber() && mDisplayCount.asNumber<int>() > 0)
+        displayCount = mDisplayCount.asNumber<int>();
+    LOG_DEBUG("displayCount =  %u :", displayCount);
+    for (unsigned int displayID = 0; displayID < displayCount; displayID++)
+        mDisplays.emplace_back(new DisplayState);
+
+    mTTSEngine = TTSEngineFactory::createTTSEngine(mTTSEngineName.asString());
+    if(!mTTSEngine)
+    {
+        LOG_DEBUG("TTSEngine %s Not Found", mTTSEngineName.asString().c_str());
         return;
     }
-    if (mDisplayCount.isNumber())
+    LOG_DEBUG("TTSEngine %s Created", mTTSEngineName.asString().c_str());
+    mAudioEngine = AudioEngineFactory::createAudioEngine(mAudioEngineName.asString());
+    if(!mAudioEngine)
     {
-        int displayCount = mDisplayCount.asNumber<int>();
-        LOG_DEBUG("displayCount =  %d :", displayCount);
-        for (unsigned int displayID = 0; displayID < displayCount; displayID++)
-        {
-            mTTSEngine[displayID] = TTSEngineFactory::createTTSEngine(mTTSEngineName.asString());
-            if(!mTTSEngine[displayID])
-            {
-                LOG_DEBUG("TTSEngine %s %u Not Found", mTTSEngineName.asString().c_str(), displayID);
-                return;
-            }
-            LOG_DEBUG("TTSEngine %s %u Created", mTTSEngineName.asString().c_str(), displayID);
-            mAudioEngine[displayID] = AudioEngineFactory::createAudioEngine(mAudioEngineName.asString());
-            if(!mAudioEngine[displayID])
-            {
-                LOG_DEBUG("AudioEngine %s %u Not Found", mAudioEngineName.asString().c_str(), displayID);
-                return;
-            }
-            LOG_DEBUG("AudioEngine %s %u Created", mAudioEngineName.asString().c_str(), displayID);
-
-            // TODO: Decide if init required
-            mTTSEngine[displayID]->init();
-        }
+        LOG_DEBUG("AudioEngine %s Not Found", mAudioEngineName.asString().c_str());
+        return;
     }
+    LOG_DEBUG("AudioEngine %s Created", mAudioEngineName.asString().c_str());
+
+    // One synthesis slot per display and voice
+    mTTSEngine->init(displayCount * VOICE_COUNT);
+    if (mReactorMode)
+        mAudioEngine->attachToMainLoop();
+    mAudioEngine->init(displayCount);
 }
 
 void EngineHandler::unloadEngine()
@@ -204,16 +358,34 @@ void EngineHandler::unloadEngine()
     }
 }
 
+bool EngineHandler::getConfigValue(const std::string& category,
+        const std::string& key, pbnjson::JValue& value) const
+{
+    if (!mConfigHandler)
+        return false;
+    if (mConfigHandler->getValue(category, key, value) != TTSErrors::TTS_CONFIG_ERROR_NONE)
+        return false;
+    return value.isValid() && !value.isNull();
+}
+
 void EngineHandler::getStatusInfo(TTSRequest* pTTSRequest, unsigned int displayId)
 {
     LOG_INFO(MSGID_ENGINE_HANDLER, 0, "%s", __FUNCTION__);
     RequestType* pReqType =  pTTSRequest->getRequest();
     GetStatusRequest* pgetStatusRequest = reinterpret_cast<GetStatusRequest*>(pReqType);
-    pgetStatusRequest->pTTSStatus->status =  GET_TASK_STATUS_TEXT(meTTSTaskStatus[displayId]);
-    pgetStatusRequest->pTTSStatus->ttsLanguageStr = mCurrentLanguage[displayId];
+    if (displayId >= mDisplays.size())
+        return;
+    {
+        DisplayState &display = *mDisplays[displayId];
+        std::lock_guard<std::mutex> lock(display.statusMutex);
+        pgetStatusRequest->pTTSStatus->status =  GET_TASK_STATUS_TEXT(display.eTaskStatus);
+        pgetStatusRequest->pTTSStatus->ttsLanguageStr = display.currentLanguage;
+    }
 
-    pgetStatusRequest->pTTSStatus->pitch = mTTSEngine[displayId]->getPitch();
-    pgetStatusRequest->pTTSStatus->speechRate = mTTSEngine[displayId]->getSpeakRate();
+    if (mTTSEngine) {
+        pgetStatusRequest->pTTSStatus->pitch = mTTSEngine->getPitch();
+        pgetStatusRequest->pTTSStatus->speechRate = mTTSEngine->getSpeakRate();
+    }
 }
 
 void EngineHandler::getLanguages(TTSRequest* pTTSRequest, unsigned int displayId)
@@ -221,29 +393,33 @@ void EngineHandler::getLanguages(TTSRequest* pTTSRequest, unsigned int displayId
     LOG_INFO(MSGID_ENGINE_HANDLER, 0, "%s", __FUNCTION__);
      RequestType* ptrRequestType = pTTSRequest->getRequest();
      GetLanguageRequest* ptrGetLanguageRequest = reinterpret_cast<GetLanguageRequest*>(ptrRequestType);
-     mTTSEngine[displayId]->getSupportedLanguages(ptrGetLanguageRequest->vecLanguages, displayId);
+     if (mTTSEngine && displayId < mDisplays.size())
+         mTTSEngine->getSupportedLanguages(ptrGetLanguageRequest->vecLanguages, displayId);
 }
 
 void EngineHandler::saveSpeakRequestInfo(SpeakRequest* request,
-        unsigned int displayId) {
+        unsigned int displayId, AudioVoice voice) {
     LOG_INFO(MSGID_ENGINE_HANDLER, 0, "%s", __FUNCTION__);
-    std::lock_guard<std::mutex> lck (mRunningInfoMutex[displayId]);
-    SpeakRequestInfo info;
+    if (displayId >= mDisplays.size())
+        return;
+    DisplayState &display = *mDisplays[displayId];
+    std::lock_guard<std::mutex> lck (display.runningInfoMutex);
+    SpeakRequestInfo &info = display.speakRequestInfo[voice];
     info.displayId = displayId;
     info.appId = request->msgParameters->sAppID;
     info.msgId = request->msgParameters->sMsgID;
     info.msgStatus = TTS_MSG_PLAY;
-    mSpeakRequestInfoMap.insert({ displayId, info });
+    display.hasSpeakRequestInfo[voice] = true;
 }
-bool EngineHandler::getSpeakRequestInfo(unsigned int displayId, SpeakRequestInfo& info) {
+bool EngineHandler::getSpeakRequestInfo(unsigned int displayId, SpeakRequestInfo& info,
+        AudioVoice voice) {
     LOG_INFO(MSGID_ENGINE_HANDLER, 0, "%s", __FUNCTION__);
-    std::lock_guard<std::mutex> lck (mRunningInfoMutex[displayId]);
-    auto found = mSpeakRequestInfoMap.find(displayId);
-    if(found != mSpeakRequestInfoMap.end()) {
-        info.displayId = found->second.displayId;
-        info.appId = found->second.appId;
-        info.msgId = found->second.msgId;
-        info.msgStatus = found->second.msgStatus;
+    if (displayId >= mDisplays.size())
+        return false;
+    DisplayState &display = *mDisplays[displayId];
+    std::lock_guard<std::mutex> lck (display.runningInfoMutex);
+    if(display.hasSpeakRequestInfo[voice]) {
+        info = display.speakRequestInfo[voice];
         LOG_INFO(MSGID_ENGINE_HANDLER, 0, "%s return found request", __FUNCTION__);
         return true;
     }
@@ -251,20 +427,70 @@ bool EngineHandler::getSpeakRequestInfo(unsigned int displayId, SpeakRequestInfo
 
 }
 void EngineHandler::updateSpeakRequestInfo(unsigned int displayId,
-        MsgStatus_t msgStatus) {
+        MsgStatus_t msgStatus, AudioVoice voice) {
     LOG_INFO(MSGID_ENGINE_HANDLER, 0, "%s", __FUNCTION__);
-    std::lock_guard < std::mutex > lck(mRunningInfoMutex[displayId]);
-    auto found = mSpeakRequestInfoMap.find(displayId);
-    if (found != mSpeakRequestInfoMap.end()) {
-        found->second.msgStatus = msgStatus;
+    if (displayId >= mDisplays.size())
+        return;
+    DisplayState &display = *mDisplays[displayId];
+    std::lock_guard < std::mutex > lck(display.runningInfoMutex);
+    if (display.hasSpeakRequestInfo[voice]) {
+        display.speakRequestInfo[voice].msgStatus = msgStatus;
     }
 }
 
-void EngineHandler::removeSpeakRequestInfo(unsigned int displayId) {
+void EngineHandler::removeSpeakRequestInfo(unsigned int displayId,
+        AudioVoice voice) {
     LOG_INFO(MSGID_ENGINE_HANDLER, 0, "%s", __FUNCTION__);
-    std::lock_guard < std::mutex > lck(mRunningInfoMutex[displayId]);
-    auto found = mSpeakRequestInfoMap.find(displayId);
-    if (found != mSpeakRequestInfoMap.end()) {
-        mSpeakRequestInfoMap.erase(found);
+    if (displayId >= mDisplays.size())
+        return;
+    DisplayState &display = *mDisplays[displayId];
+    std::lock_guard < std::mutex > lck(display.runningInfoMutex);
+    display.hasSpeakRequestInfo[voice] = false;
+}
+
+unsigned int EngineHandler::getDisplayCount() const {
+    return mDisplays.size();
+}
+
+bool EngineHandler::isReactorMode() const {
+    return mReactorMode;
+}
+
+void EngineHandler::setStatusListener(std::function<void(unsigned int)> listener) {
+    mStatusListener = std::move(listener);
+}
+
+pbnjson::JValue EngineHandler::getProcessMetrics() const {
+    pbnjson::JValue metrics = pbnjson::Object();
+    metrics.put("executionMode", mReactorMode ? "reactor" : "threaded");
+    metrics.put("utterances", (int) mUtterances.load());
+    ProcessStats stats;
+    bool sampled = TTSUtils::getProcessStats(stats);
+    // Without utteranceStats only the samples taken here count
+    metrics.put("peakThreads", std::max(mPeakThreads.load(), sampled ? stats.threads : 0));
+    if (sampled) {
+        metrics.put("threads", stats.threads);
+        metrics.put("rssKb", (int64_t) stats.rssKb);
+        metrics.put("contextSwitches", (int64_t) stats.contextSwitches);
     }
+    return metrics;
+}
+
+// Counters only, safe to read while the display is speaking
+pbnjson::JValue EngineHandler::getMetrics(unsigned int displayId) const {
+    pbnjson::JValue metrics = pbnjson::Object();
+    metrics.put("displayId", (int) displayId);
+    if (displayId >= mDisplays.size())
+        return metrics;
+    metrics.put("synthesis", mDisplays[displayId]->synthesis.toJson());
+    const AudioMetrics *audio = mAudioEngine ? mAudioEngine->getMetrics(displayId) : nullptr;
+    if (audio) {
+        metrics.put("audioEngine", mAudioEngineName.asString());
+        metrics.put("audio", audio->toJson());
+    }
+    return metrics;
+}
+
+const AudioTap* EngineHandler::getAudioTap(unsigned int displayId) const {
+    return mAudioEngine ? mAudioEngine->getTap(displayId) : nullptr;
 }
@@ -17,11 +17,34 @@
 #include <RequestHandler.h>
 #include <StatusHandler.h>
 
+RequestHandler::DisplayPipeline::DisplayPipeline(unsigned int displayId,
+        size_t ingressCapacity) :
+        speakQueue("QUEUE_SPEAK_" + std::to_string(displayId + 1),
+                ingressCapacity), alertQueue(
+                "QUEUE_ALERT_" + std::to_string(displayId + 1),
+                ingressCapacity), controlQueue(
+                "QUEUE_CONTROL_" + std::to_string(displayId + 1),
+                ingressCapacity) {
+}
+
 RequestHandler::RequestHandler(std::shared_ptr<EngineHandler> engineHandler) :
-        mSpeakRequestQueueDisplay1("QUEUE_SPEAK_1"), mSpeakRequestQueueDisplay2(
-                "QUEUE_SPEAK_2"), mControlRequestQueueDisplay1(
-                "QUEUE_CONTROL_1"), mControlRequestQueueDisplay2(
-                "QUEUE_CONTROL_2"), mEngineHandler(engineHandler) {
+        mEngineHandler(engineHandler) {
+    size_t ingressCapacity = DEFAULT_INGRESS_CAPACITY;
+    pbnjson::JValue capacity;
+    if (mEngineHandler->getConfigValue("queue", "ingressCapacity", capacity)
+            && capacity.isNumber() && capacity.asNumber<int>() > 0)
+        ingressCapacity = capacity.asNumber<int>();
+
+    for (unsigned int displayId = 0;
+            displayId < mEngineHandler->getDisplayCount(); displayId++)
+        mPipelines.emplace_back(new DisplayPipeline(displayId, ingressCapacity));
+
+    pbnjson::JValue coalesceApps;
+    if (mEngineHandler->getConfigValue("queue", "coalesceApps", coalesceApps)
+            && coalesceApps.isArray()) {
+        for (ssize_t i = 0; i < coalesceApps.arraySize(); i++)
+            mCoalesceApps.insert(coalesceApps[i].asString());
+    }
 }
 
 bool RequestHandler::sendRequest(TTSRequest *request, unsigned int displayId) {
@@ -29,42 +52,40 @@ bool RequestHandler::sendRequest(TTSRequest *request, unsigned int displayId) {
     LOG_INFO(MSGID_REQUEST_HANDLER, 0, "%s disp: %d request: %d", __FUNCTION__,
             (int )displayId, request->getType());
 
+    DisplayPipeline *pipeline = getPipeline(displayId);
+
     switch (request->getType()) {
         case SPEAK: {
+            if (!pipeline) {
+                delete request;
+                return false;
+            }
             SpeakRequest *ptrSpeakRequest =
                     reinterpret_cast<SpeakRequest*>(request->getRequest());
-            if (ptrSpeakRequest->msgParameters->bClear) {
-                SpeakRequestInfo info;
-                bool speakRequestFound = mEngineHandler->getSpeakRequestInfo(
-                        displayId, info);
-                if (speakRequestFound) {
-                    LOG_INFO(MSGID_REQUEST_HANDLER, 0,
-                            "%s speak request found app: %s, msg: %s",
-                            __FUNCTION__, info.appId.c_str(),
-                            info.msgId.c_str());
-                    if (info.msgStatus == MsgStatus::TTS_MSG_PLAY) {
-                        LOG_INFO(MSGID_REQUEST_HANDLER, 0,
-                                "%s stop speak request", __FUNCTION__);
-                        stopSpeech(displayId); // send stop clear message
-                        mEngineHandler->updateSpeakRequestInfo(displayId,
-                                TTS_MSG_STOP);
-                        LOG_INFO(MSGID_REQUEST_HANDLER, 0,
-                                "%s disp: %d Previous speak request is stopped",
-                                __FUNCTION__, (int )displayId);
-                    }
+            if (mCoalesceApps.count(ptrSpeakRequest->msgParameters->sAppID))
+                ptrSpeakRequest->msgParameters->bCoalesce = true;
+            // Urgent prompts play over the current speech instead of
+            // waiting for it, and never clear it
+            if (ptrSpeakRequest->msgParameters->bUrgent) {
+                if (!pipeline->alertQueue.addRequest(request)) {
+                    delete request;
+                    return false;
                 }
-                if (displayId)
-                    mSpeakRequestQueueDisplay2.clearQueue();
-                else
-                    mSpeakRequestQueueDisplay1.clearQueue();
+                break;
+            }
+            if (ptrSpeakRequest->msgParameters->bClear)
+                clearSpeech(displayId);
+            if (!pipeline->speakQueue.addRequest(request)) {
+                delete request;
+                return false;
             }
-            if (displayId)
-                mSpeakRequestQueueDisplay2.addRequest(request);
-            else
-                mSpeakRequestQueueDisplay1.addRequest(request);
             break;
         }
         case STOP: {
+            if (!pipeline) {
+                delete request;
+                return false;
+            }
             StopRequest *ptrStopRequest =
                     reinterpret_cast<StopRequest*>(request->getRequest());
             std::string stopAppID = ptrStopRequest->sAppID;
@@ -72,26 +93,28 @@ bool RequestHandler::sendRequest(TTSRequest *request, unsigned int displayId) {
             bool queueRet = false;
             bool runningRet = false;
 
+            // Speech and a playing urgent prompt are matched separately
             SpeakRequestInfo info;
-            if (mEngineHandler->getSpeakRequestInfo(displayId, info)
-                    && CheckToStopRunningSpeak(info, request)) {
+            ptrStopRequest->stopSpeech =
+                    mEngineHandler->getSpeakRequestInfo(displayId, info)
+                    && CheckToStopRunningSpeak(info, request);
+            ptrStopRequest->stopAlert =
+                    mEngineHandler->getSpeakRequestInfo(displayId, info, VOICE_ALERT)
+                    && CheckToStopRunningSpeak(info, request);
+            if (ptrStopRequest->stopSpeech || ptrStopRequest->stopAlert) {
                 LOG_INFO(MSGID_REQUEST_HANDLER, 0,
-                        "%s disp: %d SpeakRequestInfo found", __FUNCTION__,
-                        (int )displayId);
-                if (displayId)
-                    mControlRequestQueueDisplay2.addRequest(request);
-                else
-                    mControlRequestQueueDisplay1.addRequest(request);
-                runningRet = true;
+                        "%s disp: %d SpeakRequestInfo found speech: %d alert: %d",
+                        __FUNCTION__, (int )displayId, ptrStopRequest->stopSpeech,
+                        ptrStopRequest->stopAlert);
+                runningRet = pipeline->controlQueue.addRequest(request);
+                if (!runningRet)
+                    delete request;
             } else {
                 delete request;
             }
-            if (displayId)
-                queueRet = mSpeakRequestQueueDisplay2.removeRequest(std::move(stopAppID),
-                        std::move(stopMsgID));
-            else
-                queueRet = mSpeakRequestQueueDisplay1.removeRequest(std::move(stopAppID),
-                        std::move(stopMsgID));
+            queueRet = pipeline->alertQueue.removeRequest(stopAppID, stopMsgID);
+            queueRet = pipeline->speakQueue.removeRequest(std::move(stopAppID),
+                    std::move(stopMsgID)) || queueRet;
 
             return (runningRet) ? runningRet : queueRet;
         }
@@ -100,6 +123,12 @@ bool RequestHandler::sendRequest(TTSRequest *request, unsigned int displayId) {
             mEngineHandler->getLanguages(request, displayId);
             break;
         }
+        case PAUSE:
+        case RESUME: {
+            // Only corks or uncorks the stream, so it runs in place
+            LOG_DEBUG("Request Type: %s", request->getType() == PAUSE ? "PAUSE" : "RESUME");
+            return mEngineHandler->handleRequest(request, displayId);
+        }
         case GET_STATUS: {
             LOG_DEBUG("Request Type: GET_STATUS");
             mEngineHandler->getStatusInfo(request, displayId);
@@ -114,22 +143,85 @@ bool RequestHandler::sendRequest(TTSRequest *request, unsigned int displayId) {
     return true;
 }
 
+size_t RequestHandler::getQueueDepth(unsigned int displayId) {
+    DisplayPipeline *pipeline = getPipeline(displayId);
+    if (!pipeline)
+        return 0;
+    return pipeline->speakQueue.pendingCount()
+            + pipeline->alertQueue.pendingCount();
+}
+
+bool RequestHandler::sendBatch(std::vector<TTSRequest*>& requests,
+        unsigned int displayId) {
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    LOG_INFO(MSGID_REQUEST_HANDLER, 0, "%s disp: %d requests: %d", __FUNCTION__,
+            (int )displayId, (int )requests.size());
+
+    DisplayPipeline *pipeline = getPipeline(displayId);
+    if (!pipeline || requests.empty()) {
+        for (TTSRequest *request : requests)
+            delete request;
+        requests.clear();
+        return false;
+    }
+
+    // Options that pick the queue are shared by the whole batch
+    Parameters *first = reinterpret_cast<SpeakRequest*>(
+            requests.front()->getRequest())->msgParameters;
+    std::vector<Request*> queued;
+    for (TTSRequest *request : requests) {
+        SpeakRequest *ptrSpeakRequest =
+                reinterpret_cast<SpeakRequest*>(request->getRequest());
+        if (mCoalesceApps.count(ptrSpeakRequest->msgParameters->sAppID))
+            ptrSpeakRequest->msgParameters->bCoalesce = true;
+        queued.push_back(request);
+    }
+    requests.clear();
+
+    if (first->bUrgent) {
+        pipeline->alertQueue.addRequests(queued);
+        return true;
+    }
+    if (first->bClear)
+        clearSpeech(displayId);
+    pipeline->speakQueue.addRequests(queued);
+    return true;
+}
+
 void RequestHandler::start() {
     LOG_TRACE("Entering function %s", __FUNCTION__);
 
-    mControlRequestQueueDisplay1.start();
-    mSpeakRequestQueueDisplay1.start();
-    mControlRequestQueueDisplay2.start();
-    mSpeakRequestQueueDisplay2.start();
+    bool reactor = mEngineHandler->isReactorMode();
+    for (auto &pipeline : mPipelines) {
+        if (reactor) {
+            pipeline->controlQueue.attachToMainLoop();
+            pipeline->alertQueue.attachToMainLoop();
+            pipeline->speakQueue.attachToMainLoop();
+        } else {
+            pipeline->controlQueue.start();
+            pipeline->alertQueue.start();
+            pipeline->speakQueue.start();
+        }
+    }
 }
 
 void RequestHandler::stop() {
     LOG_TRACE("Entering function %s", __FUNCTION__);
 
-    mSpeakRequestQueueDisplay1.stop();
-    mControlRequestQueueDisplay1.stop();
-    mSpeakRequestQueueDisplay2.stop();
-    mControlRequestQueueDisplay2.stop();
+    for (auto &pipeline : mPipelines) {
+        pipeline->speakQueue.stop();
+        pipeline->alertQueue.stop();
+        pipeline->controlQueue.stop();
+    }
+}
+
+RequestHandler::DisplayPipeline* RequestHandler::getPipeline(unsigned int displayId) {
+    if (displayId >= mPipelines.size()) {
+        LOG_INFO(MSGID_REQUEST_HANDLER, 0, "%s no pipeline for disp: %d",
+                __FUNCTION__, (int )displayId);
+        return nullptr;
+    }
+    return mPipelines[displayId].get();
 }
 
 bool RequestHandler::CheckToStopRunningSpeak(SpeakRequestInfo& runningRequest,
@@ -156,9 +248,38 @@ bool RequestHandler::CheckToStopRunningSpeak(SpeakRequestInfo& runningRequest,
     return bret;
 }
 
+// Stops what is playing on the display and drops everything queued
+void RequestHandler::clearSpeech(unsigned int displayId) {
+    DisplayPipeline *pipeline = getPipeline(displayId);
+    if (pipeline == nullptr)
+        return;
+    SpeakRequestInfo info;
+    bool speakRequestFound = mEngineHandler->getSpeakRequestInfo(displayId,
+            info);
+    if (speakRequestFound) {
+        LOG_INFO(MSGID_REQUEST_HANDLER, 0,
+                "%s speak request found app: %s, msg: %s", __FUNCTION__,
+                info.appId.c_str(), info.msgId.c_str());
+        if (info.msgStatus == MsgStatus::TTS_MSG_PLAY) {
+            LOG_INFO(MSGID_REQUEST_HANDLER, 0, "%s stop speak request",
+                    __FUNCTION__);
+            stopSpeech(displayId); // send stop clear message
+            mEngineHandler->updateSpeakRequestInfo(displayId, TTS_MSG_STOP);
+            LOG_INFO(MSGID_REQUEST_HANDLER, 0,
+                    "%s disp: %d Previous speak request is stopped",
+                    __FUNCTION__, (int )displayId);
+        }
+    }
+    pipeline->speakQueue.clearQueue();
+}
+
 void RequestHandler::stopSpeech(unsigned int displayId) {
     LOG_INFO(MSGID_REQUEST_HANDLER, 0, "%s disp: %d", __FUNCTION__,
             (int )displayId);
+    DisplayPipeline *pipeline = getPipeline(displayId);
+    if (pipeline == nullptr) {
+        return;
+    }
     StopRequest *stopRequest = new (std::nothrow) StopRequest;
     if (stopRequest == nullptr) {
         return;
@@ -170,8 +291,6 @@ void RequestHandler::stopSpeech(unsigned int displayId) {
         delete stopRequest;
         return;
     }
-    if (displayId)
-        mControlRequestQueueDisplay2.addRequest(request);
-    else
-        mControlRequestQueueDisplay1.addRequest(request);
+    if (!pipeline->controlQueue.addRequest(request))
+        delete request;
 }
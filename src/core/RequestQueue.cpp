@@ -16,86 +16,394 @@
 
 #include <functional>
 #include <future>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <glib-unix.h>
 #include <RequestQueue.h>
 #include <TTSLog.h>
 #include <TTSRequest.h>
 #include <StatusHandler.h>
+#include <ThreadPolicy.h>
 
-RequestQueue::RequestQueue()
+#define EXPIRY_WHEEL_TICK_MS    100
+#define EXPIRY_WHEEL_SLOTS      64
+
+static bool isExpired(Request* request, TimerWheel<Request*>::Clock::time_point now)
 {
-    mQuit = true;
+    if (request->getType() != SPEAK)
+        return false;
+    SpeakRequest* ptrSpeakRequest = reinterpret_cast<SpeakRequest*>(request->getRequest());
+    return ptrSpeakRequest->msgParameters->bExpires
+            && ptrSpeakRequest->msgParameters->tExpiry <= now;
+}
+
+// Requests sharing a key are interchangeable while waiting: same app and
+// either the same caller supplied coalesceKey or the same text and language
+static std::string coalesceKey(Request* request)
+{
+    if (request->getType() != SPEAK)
+        return std::string();
+    SpeakRequest* ptrSpeakRequest = reinterpret_cast<SpeakRequest*>(request->getRequest());
+    Parameters* params = ptrSpeakRequest->msgParameters;
+    if (!params->bCoalesce)
+        return std::string();
+    if (!params->sCoalesceKey.empty())
+        return params->sAppID + "\x1f" + "key\x1f" + params->sCoalesceKey;
+    return params->sAppID + "\x1f" + "text\x1f" + params->sLangStr + "\x1f" + params->sText;
 }
-RequestQueue::RequestQueue(std::string name)
+
+RequestQueue::RequestQueue() :
+        RequestQueue(std::string())
+{
+}
+
+RequestQueue::RequestQueue(std::string name, size_t ingressCapacity) :
+        mIngress(ingressCapacity),
+        mExpiryWheel(std::chrono::milliseconds(EXPIRY_WHEEL_TICK_MS), EXPIRY_WHEEL_SLOTS)
 {
     mQuit = true;
     mName = std::move(name);
+    mEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (mEventFd < 0) {
+        LOG_ERROR(MSGID_REQUEST_QUEUE, 0,
+                "%s Name: %s eventfd failed: %s, polling every %d ms instead",
+                __FUNCTION__, mName.c_str(), strerror(errno), EXPIRY_WHEEL_TICK_MS);
+    }
 }
 
 RequestQueue::~RequestQueue()
 {
-    mQuit = true;
-    mCondVar.notify_all();
-    if (mDispatcherThread.joinable()) {
-        mDispatcherThread.join();
+    stop();
+    if (mEventFd >= 0) {
+        close(mEventFd);
     }
 }
 
-void RequestQueue::addRequest(Request* request)
+bool RequestQueue::addRequest(Request* request)
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
 
     LOG_DEBUG("%s New request added to queue :%d\n", mName.c_str(),
             request->getType());
+    // Never blocks: a full ring is reported back to the caller
+    mPending.fetch_add(1, std::memory_order_relaxed);
+    if (!mIngress.push(request)) {
+        mPending.fetch_sub(1, std::memory_order_relaxed);
+        LOG_WARNING(MSGID_REQUEST_QUEUE, 0,
+                "%s Name: %s ingress ring full (%d), request rejected",
+                __FUNCTION__, mName.c_str(), (int )mIngress.capacity());
+        return false;
+    }
+    wakeDispatcher();
+    return true;
+}
+
+void RequestQueue::addRequests(const std::vector<Request*>& requests)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+
+    // Bypasses the bounded ring, the caller limits the batch size
+    std::vector<Request*> replaced;
+    mPending.fetch_add(requests.size(), std::memory_order_relaxed);
     {
         std::lock_guard < std::mutex > lock(mMutex);
-        mRequestQueue.push_back(request);
+        drainIngress(replaced);
+        for (Request *request : requests)
+            enqueueRequest(request, replaced);
+    }
+    notifyAndDelete(replaced, TTS_MSG_CANCEL);
+    wakeDispatcher();
+}
+
+void RequestQueue::wakeDispatcher()
+{
+    if (mEventFd >= 0 && eventfd_write(mEventFd, 1) < 0) {
+        LOG_WARNING(MSGID_REQUEST_QUEUE, 0, "%s Name: %s eventfd write failed: %s",
+                __FUNCTION__, mName.c_str(), strerror(errno));
+    }
+}
+
+void RequestQueue::waitForRequest(int timeoutMs)
+{
+    // Without an eventfd nothing wakes the dispatcher, so it sleeps at
+    // most one tick before looking at the ring and mQuit again
+    if (mEventFd < 0) {
+        if (timeoutMs < 0 || timeoutMs > EXPIRY_WHEEL_TICK_MS)
+            timeoutMs = EXPIRY_WHEEL_TICK_MS;
+        (void) poll(nullptr, 0, timeoutMs);
+        return;
+    }
+    struct pollfd pfd = { mEventFd, POLLIN, 0 };
+    if (poll(&pfd, 1, timeoutMs) > 0) {
+        eventfd_t count = 0;
+        (void) eventfd_read(mEventFd, &count);
+    }
+}
+
+void RequestQueue::drainIngress(std::vector<Request*>& replaced)
+{
+    Request *request = nullptr;
+    while (mIngress.pop(request)) {
+        enqueueRequest(request, replaced);
+    }
+}
+
+void RequestQueue::enqueueRequest(Request* request, std::vector<Request*>& replaced)
+{
+    std::string key = coalesceKey(request);
+    auto found = key.empty() ? mCoalesceIndex.end() : mCoalesceIndex.find(key);
+    if (found != mCoalesceIndex.end()) {
+        // Take over the queued request's slot so it keeps its place in line
+        Request *previous = *found->second;
+        *found->second = request;
+        mExpiryWheel.cancel(previous);
+        replaced.push_back(previous);
+        mPending.fetch_sub(1, std::memory_order_relaxed);
         LOG_INFO(MSGID_REQUEST_QUEUE, 0,
-                "%s Name: %s new request added, queue size: %d", __FUNCTION__,
-                mName.c_str(), (int )mRequestQueue.size());
+                "%s Name: %s coalesced with a queued request", __FUNCTION__,
+                mName.c_str());
+    } else {
+        auto it = mRequestQueue.insert(mRequestQueue.end(), request);
+        if (!key.empty())
+            mCoalesceIndex[key] = it;
     }
-    mCondVar.notify_one();
+    if (request->getType() == SPEAK) {
+        SpeakRequest *ptrSpeakRequest =
+                reinterpret_cast<SpeakRequest*>(request->getRequest());
+        if (ptrSpeakRequest->msgParameters->bExpires)
+            mExpiryWheel.schedule(request,
+                    ptrSpeakRequest->msgParameters->tExpiry);
+    }
+    LOG_INFO(MSGID_REQUEST_QUEUE, 0,
+            "%s Name: %s new request added, queue size: %d", __FUNCTION__,
+            mName.c_str(), (int )mRequestQueue.size());
+}
+
+Request* RequestQueue::takeNextRequest(bool pop,
+        std::vector<Request*>& replaced, std::vector<Request*>& expired,
+        int& timeoutMs)
+{
+    Request *op = nullptr;
+
+    drainIngress(replaced);
+    takeExpiredRequests(expired);
+    if (pop && mRequestQueue.size()) {
+        op = mRequestQueue.front();
+        mRequestQueue.pop_front();
+        mPending.fetch_sub(1, std::memory_order_relaxed);
+        mExpiryWheel.cancel(op);
+        unindexRequest(op);
+        if (op->getType() == SPEAK) {
+            SpeakRequest *ptrSpeakRequest =
+                    reinterpret_cast<SpeakRequest*>(op->getRequest());
+            ptrSpeakRequest->msgParameters->bHasNext = !mRequestQueue.empty();
+        }
+    } else if (mRequestQueue.empty()) {
+        LOG_INFO(MSGID_REQUEST_QUEUE, 0,
+                "%s Name: %s Waiting for request.. queue size: %d",
+                __FUNCTION__, mName.c_str(), (int )mRequestQueue.size());
+    }
+
+    timeoutMs = -1;
+    if (!mExpiryWheel.empty()) {
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+                mExpiryWheel.nextTick() - TimerWheel<Request*>::Clock::now());
+        timeoutMs = (wait.count() > 0) ? (int) wait.count() + 1 : 0;
+    }
+    return op;
+}
+
+bool RequestQueue::dropIfExpired(Request* request)
+{
+    // The wheel has tick granularity, catch anything that expired since
+    if (!isExpired(request, TimerWheel<Request*>::Clock::now()))
+        return false;
+    LOG_INFO(MSGID_REQUEST_QUEUE, 0, "%s Name: %s dropping expired request",
+            __FUNCTION__, mName.c_str());
+    setRequestStatus(request, TTS_MSG_EXPIRED);
+    delete request;
+    return true;
 }
 
 void RequestQueue::dispatchHandler()
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
 
+    // Inherited by the threads each request executes on
+    ThreadPolicy::get().apply(THREAD_SYNTHESIS);
+
     std::unique_lock < std::mutex > lock(mMutex, std::defer_lock);
-    lock.lock();
 
-    do {
-        LOG_INFO(MSGID_REQUEST_QUEUE, 0,
-                "%s Name: %s Waiting for request.. queue size: %d",
-                __FUNCTION__, mName.c_str(), (int )mRequestQueue.size());
-        mCondVar.wait(lock, [this] {
-            return (mRequestQueue.size() || mQuit);
-        });
+    while (!mQuit) {
+        std::vector<Request*> replaced;
+        std::vector<Request*> expired;
+        int timeoutMs = -1;
+
+        lock.lock();
+        Request *op = takeNextRequest(true, replaced, expired, timeoutMs);
+        lock.unlock();
+
+        // Status notifications go out without holding the queue lock
+        notifyAndDelete(replaced, TTS_MSG_CANCEL);
+        notifyAndDelete(expired, TTS_MSG_EXPIRED);
 
-        if (mRequestQueue.size() && !mQuit) {
-            Request *op = mRequestQueue.front();
-            LOG_INFO(MSGID_REQUEST_QUEUE, 0,
-                    "%s Name: %s, processing %d request", __FUNCTION__,
-                    mName.c_str(), op->getType());
-            mRequestQueue.erase(mRequestQueue.begin());
-            lock.unlock();
-
-            std::future<bool> fut = std::async(std::launch::async, [&op]() {
-                return op->execute();
-            });
-            bool ret = fut.get();
-            LOG_INFO(MSGID_REQUEST_QUEUE, 0,
-                    "%s queue: %s Executed Request status :%d  queuesize: %d\n",
-                    __FUNCTION__, mName.c_str(), ret,
-                    (int )mRequestQueue.size());
+        if (op == nullptr) {
+            waitForRequest(timeoutMs);
+            continue;
+        }
+        if (mQuit) {
             delete op;
-            lock.lock();
+            break;
         }
-    } while (!mQuit);
+
+        LOG_INFO(MSGID_REQUEST_QUEUE, 0,
+                "%s Name: %s, processing %d request", __FUNCTION__,
+                mName.c_str(), op->getType());
+
+        if (dropIfExpired(op))
+            continue;
+
+        std::future<bool> fut = std::async(std::launch::async, [&op]() {
+            return op->execute();
+        });
+        bool ret = fut.get();
+        LOG_INFO(MSGID_REQUEST_QUEUE, 0,
+                "%s queue: %s Executed Request status :%d\n",
+                __FUNCTION__, mName.c_str(), ret);
+        delete op;
+    }
 
     LOG_INFO(MSGID_REQUEST_QUEUE, 0, "%s dispatcher thread %s exiting..",
             __FUNCTION__, mName.c_str());
 }
 
+void RequestQueue::reactorDispatch()
+{
+    Request *op = nullptr;
+
+    do {
+        std::vector<Request*> replaced;
+        std::vector<Request*> expired;
+        int timeoutMs = -1;
+        {
+            std::lock_guard < std::mutex > lock(mMutex);
+            // Keep draining while busy so coalescing and expiry stay current
+            op = takeNextRequest(!mBusy, replaced, expired, timeoutMs);
+        }
+        notifyAndDelete(replaced, TTS_MSG_CANCEL);
+        notifyAndDelete(expired, TTS_MSG_EXPIRED);
+        armReactorTimer(timeoutMs);
+    } while (op && dropIfExpired(op));
+
+    if (op == nullptr)
+        return;
+
+    LOG_INFO(MSGID_REQUEST_QUEUE, 0, "%s Name: %s, processing %d request",
+            __FUNCTION__, mName.c_str(), op->getType());
+    mBusy = true;
+    op->executeAsync([this, op](bool ret) {
+        LOG_INFO(MSGID_REQUEST_QUEUE, 0,
+                "%s queue: %s Executed Request status :%d\n",
+                __FUNCTION__, mName.c_str(), ret);
+        delete op;
+        mBusy = false;
+        scheduleReactorDispatch();
+    });
+}
+
+void RequestQueue::armReactorTimer(int timeoutMs)
+{
+    if (mTimerSource) {
+        g_source_remove(mTimerSource);
+        mTimerSource = 0;
+    }
+    if (timeoutMs >= 0)
+        mTimerSource = g_timeout_add(timeoutMs, onReactorTimer, this);
+}
+
+void RequestQueue::scheduleReactorDispatch()
+{
+    // Deferred so a request completing in place never recurses
+    if (!mIdleSource && !mQuit)
+        mIdleSource = g_idle_add(onReactorIdle, this);
+}
+
+gboolean RequestQueue::onIngressReady(gint fd, GIOCondition condition, gpointer data)
+{
+    RequestQueue *queue = static_cast<RequestQueue*>(data);
+    eventfd_t count = 0;
+    (void) eventfd_read(fd, &count);
+    queue->reactorDispatch();
+    return G_SOURCE_CONTINUE;
+}
+
+gboolean RequestQueue::onReactorPoll(gpointer data)
+{
+    static_cast<RequestQueue*>(data)->reactorDispatch();
+    return G_SOURCE_CONTINUE;
+}
+
+gboolean RequestQueue::onReactorTimer(gpointer data)
+{
+    RequestQueue *queue = static_cast<RequestQueue*>(data);
+    queue->mTimerSource = 0;
+    queue->reactorDispatch();
+    return G_SOURCE_REMOVE;
+}
+
+gboolean RequestQueue::onReactorIdle(gpointer data)
+{
+    RequestQueue *queue = static_cast<RequestQueue*>(data);
+    queue->mIdleSource = 0;
+    queue->reactorDispatch();
+    return G_SOURCE_REMOVE;
+}
+
+void RequestQueue::takeExpiredRequests(std::vector<Request*>& expired)
+{
+    if (mExpiryWheel.empty())
+        return;
+
+    size_t first = expired.size();
+    mExpiryWheel.advance(TimerWheel<Request*>::Clock::now(), expired);
+    if (expired.size() == first)
+        return;
+
+    for (size_t i = first; i < expired.size(); i++) {
+        unindexRequest(expired[i]);
+        mRequestQueue.remove(expired[i]);
+    }
+    mPending.fetch_sub(expired.size() - first, std::memory_order_relaxed);
+    LOG_INFO(MSGID_REQUEST_QUEUE, 0,
+            "%s Name: %s dropped %d expired request(s), queue size: %d",
+            __FUNCTION__, mName.c_str(), (int )(expired.size() - first),
+            (int )mRequestQueue.size());
+}
+
+void RequestQueue::unindexRequest(Request* request)
+{
+    std::string key = coalesceKey(request);
+    if (key.empty())
+        return;
+    auto found = mCoalesceIndex.find(key);
+    if (found != mCoalesceIndex.end() && *found->second == request)
+        mCoalesceIndex.erase(found);
+}
+
+void RequestQueue::notifyAndDelete(std::vector<Request*>& requests, MsgStatus_t status)
+{
+    for (Request *ttsRequest : requests) {
+        setRequestStatus(ttsRequest, status);
+        LOG_INFO(MSGID_REQUEST_QUEUE, 0, "%s Name: %s deleting tts request ",
+                __FUNCTION__, mName.c_str());
+        delete ttsRequest;
+    }
+    requests.clear();
+}
+
 void RequestQueue::start()
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
@@ -108,15 +416,39 @@ void RequestQueue::start()
     }
 }
 
+void RequestQueue::attachToMainLoop()
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+
+    LOG_DEBUG("%s Attaching to main loop\n", mName.c_str());
+
+    if (mQuit) {
+        mQuit = false;
+        mReactor = true;
+        if (mEventFd >= 0)
+            mFdSource = g_unix_fd_add(mEventFd, G_IO_IN, onIngressReady, this);
+        else
+            mFdSource = g_timeout_add(EXPIRY_WHEEL_TICK_MS, onReactorPoll, this);
+    }
+}
+
 void RequestQueue::stop()
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
 
     LOG_DEBUG("%s Stopping  dispatcher thread\n", mName.c_str());
 
-    if (!mQuit) {
+    if (!mQuit && mReactor) {
+        mQuit = true;
+        mReactor = false;
+        for (guint *source : { &mFdSource, &mTimerSource, &mIdleSource }) {
+            if (*source)
+                g_source_remove(*source);
+            *source = 0;
+        }
+    } else if (!mQuit) {
         mQuit = true;
-        mCondVar.notify_all();
+        wakeDispatcher();
         if (mDispatcherThread.joinable()) {
             mDispatcherThread.join();
         }
@@ -136,67 +468,75 @@ bool RequestQueue::removeRequest(std::string sAppID, std::string sMsgID)
     }
 
     result = false;
-    std::lock_guard < std::mutex > lock(mMutex);
-    std::vector<Request*>::iterator it = mRequestQueue.begin();
+    std::vector<Request*> replaced;
+    std::vector<Request*> removed;
+    {
+        std::lock_guard < std::mutex > lock(mMutex);
+        // Requests still in the ingress ring must be visible to stop as well
+        drainIngress(replaced);
+        std::list<Request*>::iterator it = mRequestQueue.begin();
 
-    while (it != mRequestQueue.end()) {
-        Request *ttsRequest = *it;
-        SpeakRequest *ptrSpeakRequest =
-                reinterpret_cast<SpeakRequest*>(ttsRequest->getRequest());
+        while (it != mRequestQueue.end()) {
+            Request *ttsRequest = *it;
+            SpeakRequest *ptrSpeakRequest =
+                    reinterpret_cast<SpeakRequest*>(ttsRequest->getRequest());
 
-        std::string QueueAppID = ptrSpeakRequest->msgParameters->sAppID;
-        std::string QueueMsgID = ptrSpeakRequest->msgParameters->sMsgID;
+            const std::string &QueueAppID = ptrSpeakRequest->msgParameters->sAppID;
+            const std::string &QueueMsgID = ptrSpeakRequest->msgParameters->sMsgID;
 
-        if (!sMsgID.empty() && (QueueMsgID.compare(sMsgID) == 0)) {
-            {
-                setRequestStatus(ttsRequest);
+            if (!sMsgID.empty() && (QueueMsgID.compare(sMsgID) == 0)) {
+                mExpiryWheel.cancel(ttsRequest);
+                unindexRequest(ttsRequest);
                 it = mRequestQueue.erase(it);
-                LOG_INFO(MSGID_REQUEST_QUEUE, 0,
-                        "%s Name: %s deleting tts request ", __FUNCTION__,
-                        mName.c_str());
-                delete ttsRequest;
+                removed.push_back(ttsRequest);
                 result = true;
-            }
-            break; //msgID is unique
-        } else if (QueueAppID.compare(sAppID) == 0) {
-            {
-                setRequestStatus(ttsRequest);
+                break; //msgID is unique
+            } else if (QueueAppID.compare(sAppID) == 0) {
+                mExpiryWheel.cancel(ttsRequest);
+                unindexRequest(ttsRequest);
                 it = mRequestQueue.erase(it);
-                LOG_INFO(MSGID_REQUEST_QUEUE, 0,
-                        "%s Name: %s deleting tts request ", __FUNCTION__,
-                        mName.c_str());
-                delete ttsRequest;
+                removed.push_back(ttsRequest);
                 result = true;
+            } else {
+                ++it;
             }
-        } else {
-            ++it;
         }
+        mPending.fetch_sub(removed.size(), std::memory_order_relaxed);
     }
+    notifyAndDelete(replaced, TTS_MSG_CANCEL);
+    notifyAndDelete(removed, TTS_MSG_CANCEL);
     return result;
 }
 
+size_t RequestQueue::pendingCount() const
+{
+    return mPending.load(std::memory_order_relaxed);
+}
+
 void RequestQueue::clearQueue()
 {
     LOG_INFO(MSGID_REQUEST_QUEUE, 0, "%s Name: %s", __FUNCTION__,
             mName.c_str());
 
-    std::lock_guard < std::mutex > lock(mMutex);
-    std::vector<Request*>::iterator it = mRequestQueue.begin();
-    while (it != mRequestQueue.end()) {
-        Request *ttsRequest = *it;
-        setRequestStatus(ttsRequest);
-        it = mRequestQueue.erase(it);
-        LOG_INFO(MSGID_REQUEST_QUEUE, 0, "%s Name: %s deleting tts request ",
-                __FUNCTION__, mName.c_str());
-        delete ttsRequest;
-        ttsRequest = nullptr;
+    std::vector<Request*> removed;
+    {
+        std::lock_guard < std::mutex > lock(mMutex);
+        drainIngress(removed);
+        // Coalesced requests were already uncounted by the drain
+        mPending.fetch_sub(mRequestQueue.size(), std::memory_order_relaxed);
+        removed.insert(removed.end(), mRequestQueue.begin(), mRequestQueue.end());
+        for (Request *ttsRequest : mRequestQueue)
+            mExpiryWheel.cancel(ttsRequest);
+        mRequestQueue.clear();
+        mCoalesceIndex.clear();
     }
+    notifyAndDelete(removed, TTS_MSG_CANCEL);
 }
 
-void RequestQueue::setRequestStatus(Request* pRequest)
+void RequestQueue::setRequestStatus(Request* pRequest, MsgStatus_t status)
 {
     SpeakRequest* ptrSpeakRequest = reinterpret_cast<SpeakRequest*>(pRequest->getRequest());
-    ptrSpeakRequest->msgParameters->eStatus = TTS_MSG_CANCEL;
+    ptrSpeakRequest->msgParameters->eStatus = status;
     LOG_INFO(MSGID_REQUEST_QUEUE, 0, "%s queue: %s Notify request status ", __FUNCTION__, mName.c_str());
     StatusHandler::GetInstance()->Notify(ptrSpeakRequest->msgParameters, ptrSpeakRequest->message);
 }
@@ -19,12 +19,15 @@
 
 #include "TTSLog.h"
 #include "TTSManager.h"
+#include "ThreadPolicy.h"
 
 bool TTSManager::init(GMainLoop *_mainLoop) {
     LOG_TRACE("Entering function %s", __FUNCTION__);
 
     bool initialized = true;
     mainLoop = _mainLoop;
+    // Threads started from here inherit this unless their role sets its own
+    ThreadPolicy::get().apply(THREAD_LUNA);
 
     try {
         mLunaService.init();
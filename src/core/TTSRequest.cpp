@@ -48,6 +48,10 @@ TTSRequest::~TTSRequest()
                 reinterpret_cast<GetLanguageRequest*>(mReqType);
         ptrGetLanguageRequest->vecLanguages.clear();
         delete ptrGetLanguageRequest;
+    } else if (mReqType->requestType == PAUSE
+            || mReqType->requestType == RESUME) {
+        PauseRequest *ptrPauseRequest = reinterpret_cast<PauseRequest*>(mReqType);
+        delete ptrPauseRequest;
     } else if (mReqType->requestType == GET_STATUS) {
         LOG_DEBUG("For Stop Memory Leak handled Properly");
     } else {
@@ -58,10 +62,8 @@ TTSRequest::~TTSRequest()
     }
 }
 
-bool TTSRequest::execute()
+unsigned int TTSRequest::getDisplayId()
 {
-    LOG_TRACE("Entering function %s", __FUNCTION__);
-
     unsigned int displayId = 0;
     auto requestType = mReqType->requestType;
     if (SPEAK == requestType) {
@@ -71,7 +73,19 @@ bool TTSRequest::execute()
     } else if (STOP == requestType) {
         StopRequest *ptrStopRequest = reinterpret_cast<StopRequest*>(mReqType);
         displayId = ptrStopRequest->displayId;
+    } else if (PAUSE == requestType || RESUME == requestType) {
+        PauseRequest *ptrPauseRequest = reinterpret_cast<PauseRequest*>(mReqType);
+        displayId = ptrPauseRequest->displayId;
     }
+    return displayId;
+}
+
+bool TTSRequest::execute()
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+
+    auto requestType = mReqType->requestType;
+    unsigned int displayId = getDisplayId();
     LOG_INFO(MSGID_TTS_REQUEST, 0, "%s request %d on display: %d", __FUNCTION__,
             requestType, displayId);
     bool exeStatus = mEngineHandler->handleRequest(this, displayId);
@@ -79,6 +93,16 @@ bool TTSRequest::execute()
     return exeStatus;
 }
 
+void TTSRequest::executeAsync(std::function<void(bool)> done)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+
+    unsigned int displayId = getDisplayId();
+    LOG_INFO(MSGID_TTS_REQUEST, 0, "%s request %d on display: %d", __FUNCTION__,
+            mReqType->requestType, displayId);
+    mEngineHandler->handleRequestAsync(this, displayId, std::move(done));
+}
+
 REQUEST_TYPE TTSRequest::getType()
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
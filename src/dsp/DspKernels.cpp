@@ -0,0 +1,113 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cmath>
+#include <DspKernels.h>
+#include <TTSLog.h>
+
+#if defined(__arm__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+static void scalarS16ToFloat(const int16_t* in, float* out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        out[i] = in[i] * (1.0f / 32768.0f);
+}
+
+static void scalarFloatToS16(const float* in, int16_t* out, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        float v = in[i] * 32768.0f;
+        v = (v > 32767.0f) ? 32767.0f : (v < -32768.0f) ? -32768.0f : v;
+        out[i] = (int16_t) std::lrintf(v);
+    }
+}
+
+static void scalarGainRamp(float* buf, size_t count, float gain, float step)
+{
+    for (size_t i = 0; i < count; i++)
+        buf[i] *= gain + i * step;
+}
+
+static void scalarMixAdd(float* dst, const float* src, size_t count, float gain)
+{
+    for (size_t i = 0; i < count; i++)
+        dst[i] += src[i] * gain;
+}
+
+static float scalarDot(const float* a, const float* b, size_t count)
+{
+    float acc = 0.0f;
+    for (size_t i = 0; i < count; i++)
+        acc += a[i] * b[i];
+    return acc;
+}
+
+static int scalarPeakS16(const int16_t* in, size_t count)
+{
+    int peak = 0;
+    for (size_t i = 0; i < count; i++) {
+        int v = in[i] < 0 ? -in[i] : in[i];
+        if (v > peak)
+            peak = v;
+    }
+    return peak;
+}
+
+static const DspKernels scalarKernels = {
+    "scalar",
+    scalarS16ToFloat,
+    scalarFloatToS16,
+    scalarGainRamp,
+    scalarMixAdd,
+    scalarDot,
+    scalarPeakS16,
+};
+
+const DspKernels& getScalarDspKernels()
+{
+    return scalarKernels;
+}
+
+static const DspKernels* selectDspKernels()
+{
+    const DspKernels *kernels = nullptr;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        kernels = getAvx2DspKernels();
+    if (!kernels && __builtin_cpu_supports("sse2"))
+        kernels = getSse2DspKernels();
+#elif defined(__aarch64__)
+    // Advanced SIMD is mandatory on AArch64
+    kernels = getNeonDspKernels();
+#elif defined(__arm__)
+    if (getauxval(AT_HWCAP) & HWCAP_NEON)
+        kernels = getNeonDspKernels();
+#endif
+    if (!kernels)
+        kernels = &scalarKernels;
+    LOG_DEBUG("DSP kernels: %s", kernels->name);
+    return kernels;
+}
+
+const DspKernels& getDspKernels()
+{
+    static const DspKernels *kernels = selectDspKernels();
+    return *kernels;
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <DspKernels.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+// Built only when the compiler targets NEON; 32-bit ARM still checks
+// HWCAP before getDspKernels() hands these out. Tails shorter than a
+// vector use the scalar kernels.
+
+static void neonS16ToFloat(const int16_t* in, float* out, size_t count)
+{
+    const float32x4_t scale = vdupq_n_f32(1.0f / 32768.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t v = vld1q_s16(in + i);
+        int32x4_t lo = vmovl_s16(vget_low_s16(v));
+        int32x4_t hi = vmovl_s16(vget_high_s16(v));
+        vst1q_f32(out + i, vmulq_f32(vcvtq_f32_s32(lo), scale));
+        vst1q_f32(out + i + 4, vmulq_f32(vcvtq_f32_s32(hi), scale));
+    }
+    getScalarDspKernels().s16ToFloat(in + i, out + i, count - i);
+}
+
+static inline int32x4_t neonRound(float32x4_t v)
+{
+#if defined(__aarch64__)
+    return vcvtnq_s32_f32(v);
+#else
+    // ARMv7 only truncates; round half away from zero instead of to even
+    float32x4_t half = vbslq_f32(vcltq_f32(v, vdupq_n_f32(0.0f)),
+            vdupq_n_f32(-0.5f), vdupq_n_f32(0.5f));
+    return vcvtq_s32_f32(vaddq_f32(v, half));
+#endif
+}
+
+static void neonFloatToS16(const float* in, int16_t* out, size_t count)
+{
+    const float32x4_t scale = vdupq_n_f32(32768.0f);
+    const float32x4_t maxv = vdupq_n_f32(32767.0f);
+    const float32x4_t minv = vdupq_n_f32(-32768.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        float32x4_t a = vmulq_f32(vld1q_f32(in + i), scale);
+        float32x4_t b = vmulq_f32(vld1q_f32(in + i + 4), scale);
+        a = vmaxq_f32(vminq_f32(a, maxv), minv);
+        b = vmaxq_f32(vminq_f32(b, maxv), minv);
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(neonRound(a)),
+                vqmovn_s32(neonRound(b))));
+    }
+    getScalarDspKernels().floatToS16(in + i, out + i, count - i);
+}
+
+static void neonGainRamp(float* buf, size_t count, float gain, float step)
+{
+    const float steps[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+    const float32x4_t ramp = vmulq_n_f32(vld1q_f32(steps), step);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t g = vaddq_f32(vdupq_n_f32(gain + i * step), ramp);
+        vst1q_f32(buf + i, vmulq_f32(vld1q_f32(buf + i), g));
+    }
+    getScalarDspKernels().gainRamp(buf + i, count - i, gain + i * step, step);
+}
+
+static void neonMixAdd(float* dst, const float* src, size_t count, float gain)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), gain));
+    getScalarDspKernels().mixAdd(dst + i, src + i, count - i, gain);
+}
+
+static float neonDot(const float* a, const float* b, size_t count)
+{
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+    float lanes[4];
+    vst1q_f32(lanes, acc);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3])
+            + getScalarDspKernels().dot(a + i, b + i, count - i);
+}
+
+static int neonPeakS16(const int16_t* in, size_t count)
+{
+    int16x8_t hi = vdupq_n_s16(0);
+    int16x8_t lo = vdupq_n_s16(0);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t v = vld1q_s16(in + i);
+        hi = vmaxq_s16(hi, v);
+        lo = vminq_s16(lo, v);
+    }
+    int16_t his[8], los[8];
+    vst1q_s16(his, hi);
+    vst1q_s16(los, lo);
+    int peak = getScalarDspKernels().peakS16(in + i, count - i);
+    for (int lane = 0; lane < 8; lane++) {
+        if (his[lane] > peak)
+            peak = his[lane];
+        if (-los[lane] > peak)
+            peak = -los[lane];
+    }
+    return peak;
+}
+
+static const DspKernels neonKernels = {
+    "neon",
+    neonS16ToFloat,
+    neonFloatToS16,
+    neonGainRamp,
+    neonMixAdd,
+    neonDot,
+    neonPeakS16,
+};
+
+const DspKernels* getNeonDspKernels()
+{
+    return &neonKernels;
+}
+
+#else
+
+const DspKernels* getNeonDspKernels()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,256 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <DspKernels.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+// Each variant is built with a target attribute so the rest of the tree
+// keeps the baseline ISA; getDspKernels() only hands them out after
+// checking the CPU. Tails shorter than a vector use the scalar kernels.
+
+#define DSP_SSE2 __attribute__((target("sse2")))
+#define DSP_AVX2 __attribute__((target("avx2")))
+
+DSP_SSE2 static void sse2S16ToFloat(const int16_t* in, float* out, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*) (in + i));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    getScalarDspKernels().s16ToFloat(in + i, out + i, count - i);
+}
+
+DSP_SSE2 static void sse2FloatToS16(const float* in, int16_t* out, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(32768.0f);
+    const __m128 maxv = _mm_set1_ps(32767.0f);
+    const __m128 minv = _mm_set1_ps(-32768.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128 a = _mm_mul_ps(_mm_loadu_ps(in + i), scale);
+        __m128 b = _mm_mul_ps(_mm_loadu_ps(in + i + 4), scale);
+        a = _mm_max_ps(_mm_min_ps(a, maxv), minv);
+        b = _mm_max_ps(_mm_min_ps(b, maxv), minv);
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+        _mm_storeu_si128((__m128i*) (out + i), packed);
+    }
+    getScalarDspKernels().floatToS16(in + i, out + i, count - i);
+}
+
+DSP_SSE2 static void sse2GainRamp(float* buf, size_t count, float gain, float step)
+{
+    const __m128 ramp = _mm_mul_ps(_mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f),
+            _mm_set1_ps(step));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 g = _mm_add_ps(_mm_set1_ps(gain + i * step), ramp);
+        _mm_storeu_ps(buf + i, _mm_mul_ps(_mm_loadu_ps(buf + i), g));
+    }
+    getScalarDspKernels().gainRamp(buf + i, count - i, gain + i * step, step);
+}
+
+DSP_SSE2 static void sse2MixAdd(float* dst, const float* src, size_t count, float gain)
+{
+    const __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 d = _mm_loadu_ps(dst + i);
+        _mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+    }
+    getScalarDspKernels().mixAdd(dst + i, src + i, count - i, gain);
+}
+
+DSP_SSE2 static float sse2Dot(const float* a, const float* b, size_t count)
+{
+    __m128 acc = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3])
+            + getScalarDspKernels().dot(a + i, b + i, count - i);
+}
+
+DSP_SSE2 static int sse2PeakS16(const int16_t* in, size_t count)
+{
+    __m128i hi = _mm_setzero_si128();
+    __m128i lo = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*) (in + i));
+        hi = _mm_max_epi16(hi, v);
+        lo = _mm_min_epi16(lo, v);
+    }
+    int16_t his[8], los[8];
+    _mm_storeu_si128((__m128i*) his, hi);
+    _mm_storeu_si128((__m128i*) los, lo);
+    int peak = getScalarDspKernels().peakS16(in + i, count - i);
+    for (int lane = 0; lane < 8; lane++) {
+        if (his[lane] > peak)
+            peak = his[lane];
+        if (-los[lane] > peak)
+            peak = -los[lane];
+    }
+    return peak;
+}
+
+DSP_AVX2 static void avx2S16ToFloat(const int16_t* in, float* out, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_cvtepi16_epi32(
+                _mm_loadu_si128((const __m128i*) (in + i)));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    getScalarDspKernels().s16ToFloat(in + i, out + i, count - i);
+}
+
+DSP_AVX2 static void avx2FloatToS16(const float* in, int16_t* out, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(32768.0f);
+    const __m256 maxv = _mm256_set1_ps(32767.0f);
+    const __m256 minv = _mm256_set1_ps(-32768.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256 a = _mm256_mul_ps(_mm256_loadu_ps(in + i), scale);
+        __m256 b = _mm256_mul_ps(_mm256_loadu_ps(in + i + 8), scale);
+        a = _mm256_max_ps(_mm256_min_ps(a, maxv), minv);
+        b = _mm256_max_ps(_mm256_min_ps(b, maxv), minv);
+        // packs works per 128-bit lane, so restore sample order afterwards
+        __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a),
+                _mm256_cvtps_epi32(b));
+        packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i*) (out + i), packed);
+    }
+    getScalarDspKernels().floatToS16(in + i, out + i, count - i);
+}
+
+DSP_AVX2 static void avx2GainRamp(float* buf, size_t count, float gain, float step)
+{
+    const __m256 ramp = _mm256_mul_ps(
+            _mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f),
+            _mm256_set1_ps(step));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 g = _mm256_add_ps(_mm256_set1_ps(gain + i * step), ramp);
+        _mm256_storeu_ps(buf + i, _mm256_mul_ps(_mm256_loadu_ps(buf + i), g));
+    }
+    getScalarDspKernels().gainRamp(buf + i, count - i, gain + i * step, step);
+}
+
+DSP_AVX2 static void avx2MixAdd(float* dst, const float* src, size_t count, float gain)
+{
+    const __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 d = _mm256_loadu_ps(dst + i);
+        _mm256_storeu_ps(dst + i,
+                _mm256_add_ps(d, _mm256_mul_ps(_mm256_loadu_ps(src + i), g)));
+    }
+    getScalarDspKernels().mixAdd(dst + i, src + i, count - i, gain);
+}
+
+DSP_AVX2 static float avx2Dot(const float* a, const float* b, size_t count)
+{
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+        acc = _mm256_add_ps(acc,
+                _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc),
+            _mm256_extractf128_ps(acc, 1));
+    float lanes[4];
+    _mm_storeu_ps(lanes, sum);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3])
+            + getScalarDspKernels().dot(a + i, b + i, count - i);
+}
+
+DSP_AVX2 static int avx2PeakS16(const int16_t* in, size_t count)
+{
+    __m256i hi = _mm256_setzero_si256();
+    __m256i lo = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i*) (in + i));
+        hi = _mm256_max_epi16(hi, v);
+        lo = _mm256_min_epi16(lo, v);
+    }
+    int16_t his[16], los[16];
+    _mm256_storeu_si256((__m256i*) his, hi);
+    _mm256_storeu_si256((__m256i*) los, lo);
+    int peak = getScalarDspKernels().peakS16(in + i, count - i);
+    for (int lane = 0; lane < 16; lane++) {
+        if (his[lane] > peak)
+            peak = his[lane];
+        if (-los[lane] > peak)
+            peak = -los[lane];
+    }
+    return peak;
+}
+
+static const DspKernels sse2Kernels = {
+    "sse2",
+    sse2S16ToFloat,
+    sse2FloatToS16,
+    sse2GainRamp,
+    sse2MixAdd,
+    sse2Dot,
+    sse2PeakS16,
+};
+
+static const DspKernels avx2Kernels = {
+    "avx2",
+    avx2S16ToFloat,
+    avx2FloatToS16,
+    avx2GainRamp,
+    avx2MixAdd,
+    avx2Dot,
+    avx2PeakS16,
+};
+
+const DspKernels* getSse2DspKernels()
+{
+    return &sse2Kernels;
+}
+
+const DspKernels* getAvx2DspKernels()
+{
+    return &avx2Kernels;
+}
+
+#else
+
+const DspKernels* getSse2DspKernels()
+{
+    return nullptr;
+}
+
+const DspKernels* getAvx2DspKernels()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,693 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <errno.h>
+#include <glib.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <AlsaAudioEngine.h>
+#include <DspKernels.h>
+#include <TTSConfig.h>
+#include <TTSLog.h>
+#include <TTSUtils.h>
+#include <ThreadPolicy.h>
+
+#define DEFAULT_DEVICE      "default"
+#define DEFAULT_SAMPLE_RATE 48000
+#define DEFAULT_PERIOD_MS   20
+#define DEFAULT_BUFFER_MS   80
+// renderStep() result that ends the render thread
+#define RENDER_QUIT         -2
+
+static gboolean runOnMainLoop(gpointer data)
+{
+    std::unique_ptr<std::function<void()>> call(static_cast<std::function<void()>*>(data));
+    (*call)();
+    return G_SOURCE_REMOVE;
+}
+
+AlsaAudioEngine::AlsaAudioEngine() : AudioEngine(),
+        mSampleRate(DEFAULT_SAMPLE_RATE), mPeriodMs(DEFAULT_PERIOD_MS), mBufferMs(DEFAULT_BUFFER_MS)
+{
+}
+
+AlsaAudioEngine::~AlsaAudioEngine()
+{
+    deInit();
+}
+
+void AlsaAudioEngine::attachToMainLoop()
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    mReactor = true;
+}
+
+void AlsaAudioEngine::loadConfig()
+{
+    TTSConfig config;
+    if (config.readFile() != TTSErrors::TTS_CONFIG_ERROR_NONE)
+        return;
+
+    pbnjson::JValue devices;
+    (void) config.getValue("alsa", "devices", devices);
+    if (devices.isArray())
+    {
+        for (ssize_t i = 0; i < devices.arraySize(); i++)
+            mDevices.push_back(devices[i].asString());
+    }
+    pbnjson::JValue value;
+    (void) config.getValue("alsa", "sampleRate", value);
+    if (value.isNumber() && value.asNumber<int>() > 0)
+        mSampleRate = value.asNumber<int>();
+    (void) config.getValue("alsa", "periodMs", value);
+    if (value.isNumber() && value.asNumber<int>() > 0)
+        mPeriodMs = value.asNumber<int>();
+    (void) config.getValue("alsa", "bufferMs", value);
+    if (value.isNumber() && value.asNumber<int>() > 0)
+        mBufferMs = value.asNumber<int>();
+    // At least two periods, so one can be written while the other plays
+    mBufferMs = std::max(mBufferMs, 2 * mPeriodMs);
+    LOG_DEBUG("ALSA %u Hz, period %u ms, buffer %u ms", mSampleRate, mPeriodMs, mBufferMs);
+
+    pbnjson::JValue duckLevel;
+    (void) config.getValue("mixer", "duckLevel", duckLevel);
+    if (duckLevel.isNumber())
+        mDuckLevel = duckLevel.asNumber<double>();
+    pbnjson::JValue duckRamp;
+    (void) config.getValue("mixer", "duckRampMs", duckRamp);
+    if (duckRamp.isNumber() && duckRamp.asNumber<int>() >= 0)
+        mDuckRampMs = duckRamp.asNumber<int>();
+    mStreamLimits = SpeechStream::loadLimits(config);
+    mTrimmer.loadConfig(config);
+    mTapSettings = AudioTap::loadSettings(config);
+}
+
+bool AlsaAudioEngine::openDevice(Output& output)
+{
+    if (output.wakeFd < 0)
+        return false;
+    int err = snd_pcm_open(&output.pcm, output.device.c_str(), SND_PCM_STREAM_PLAYBACK, SND_PCM_NONBLOCK);
+    if (err < 0)
+    {
+        LOG_DEBUG("Error: Opening %s failed: %s", output.device.c_str(), snd_strerror(err));
+        output.pcm = nullptr;
+        return false;
+    }
+
+    snd_pcm_hw_params_t *hw = nullptr;
+    snd_pcm_sw_params_t *sw = nullptr;
+    unsigned int rate = mSampleRate;
+    unsigned int channels = 1;
+    snd_pcm_uframes_t period = 0;
+    snd_pcm_uframes_t buffer = 0;
+    int dir = 0;
+    const char *step = nullptr;
+
+    if ((err = snd_pcm_hw_params_malloc(&hw)) < 0 || (err = snd_pcm_sw_params_malloc(&sw)) < 0)
+        step = "params allocation";
+    else if ((err = snd_pcm_hw_params_any(output.pcm, hw)) < 0)
+        step = "hw params";
+    else if ((err = snd_pcm_hw_params_set_access(output.pcm, hw, SND_PCM_ACCESS_MMAP_INTERLEAVED)) < 0)
+        step = "mmap access";
+    else if ((err = snd_pcm_hw_params_set_format(output.pcm, hw, SND_PCM_FORMAT_S16_LE)) < 0)
+        step = "format";
+    else if ((err = snd_pcm_hw_params_set_channels_near(output.pcm, hw, &channels)) < 0)
+        step = "channels";
+    else if ((err = snd_pcm_hw_params_set_rate_near(output.pcm, hw, &rate, &dir)) < 0)
+        step = "rate";
+    if (!step)
+    {
+        period = (snd_pcm_uframes_t) rate * mPeriodMs / 1000;
+        buffer = (snd_pcm_uframes_t) rate * mBufferMs / 1000;
+        if ((err = snd_pcm_hw_params_set_period_size_near(output.pcm, hw, &period, &dir)) < 0)
+            step = "period size";
+        else if ((err = snd_pcm_hw_params_set_buffer_size_near(output.pcm, hw, &buffer)) < 0)
+            step = "buffer size";
+        else if ((err = snd_pcm_hw_params(output.pcm, hw)) < 0)
+            step = "hw params install";
+        else if ((err = snd_pcm_hw_params_get_period_size(hw, &period, &dir)) < 0
+                || (err = snd_pcm_hw_params_get_buffer_size(hw, &buffer)) < 0)
+            step = "hw params query";
+    }
+    if (!step)
+    {
+        output.canPause = snd_pcm_hw_params_can_pause(hw);
+        // Start with the first period, wake up for every free one
+        if ((err = snd_pcm_sw_params_current(output.pcm, sw)) < 0
+                || (err = snd_pcm_sw_params_set_start_threshold(output.pcm, sw, period)) < 0
+                || (err = snd_pcm_sw_params_set_avail_min(output.pcm, sw, period)) < 0
+                || (err = snd_pcm_sw_params(output.pcm, sw)) < 0)
+            step = "sw params";
+    }
+    if (hw)
+        snd_pcm_hw_params_free(hw);
+    if (sw)
+        snd_pcm_sw_params_free(sw);
+    if (step)
+    {
+        LOG_DEBUG("Error: %s setup failed at %s: %s", output.device.c_str(), step, snd_strerror(err));
+        snd_pcm_close(output.pcm);
+        output.pcm = nullptr;
+        return false;
+    }
+
+    output.rate = rate;
+    output.channels = channels;
+    output.periodFrames = period;
+    output.bufferFrames = buffer;
+    output.mixer.setDucking(mDuckLevel, (size_t) rate * mDuckRampMs / 1000);
+    LOG_DEBUG("Opened %s at %u Hz, %u ch, period %lu buffer %lu frames%s", output.device.c_str(), rate,
+            channels, (unsigned long) period, (unsigned long) buffer, output.canPause ? ", can pause" : "");
+    if (mTapSettings.enabled)
+        (void) output.tap.open("tts-tap-" + std::to_string(output.displayId), rate, mTapSettings.capacityMs);
+    output.thread = std::thread(&AlsaAudioEngine::renderLoop, this, std::ref(output));
+    return true;
+}
+
+void AlsaAudioEngine::closeDevice(Output& output)
+{
+    {
+        std::lock_guard<std::mutex> lock(output.mutex);
+        output.quit = true;
+        for (auto &done : output.done)
+            done = nullptr;
+    }
+    wake(output);
+    if (output.thread.joinable())
+        output.thread.join();
+    if (output.pcm)
+    {
+        snd_pcm_close(output.pcm);
+        output.pcm = nullptr;
+    }
+}
+
+bool AlsaAudioEngine::play(unsigned int displayId, AudioVoice voice)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size())
+    {
+        LOG_DEBUG("Error: No audio output for display %u", displayId);
+        return false;
+    }
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool finished = false;
+    bool result = false;
+
+    if (!startPlayback(*mOutputs[displayId], voice, [&mutex, &cond, &finished, &result](bool ret) {
+        std::lock_guard<std::mutex> lock(mutex);
+        result = ret;
+        finished = true;
+        cond.notify_one();
+    }))
+        return false;
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [&finished] { return finished; });
+    LOG_DEBUG("ALSA Play is completed");
+    return result;
+}
+
+void AlsaAudioEngine::playAsync(unsigned int displayId, AudioVoice voice, std::function<void(bool)> done)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size())
+    {
+        LOG_DEBUG("Error: No audio output for display %u", displayId);
+        done(false);
+        return;
+    }
+    // Completions come from the render thread, report them on the main loop
+    if (!startPlayback(*mOutputs[displayId], voice, [done](bool ret) {
+        g_idle_add(runOnMainLoop, new std::function<void()>([done, ret] { done(ret); }));
+    }))
+        done(false);
+}
+
+bool AlsaAudioEngine::startPlayback(Output& output, AudioVoice voice, std::function<void(bool)> done)
+{
+    {
+        std::lock_guard<std::mutex> lock(output.mutex);
+        if (!output.pcm && !openDevice(output))
+            return false;
+    }
+
+    std::vector<uint8_t> data;
+    AudioMetrics::Clock::time_point start = AudioMetrics::Clock::now();
+    unsigned int slot = TTSUtils::getVoiceSlot(output.displayId, voice, mOutputs.size());
+    if (!SpeechDecoder::readFile(TTSUtils::getAudioFilePath(slot), data))
+        return false;
+    output.metrics.fileRead.record(AudioMetrics::elapsedUs(start));
+    output.metrics.utterances++;
+    // Decoded outside the lock so the render thread never waits on it
+    std::vector<float> samples;
+    if (!output.decoders[voice].decode(data.data(), data.size(), output.rate, samples))
+        return false;
+    output.metrics.trimmedMs += output.decoders[voice].getTrimmedMs();
+    // Prefilled to the high watermark before the render thread sees it
+    auto stream = std::make_shared<SpeechStream>(std::move(samples), mStreamLimits, output.rate);
+    (void) stream->feed();
+
+    {
+        std::lock_guard<std::mutex> lock(output.mutex);
+        if (output.done[voice])
+        {
+            LOG_DEBUG("Error: %s voice %d is already playing", output.device.c_str(), (int) voice);
+            return false;
+        }
+        output.mixer.setVoice(voice, stream);
+        output.starts[voice] = start;
+        output.firstPending[voice] = true;
+        output.done[voice] = [&output, stream, done](bool result) {
+            unsigned long underruns = stream->getUnderruns();
+            if (underruns > 0)
+            {
+                output.metrics.streamUnderruns += underruns;
+                LOG_INFO("tts:audio:alsa", 0, "Display %u stream underran %lu times, %llu so far",
+                        output.displayId, underruns,
+                        (unsigned long long) output.metrics.streamUnderruns.load());
+            }
+            done(result);
+        };
+    }
+    wake(output);
+    // The rest follows as the render thread drains the ring
+    if (mReactor)
+        SpeechStream::feedOnMainLoop(std::move(stream));
+    else
+        while (!stream->feed() && stream->waitForSpace())
+            ;
+    return true;
+}
+
+void AlsaAudioEngine::wake(Output& output)
+{
+    uint64_t value = 1;
+    if (output.wakeFd >= 0 && write(output.wakeFd, &value, sizeof(value)) < 0)
+        LOG_DEBUG("Error: Waking the %s render thread failed: %s", output.device.c_str(), strerror(errno));
+}
+
+void AlsaAudioEngine::renderLoop(Output& output)
+{
+    ThreadPolicy::get().apply(THREAD_RENDER);
+    int count = std::max(snd_pcm_poll_descriptors_count(output.pcm), 0);
+    std::vector<struct pollfd> fds(1 + count);
+    fds[0].fd = output.wakeFd;
+    fds[0].events = POLLIN;
+    if (count > 0)
+        count = std::max(snd_pcm_poll_descriptors(output.pcm, &fds[1], count), 0);
+
+    for (;;)
+    {
+        Callbacks finished;
+        bool waitPcm = false;
+        int timeout = renderStep(output, finished, waitPcm);
+        runCallbacks(finished);
+        if (timeout == RENDER_QUIT)
+            break;
+
+        for (auto &fd : fds)
+            fd.revents = 0;
+        int ready = poll(fds.data(), waitPcm ? 1 + count : 1, timeout);
+        if (ready <= 0)
+            continue;
+        if (fds[0].revents & POLLIN)
+        {
+            uint64_t value;
+            (void) read(output.wakeFd, &value, sizeof(value));
+        }
+        if (waitPcm && count > 0)
+        {
+            // Some plugins need their poll events translated
+            unsigned short revents = 0;
+            (void) snd_pcm_poll_descriptors_revents(output.pcm, &fds[1], count, &revents);
+        }
+    }
+}
+
+// One pass of the render thread. Returns the poll() timeout in ms, and
+// whether to wait for room in the PCM as well.
+int AlsaAudioEngine::renderStep(Output& output, Callbacks& finished, bool& waitPcm)
+{
+    std::lock_guard<std::mutex> lock(output.mutex);
+    waitPcm = false;
+    if (output.quit)
+        return RENDER_QUIT;
+
+    if (output.dropPending)
+    {
+        output.dropPending = false;
+        output.hwPaused = false;
+        output.swPaused = false;
+        output.draining = false;
+        (void) snd_pcm_drop(output.pcm);
+        (void) snd_pcm_prepare(output.pcm);
+    }
+
+    if (output.paused)
+    {
+        // Without hardware pause the buffer plays out and underruns
+        if (!output.hwPaused && !output.swPaused)
+        {
+            if (output.canPause && snd_pcm_state(output.pcm) == SND_PCM_STATE_RUNNING
+                    && snd_pcm_pause(output.pcm, 1) == 0)
+                output.hwPaused = true;
+            else
+                output.swPaused = true;
+        }
+        return -1;
+    }
+    if (output.hwPaused)
+    {
+        (void) snd_pcm_pause(output.pcm, 0);
+        output.hwPaused = false;
+    }
+    if (output.swPaused)
+    {
+        // That underrun was asked for, it is not counted
+        output.swPaused = false;
+        if (snd_pcm_state(output.pcm) == SND_PCM_STATE_XRUN)
+            (void) snd_pcm_prepare(output.pcm);
+    }
+
+    if (output.mixer.isActive())
+    {
+        output.draining = false;
+        if (!writeFrames(output))
+        {
+            takeAll(output, finished, false);
+            (void) snd_pcm_drop(output.pcm);
+            (void) snd_pcm_prepare(output.pcm);
+            return -1;
+        }
+        if (output.mixer.isActive())
+        {
+            // A voice that ended under another one is done once written
+            for (unsigned int voice = 0; voice < VOICE_COUNT; voice++)
+            {
+                if (output.done[voice] && !output.mixer.isActive((AudioVoice) voice))
+                {
+                    finished.emplace_back(std::move(output.done[voice]), true);
+                    output.done[voice] = nullptr;
+                }
+            }
+            waitPcm = true;
+            return -1;
+        }
+    }
+    if (!isBusy(output))
+        return -1;
+
+    // Everything is written, the last voices end once the device played it
+    if (!output.draining)
+    {
+        output.draining = true;
+        output.drainStart = AudioMetrics::Clock::now();
+    }
+    snd_pcm_sframes_t avail = snd_pcm_avail_update(output.pcm);
+    if (avail < 0 || (snd_pcm_uframes_t) avail >= output.bufferFrames
+            || snd_pcm_state(output.pcm) != SND_PCM_STATE_RUNNING)
+    {
+        output.draining = false;
+        output.metrics.drain.record(AudioMetrics::elapsedUs(output.drainStart));
+        takeAll(output, finished, true);
+        (void) snd_pcm_drop(output.pcm);
+        (void) snd_pcm_prepare(output.pcm);
+        return -1;
+    }
+    return std::max(1, (int) ((output.bufferFrames - avail) * 1000 / output.rate));
+}
+
+bool AlsaAudioEngine::writeFrames(Output& output)
+{
+    const DspKernels &dsp = getDspKernels();
+    bool wrote = false;
+    while (output.mixer.isActive())
+    {
+        AudioMetrics::Clock::time_point writeStart = AudioMetrics::Clock::now();
+        snd_pcm_sframes_t avail = snd_pcm_avail_update(output.pcm);
+        if (avail < 0)
+        {
+            if (!recover(output, (int) avail))
+                return false;
+            continue;
+        }
+        if (avail == 0)
+            break;
+
+        const snd_pcm_channel_area_t *areas = nullptr;
+        snd_pcm_uframes_t offset = 0;
+        snd_pcm_uframes_t frames = std::min((snd_pcm_uframes_t) avail, output.periodFrames);
+        int err = snd_pcm_mmap_begin(output.pcm, &areas, &offset, &frames);
+        if (err < 0)
+        {
+            if (!recover(output, err))
+                return false;
+            continue;
+        }
+
+        output.mixBuffer.resize(frames);
+        size_t mixed = output.mixer.mix(output.mixBuffer.data(), frames);
+        output.pcmBuffer.resize(mixed);
+        dsp.floatToS16(output.mixBuffer.data(), output.pcmBuffer.data(), mixed);
+        // The mono mix goes to every channel of the interleaved area
+        for (unsigned int ch = 0; ch < output.channels; ch++)
+        {
+            const snd_pcm_channel_area_t &area = areas[ch];
+            int16_t *dst = reinterpret_cast<int16_t*>(static_cast<uint8_t*>(area.addr)
+                    + (area.first + offset * area.step) / 8);
+            size_t stride = area.step / 16;
+            for (size_t i = 0; i < mixed; i++)
+                dst[i * stride] = output.pcmBuffer[i];
+        }
+
+        snd_pcm_sframes_t committed = snd_pcm_mmap_commit(output.pcm, offset, mixed);
+        if (committed < 0 || (snd_pcm_uframes_t) committed != mixed)
+        {
+            if (!recover(output, committed < 0 ? (int) committed : -EPIPE))
+                return false;
+            continue;
+        }
+        output.metrics.writeStall.record(AudioMetrics::elapsedUs(writeStart));
+        wrote = wrote || mixed > 0;
+        if (output.tap.isOpen() && mixed > 0)
+        {
+            // The block starts behind whatever the device still holds ahead of it
+            snd_pcm_sframes_t delay = 0;
+            if (snd_pcm_delay(output.pcm, &delay) == 0)
+            {
+                int64_t ahead = std::max<int64_t>((int64_t) delay - (int64_t) mixed, 0);
+                output.tap.stamp(AudioTap::nowNs() + ahead * 1000000000 / output.rate);
+            }
+            output.tap.write(output.mixBuffer.data(), mixed);
+        }
+    }
+    if (wrote)
+    {
+        // Heard once what the device buffered ahead of it has played
+        snd_pcm_sframes_t delay = 0;
+        uint64_t latencyUs = 0;
+        if (snd_pcm_delay(output.pcm, &delay) == 0 && delay > 0)
+            latencyUs = (uint64_t) delay * 1000000 / output.rate;
+        output.metrics.latency.record(latencyUs);
+        for (unsigned int voice = 0; voice < VOICE_COUNT; voice++)
+        {
+            if (!output.firstPending[voice])
+                continue;
+            output.firstPending[voice] = false;
+            output.metrics.firstSample.record(AudioMetrics::elapsedUs(output.starts[voice]) + latencyUs);
+        }
+    }
+    // Utterances shorter than the start threshold start here
+    if (!output.mixer.isActive() && snd_pcm_state(output.pcm) == SND_PCM_STATE_PREPARED)
+        (void) snd_pcm_start(output.pcm);
+    return true;
+}
+
+bool AlsaAudioEngine::recover(Output& output, int err)
+{
+    if (err == -EPIPE)
+    {
+        output.metrics.underruns++;
+        LOG_INFO("tts:audio:alsa", 0, "%s underrun, %llu so far", output.device.c_str(),
+                (unsigned long long) output.metrics.underruns.load());
+    }
+    err = snd_pcm_recover(output.pcm, err, 1);
+    if (err < 0)
+    {
+        LOG_DEBUG("Error: %s recovery failed: %s", output.device.c_str(), snd_strerror(err));
+        return false;
+    }
+    return true;
+}
+
+bool AlsaAudioEngine::isBusy(const Output& output)
+{
+    for (const auto &done : output.done)
+    {
+        if (done)
+            return true;
+    }
+    return false;
+}
+
+void AlsaAudioEngine::takeAll(Output& output, Callbacks& finished, bool result)
+{
+    for (unsigned int voice = 0; voice < VOICE_COUNT; voice++)
+    {
+        output.mixer.clearVoice((AudioVoice) voice);
+        output.firstPending[voice] = false;
+        if (output.done[voice])
+        {
+            finished.emplace_back(std::move(output.done[voice]), result);
+            output.done[voice] = nullptr;
+        }
+    }
+}
+
+void AlsaAudioEngine::runCallbacks(Callbacks& finished)
+{
+    for (auto &callback : finished)
+        callback.first(callback.second);
+    finished.clear();
+}
+
+bool AlsaAudioEngine::stop(unsigned int displayId, AudioVoice voice)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size())
+        return true;
+    Output &output = *mOutputs[displayId];
+    std::function<void(bool)> done;
+    {
+        std::lock_guard<std::mutex> lock(output.mutex);
+        if (!output.done[voice])
+        {
+            // A pause taken during synthesis ends with the utterance
+            if (!isBusy(output))
+                output.paused = false;
+            return true;
+        }
+        LOG_INFO("tts:audio:alsa", 0, "INFO: Got Stop Command While Playing ");
+        done = std::move(output.done[voice]);
+        output.done[voice] = nullptr;
+        output.firstPending[voice] = false;
+        output.mixer.clearVoice(voice);
+        // Drop what the device still holds unless another voice is in it
+        if (!isBusy(output))
+        {
+            output.dropPending = true;
+            output.paused = false;
+        }
+    }
+    wake(output);
+    done(true);
+    return true;
+}
+
+bool AlsaAudioEngine::pause(unsigned int displayId)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size())
+        return false;
+    Output &output = *mOutputs[displayId];
+    {
+        std::lock_guard<std::mutex> lock(output.mutex);
+        if (output.paused)
+            return false;
+        output.paused = true;
+    }
+    wake(output);
+    LOG_INFO("tts:audio:alsa", 0, "%s paused", output.device.c_str());
+    return true;
+}
+
+bool AlsaAudioEngine::resume(unsigned int displayId)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size())
+        return false;
+    Output &output = *mOutputs[displayId];
+    {
+        std::lock_guard<std::mutex> lock(output.mutex);
+        if (!output.paused)
+            return false;
+        output.paused = false;
+    }
+    wake(output);
+    LOG_INFO("tts:audio:alsa", 0, "%s resumed", output.device.c_str());
+    return true;
+}
+
+const AudioMetrics* AlsaAudioEngine::getMetrics(unsigned int displayId) const
+{
+    return (displayId < mOutputs.size()) ? &mOutputs[displayId]->metrics : nullptr;
+}
+
+const AudioTap* AlsaAudioEngine::getTap(unsigned int displayId) const
+{
+    return (displayId < mOutputs.size()) ? &mOutputs[displayId]->tap : nullptr;
+}
+
+void AlsaAudioEngine::init(unsigned int displayCount)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    loadConfig();
+    for (unsigned int displayId = mOutputs.size(); displayId < displayCount; displayId++)
+    {
+        std::unique_ptr<Output> output(new Output);
+        output->displayId = displayId;
+        for (auto &decoder : output->decoders)
+            decoder.setTrimmer(mTrimmer);
+        // Displays beyond the configured list share the last device
+        if (displayId < mDevices.size())
+            output->device = mDevices[displayId];
+        else
+            output->device = mDevices.empty() ? DEFAULT_DEVICE : mDevices.back();
+        // Without a wakeup the output stays, disabled, so display ids still
+        // index mOutputs
+        output->wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (output->wakeFd < 0)
+            LOG_DEBUG("Error: eventfd failed, %s disabled: %s", output->device.c_str(), strerror(errno));
+        mOutputs.push_back(std::move(output));
+    }
+    for (auto &output : mOutputs)
+    {
+        std::lock_guard<std::mutex> lock(output->mutex);
+        if (!output->pcm && !openDevice(*output))
+            LOG_DEBUG("Error: Could not open %s, retrying on play", output->device.c_str());
+    }
+}
+
+void AlsaAudioEngine::deInit()
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    for (auto &output : mOutputs)
+    {
+        closeDevice(*output);
+        output->tap.close();
+        if (output->wakeFd >= 0)
+        {
+            close(output->wakeFd);
+            output->wakeFd = -1;
+        }
+    }
+    mOutputs.clear();
+}
@@ -0,0 +1,124 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SRC_ENGINE_ALSAAUDIOENGINE_H_
+#define SRC_ENGINE_ALSAAUDIOENGINE_H_
+
+#include <alsa/asoundlib.h>
+#include <AudioEngine.h>
+#include <AudioEngineFactory.h>
+#include <AudioMixer.h>
+#include <SpeechDecoder.h>
+#include <SpeechStream.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Plays straight to an ALSA PCM per output, for systems without a sound
+// server. Each output has a render thread that waits in poll() on the PCM
+// and writes the mixed voices through the mmap transfer API. Works with
+// the userspace "null" and "file" PCM plugins as well as real hardware.
+class AlsaAudioEngine: public AudioEngine
+{
+public:
+    AlsaAudioEngine();
+    virtual ~AlsaAudioEngine();
+    void init(unsigned int displayCount);
+    void attachToMainLoop();
+    bool play(unsigned int displayId, AudioVoice voice);
+    void playAsync(unsigned int displayId, AudioVoice voice, std::function<void(bool)> done);
+    bool stop(unsigned int displayId, AudioVoice voice);
+    bool pause(unsigned int displayId);
+    bool resume(unsigned int displayId);
+    const AudioMetrics* getMetrics(unsigned int displayId) const;
+    const AudioTap* getTap(unsigned int displayId) const;
+    void deInit();
+private:
+    struct Output
+    {
+        unsigned int displayId = 0;
+        std::string device;
+        // Fixed once the PCM is open
+        snd_pcm_t *pcm = nullptr;
+        unsigned int rate = 0;
+        unsigned int channels = 0;
+        snd_pcm_uframes_t periodFrames = 0;
+        snd_pcm_uframes_t bufferFrames = 0;
+        bool canPause = false;
+        // One per voice, each voice's requests come from one queue
+        SpeechDecoder decoders[VOICE_COUNT];
+        std::thread thread;
+        int wakeFd = -1;
+        AudioMetrics metrics;
+        // Written by the render thread only
+        AudioTap tap;
+
+        // Guarded by mutex, shared with the render thread
+        std::mutex mutex;
+        AudioMixer mixer;
+        std::function<void(bool)> done[VOICE_COUNT];
+        // Set by play(), the first sample is counted once written
+        AudioMetrics::Clock::time_point starts[VOICE_COUNT];
+        bool firstPending[VOICE_COUNT] = {};
+        bool paused = false;
+        bool dropPending = false;
+        bool quit = false;
+
+        // Render thread only
+        bool hwPaused = false;
+        bool swPaused = false;
+        // Everything is written, waiting for the device to play it out
+        bool draining = false;
+        AudioMetrics::Clock::time_point drainStart;
+        std::vector<float> mixBuffer;
+        std::vector<int16_t> pcmBuffer;
+    };
+
+    // Completions gathered under the lock, run after it is released
+    typedef std::vector<std::pair<std::function<void(bool)>, bool>> Callbacks;
+
+    void loadConfig();
+    bool openDevice(Output& output);
+    void closeDevice(Output& output);
+    bool startPlayback(Output& output, AudioVoice voice, std::function<void(bool)> done);
+    void wake(Output& output);
+    void renderLoop(Output& output);
+    int renderStep(Output& output, Callbacks& finished, bool& waitPcm);
+    bool writeFrames(Output& output);
+    bool recover(Output& output, int err);
+    static bool isBusy(const Output& output);
+    static void takeAll(Output& output, Callbacks& finished, bool result);
+    static void runCallbacks(Callbacks& finished);
+
+    std::vector<std::unique_ptr<Output>> mOutputs;
+    std::vector<std::string> mDevices;
+    unsigned int mSampleRate;
+    unsigned int mPeriodMs;
+    unsigned int mBufferMs;
+    float mDuckLevel = DEFAULT_DUCK_LEVEL;
+    unsigned int mDuckRampMs = DEFAULT_DUCK_RAMP_MS;
+    SilenceTrimmer mTrimmer;
+    StreamLimits mStreamLimits;
+    TapSettings mTapSettings;
+    bool mReactor = false;
+};
+
+#endif /* SRC_ENGINE_ALSAAUDIOENGINE_H_ */
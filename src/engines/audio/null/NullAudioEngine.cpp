@@ -0,0 +1,611 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <glib.h>
+#include <sys/stat.h>
+#include <DspKernels.h>
+#include <NullAudioEngine.h>
+#include <TTSConfig.h>
+#include <TTSLog.h>
+#include <TTSUtils.h>
+#include <ThreadPolicy.h>
+
+#define DEFAULT_SAMPLE_RATE 48000
+#define DEFAULT_PERIOD_MS   20
+#define DEFAULT_BUFFER_MS   80
+#define DEFAULT_DIRECTORY   "/tmp/tts-sink"
+#define WAV_HEADER_SIZE     44
+// endFrame of a voice that is still being mixed
+#define END_UNKNOWN         UINT64_MAX
+
+static gboolean runOnMainLoop(gpointer data)
+{
+    std::unique_ptr<std::function<void()>> call(static_cast<std::function<void()>*>(data));
+    (*call)();
+    return G_SOURCE_REMOVE;
+}
+
+static void putLE(uint8_t* dst, uint32_t value, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++)
+        dst[i] = (uint8_t) (value >> (8 * i));
+}
+
+// Rewrites the header of a mono 16 bit WAV file holding frames frames
+static void writeWavHeader(FILE* file, unsigned int rate, uint64_t frames)
+{
+    uint32_t dataSize = (uint32_t) std::min<uint64_t>(frames * 2, UINT32_MAX - WAV_HEADER_SIZE);
+    uint8_t header[WAV_HEADER_SIZE];
+    memcpy(header, "RIFF", 4);
+    putLE(header + 4, dataSize + WAV_HEADER_SIZE - 8, 4);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    putLE(header + 16, 16, 4);
+    putLE(header + 20, 1, 2);
+    putLE(header + 22, 1, 2);
+    putLE(header + 24, rate, 4);
+    putLE(header + 28, rate * 2, 4);
+    putLE(header + 32, 2, 2);
+    putLE(header + 34, 16, 2);
+    memcpy(header + 36, "data", 4);
+    putLE(header + 40, dataSize, 4);
+
+    long position = ftell(file);
+    rewind(file);
+    (void) fwrite(header, 1, sizeof(header), file);
+    if (position > WAV_HEADER_SIZE)
+        (void) fseek(file, position, SEEK_SET);
+    (void) fflush(file);
+}
+
+NullAudioEngine::NullAudioEngine(bool recordWav) : AudioEngine(), mRecordWav(recordWav),
+        mSampleRate(DEFAULT_SAMPLE_RATE), mPeriodMs(DEFAULT_PERIOD_MS), mBufferMs(DEFAULT_BUFFER_MS),
+        mDirectory(DEFAULT_DIRECTORY)
+{
+}
+
+NullAudioEngine::~NullAudioEngine()
+{
+    deInit();
+}
+
+void NullAudioEngine::attachToMainLoop()
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    mReactor = true;
+}
+
+void NullAudioEngine::loadConfig()
+{
+    TTSConfig config;
+    if (config.readFile() != TTSErrors::TTS_CONFIG_ERROR_NONE)
+        return;
+
+    pbnjson::JValue value;
+    (void) config.getValue("sink", "clock", value);
+    if (value.isString())
+        mRealtime = value.asString() != "fast";
+    (void) config.getValue("sink", "sampleRate", value);
+    if (value.isNumber() && value.asNumber<int>() > 0)
+        mSampleRate = value.asNumber<int>();
+    (void) config.getValue("sink", "periodMs", value);
+    if (value.isNumber() && value.asNumber<int>() > 0)
+        mPeriodMs = value.asNumber<int>();
+    (void) config.getValue("sink", "bufferMs", value);
+    if (value.isNumber() && value.asNumber<int>() > 0)
+        mBufferMs = value.asNumber<int>();
+    mBufferMs = std::max(mBufferMs, 2 * mPeriodMs);
+    (void) config.getValue("sink", "timeline", value);
+    mTimeline = value.isBoolean() && value.asBool();
+    (void) config.getValue("sink", "directory", value);
+    if (value.isString())
+        mDirectory = value.asString();
+    LOG_DEBUG("Sink %s clock, %u Hz, period %u ms, buffer %u ms", mRealtime ? "realtime" : "fast",
+            mSampleRate, mPeriodMs, mBufferMs);
+
+    pbnjson::JValue duckLevel;
+    (void) config.getValue("mixer", "duckLevel", duckLevel);
+    if (duckLevel.isNumber())
+        mDuckLevel = duckLevel.asNumber<double>();
+    pbnjson::JValue duckRamp;
+    (void) config.getValue("mixer", "duckRampMs", duckRamp);
+    if (duckRamp.isNumber() && duckRamp.asNumber<int>() >= 0)
+        mDuckRampMs = duckRamp.asNumber<int>();
+    mStreamLimits = SpeechStream::loadLimits(config);
+    mTrimmer.loadConfig(config);
+    mTapSettings = AudioTap::loadSettings(config);
+}
+
+bool NullAudioEngine::openFiles(Output& output)
+{
+    if (!mRecordWav && !mTimeline)
+        return true;
+    if (mkdir(mDirectory.c_str(), 0755) < 0 && errno != EEXIST)
+    {
+        LOG_DEBUG("Error: Creating %s failed: %s", mDirectory.c_str(), strerror(errno));
+        return false;
+    }
+    std::string base = mDirectory + "/display" + std::to_string(output.displayId);
+    if (mRecordWav)
+    {
+        output.wavFile = fopen((base + ".wav").c_str(), "wb");
+        if (!output.wavFile)
+        {
+            LOG_DEBUG("Error: Opening %s.wav failed: %s", base.c_str(), strerror(errno));
+            return false;
+        }
+        writeWavHeader(output.wavFile, mSampleRate, 0);
+    }
+    if (mTimeline)
+    {
+        output.timeline = fopen((base + ".timeline").c_str(), "w");
+        if (!output.timeline)
+        {
+            LOG_DEBUG("Error: Opening %s.timeline failed: %s", base.c_str(), strerror(errno));
+            return false;
+        }
+        // value: frames for write/underrun/drop, the voice for the others
+        fprintf(output.timeline, "# us event frame value\n");
+    }
+    return true;
+}
+
+void NullAudioEngine::closeFiles(Output& output)
+{
+    if (output.wavFile)
+    {
+        writeWavHeader(output.wavFile, mSampleRate, output.written);
+        fclose(output.wavFile);
+        output.wavFile = nullptr;
+    }
+    if (output.timeline)
+    {
+        fclose(output.timeline);
+        output.timeline = nullptr;
+    }
+}
+
+void NullAudioEngine::logEvent(Output& output, const char* event, long value)
+{
+    if (!output.timeline)
+        return;
+    long long us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - mEpoch).count();
+    fprintf(output.timeline, "%lld %s %llu %ld\n", us, event, (unsigned long long) output.written, value);
+}
+
+bool NullAudioEngine::play(unsigned int displayId, AudioVoice voice)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size())
+    {
+        LOG_DEBUG("Error: No audio output for display %u", displayId);
+        return false;
+    }
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool finished = false;
+    bool result = false;
+
+    if (!startPlayback(*mOutputs[displayId], voice, [&mutex, &cond, &finished, &result](bool ret) {
+        std::lock_guard<std::mutex> lock(mutex);
+        result = ret;
+        finished = true;
+        cond.notify_one();
+    }))
+        return false;
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [&finished] { return finished; });
+    return result;
+}
+
+void NullAudioEngine::playAsync(unsigned int displayId, AudioVoice voice, std::function<void(bool)> done)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size())
+    {
+        LOG_DEBUG("Error: No audio output for display %u", displayId);
+        done(false);
+        return;
+    }
+    // Completions come from the render thread, report them on the main loop
+    if (!startPlayback(*mOutputs[displayId], voice, [done](bool ret) {
+        g_idle_add(runOnMainLoop, new std::function<void()>([done, ret] { done(ret); }));
+    }))
+        done(false);
+}
+
+bool NullAudioEngine::startPlayback(Output& output, AudioVoice voice, std::function<void(bool)> done)
+{
+    std::vector<uint8_t> data;
+    Clock::time_point start = Clock::now();
+    unsigned int slot = TTSUtils::getVoiceSlot(output.displayId, voice, mOutputs.size());
+    if (!SpeechDecoder::readFile(TTSUtils::getAudioFilePath(slot), data))
+        return false;
+    output.metrics.fileRead.record(AudioMetrics::elapsedUs(start));
+    output.metrics.utterances++;
+    std::vector<float> samples;
+    if (!output.decoders[voice].decode(data.data(), data.size(), mSampleRate, samples))
+        return false;
+    output.metrics.trimmedMs += output.decoders[voice].getTrimmedMs();
+    // Prefilled to the high watermark before the render thread sees it
+    auto stream = std::make_shared<SpeechStream>(std::move(samples), mStreamLimits, mSampleRate);
+    (void) stream->feed();
+
+    {
+        std::lock_guard<std::mutex> lock(output.mutex);
+        if (output.done[voice])
+        {
+            LOG_DEBUG("Error: Display %u voice %d is already playing", output.displayId, (int) voice);
+            return false;
+        }
+        output.mixer.setVoice(voice, stream);
+        output.starts[voice] = start;
+        output.firstPending[voice] = true;
+        output.done[voice] = [&output, stream, done](bool result) {
+            unsigned long underruns = stream->getUnderruns();
+            if (underruns > 0)
+            {
+                output.metrics.streamUnderruns += underruns;
+                LOG_INFO("tts:audio:null", 0, "Display %u stream underran %lu times, %llu so far",
+                        output.displayId, underruns,
+                        (unsigned long long) output.metrics.streamUnderruns.load());
+            }
+            done(result);
+        };
+        output.endFrame[voice] = END_UNKNOWN;
+        logEvent(output, "play", voice);
+    }
+    output.cond.notify_one();
+    // The rest follows as the render thread drains the ring
+    if (mReactor)
+        SpeechStream::feedOnMainLoop(std::move(stream));
+    else
+        while (!stream->feed() && stream->waitForSpace())
+            ;
+    return true;
+}
+
+// Moves the simulated play position to now. Running past the written
+// audio while a voice still has samples left is an underrun; the gap is
+// recorded as silence, as a device would have played it.
+void NullAudioEngine::advanceClock(Output& output, Clock::time_point now)
+{
+    uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - output.clockStart).count();
+    uint64_t played = output.clockBase + elapsed * mSampleRate / 1000000;
+    if (played > output.written)
+    {
+        if (output.mixer.isActive())
+        {
+            output.metrics.underruns++;
+            LOG_INFO("tts:audio:null", 0, "Display %u underrun of %llu frames, %llu so far", output.displayId,
+                    (unsigned long long) (played - output.written),
+                    (unsigned long long) output.metrics.underruns.load());
+            logEvent(output, "underrun", (long) (played - output.written));
+            writeSilence(output, played - output.written);
+        }
+        else
+        {
+            played = output.written;
+        }
+    }
+    output.played = std::max(output.played, played);
+}
+
+void NullAudioEngine::writeSilence(Output& output, uint64_t frames)
+{
+    if (output.wavFile)
+    {
+        std::vector<int16_t> silence((size_t) std::min<uint64_t>(frames, mSampleRate), 0);
+        for (uint64_t left = frames; left > 0; )
+        {
+            size_t count = (size_t) std::min<uint64_t>(left, silence.size());
+            (void) fwrite(silence.data(), sizeof(int16_t), count, output.wavFile);
+            left -= count;
+        }
+    }
+    output.written += frames;
+}
+
+void NullAudioEngine::writeFrames(Output& output, uint64_t target)
+{
+    const DspKernels &dsp = getDspKernels();
+    const uint64_t period = (uint64_t) mSampleRate * mPeriodMs / 1000;
+    // Without a clock there is no deadline, so a starved stream is waited for
+    while (output.mixer.isActive() && output.written < target && (mRealtime || !output.mixer.isStarved()))
+    {
+        size_t frames = (size_t) std::min(period, target - output.written);
+        Clock::time_point writeStart = Clock::now();
+        output.mixBuffer.resize(frames);
+        size_t mixed = output.mixer.mix(output.mixBuffer.data(), frames);
+        output.pcmBuffer.resize(mixed);
+        dsp.floatToS16(output.mixBuffer.data(), output.pcmBuffer.data(), mixed);
+        if (output.wavFile)
+            (void) fwrite(output.pcmBuffer.data(), sizeof(int16_t), mixed, output.wavFile);
+        logEvent(output, "write", (long) mixed);
+        output.metrics.writeStall.record(AudioMetrics::elapsedUs(writeStart));
+        // Heard once the clock reaches where this block starts, at once without a clock
+        uint64_t latencyUs = 0;
+        if (mRealtime)
+            latencyUs = (output.written - std::min(output.played, output.written)) * 1000000 / mSampleRate;
+        output.metrics.latency.record(latencyUs);
+        if (output.tap.isOpen() && mixed > 0)
+        {
+            output.tap.stamp(AudioTap::nowNs() + (int64_t) latencyUs * 1000);
+            output.tap.write(output.mixBuffer.data(), mixed);
+        }
+        for (unsigned int voice = 0; voice < VOICE_COUNT; voice++)
+        {
+            if (!output.firstPending[voice])
+                continue;
+            output.firstPending[voice] = false;
+            output.metrics.firstSample.record(AudioMetrics::elapsedUs(output.starts[voice]) + latencyUs);
+        }
+        output.written += mixed;
+
+        for (unsigned int voice = 0; voice < VOICE_COUNT; voice++)
+        {
+            if (output.done[voice] && output.endFrame[voice] == END_UNKNOWN
+                    && !output.mixer.isActive((AudioVoice) voice))
+                output.endFrame[voice] = output.written;
+        }
+    }
+}
+
+void NullAudioEngine::renderLoop(Output& output)
+{
+    ThreadPolicy::get().apply(THREAD_RENDER);
+    const uint64_t buffer = (uint64_t) mSampleRate * mBufferMs / 1000;
+    std::unique_lock<std::mutex> lock(output.mutex);
+    while (!output.quit)
+    {
+        Clock::time_point now = Clock::now();
+        if (output.running)
+            advanceClock(output, now);
+        if (output.dropPending)
+        {
+            output.dropPending = false;
+            logEvent(output, "drop", (long) (output.written - output.played));
+            output.played = output.written;
+            output.running = false;
+            output.draining = false;
+        }
+        if (output.paused)
+        {
+            output.running = false;
+            output.cond.wait(lock);
+            continue;
+        }
+        if (output.running && output.played >= output.written)
+            output.running = false;
+
+        writeFrames(output, mRealtime ? output.played + buffer : UINT64_MAX);
+        if (!mRealtime)
+        {
+            output.played = output.written;
+        }
+        else if (!output.running && output.written > output.played)
+        {
+            output.running = true;
+            output.clockStart = now;
+            output.clockBase = output.played;
+        }
+
+        if (output.mixer.isActive())
+        {
+            output.draining = false;
+        }
+        else if (isBusy(output) && !output.draining)
+        {
+            output.draining = true;
+            output.drainStart = now;
+        }
+
+        Callbacks finished;
+        uint64_t nextEnd = END_UNKNOWN;
+        for (unsigned int voice = 0; voice < VOICE_COUNT; voice++)
+        {
+            if (!output.done[voice])
+                continue;
+            // Empty utterances never went through writeFrames()
+            if (output.endFrame[voice] == END_UNKNOWN && !output.mixer.isActive((AudioVoice) voice))
+                output.endFrame[voice] = output.written;
+            if (output.endFrame[voice] <= output.played)
+            {
+                logEvent(output, "done", voice);
+                finished.emplace_back(std::move(output.done[voice]), true);
+                output.done[voice] = nullptr;
+            }
+            else
+            {
+                nextEnd = std::min(nextEnd, output.endFrame[voice]);
+            }
+        }
+        if (!finished.empty())
+        {
+            if (output.draining && !isBusy(output))
+            {
+                output.draining = false;
+                output.metrics.drain.record(AudioMetrics::elapsedUs(output.drainStart));
+            }
+            if (output.wavFile && !isBusy(output))
+                writeWavHeader(output.wavFile, mSampleRate, output.written);
+            lock.unlock();
+            runCallbacks(finished);
+            lock.lock();
+            continue;
+        }
+
+        if (!output.running && output.mixer.isActive())
+        {
+            // Fast clock waiting on a stream producer, which cannot wake us
+            output.cond.wait_for(lock, std::chrono::milliseconds(1));
+            continue;
+        }
+        if (!output.running)
+        {
+            output.cond.wait(lock);
+            continue;
+        }
+        // Wake up for the next period, or when a voice has played out
+        uint64_t frames = (uint64_t) mSampleRate * mPeriodMs / 1000;
+        if (nextEnd != END_UNKNOWN)
+            frames = std::min(frames, nextEnd - output.played);
+        output.cond.wait_for(lock, std::chrono::microseconds(frames * 1000000 / mSampleRate + 1));
+    }
+}
+
+bool NullAudioEngine::isBusy(const Output& output)
+{
+    for (const auto &done : output.done)
+    {
+        if (done)
+            return true;
+    }
+    return false;
+}
+
+void NullAudioEngine::runCallbacks(Callbacks& finished)
+{
+    for (auto &callback : finished)
+        callback.first(callback.second);
+    finished.clear();
+}
+
+bool NullAudioEngine::stop(unsigned int displayId, AudioVoice voice)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size())
+        return true;
+    Output &output = *mOutputs[displayId];
+    std::function<void(bool)> done;
+    {
+        std::lock_guard<std::mutex> lock(output.mutex);
+        if (!output.done[voice])
+        {
+            // A pause taken during synthesis ends with the utterance
+            if (!isBusy(output))
+                output.paused = false;
+            return true;
+        }
+        LOG_INFO("tts:audio:null", 0, "INFO: Got Stop Command While Playing ");
+        logEvent(output, "stop", voice);
+        done = std::move(output.done[voice]);
+        output.done[voice] = nullptr;
+        output.firstPending[voice] = false;
+        output.mixer.clearVoice(voice);
+        // Drop what the sink still holds unless another voice is in it
+        if (!isBusy(output))
+        {
+            output.dropPending = true;
+            output.paused = false;
+        }
+    }
+    output.cond.notify_one();
+    done(true);
+    return true;
+}
+
+bool NullAudioEngine::pause(unsigned int displayId)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size())
+        return false;
+    Output &output = *mOutputs[displayId];
+    {
+        std::lock_guard<std::mutex> lock(output.mutex);
+        if (output.paused)
+            return false;
+        output.paused = true;
+        logEvent(output, "pause", 0);
+    }
+    output.cond.notify_one();
+    return true;
+}
+
+bool NullAudioEngine::resume(unsigned int displayId)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size())
+        return false;
+    Output &output = *mOutputs[displayId];
+    {
+        std::lock_guard<std::mutex> lock(output.mutex);
+        if (!output.paused)
+            return false;
+        output.paused = false;
+        logEvent(output, "resume", 0);
+    }
+    output.cond.notify_one();
+    return true;
+}
+
+const AudioMetrics* NullAudioEngine::getMetrics(unsigned int displayId) const
+{
+    return (displayId < mOutputs.size()) ? &mOutputs[displayId]->metrics : nullptr;
+}
+
+const AudioTap* NullAudioEngine::getTap(unsigned int displayId) const
+{
+    return (displayId < mOutputs.size()) ? &mOutputs[displayId]->tap : nullptr;
+}
+
+void NullAudioEngine::init(unsigned int displayCount)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    loadConfig();
+    mEpoch = Clock::now();
+    for (unsigned int displayId = mOutputs.size(); displayId < displayCount; displayId++)
+    {
+        std::unique_ptr<Output> output(new Output);
+        output->displayId = displayId;
+        output->mixer.setDucking(mDuckLevel, (size_t) mSampleRate * mDuckRampMs / 1000);
+        for (auto &decoder : output->decoders)
+            decoder.setTrimmer(mTrimmer);
+        if (!openFiles(*output))
+            closeFiles(*output);
+        if (mTapSettings.enabled)
+            (void) output->tap.open("tts-tap-" + std::to_string(displayId), mSampleRate, mTapSettings.capacityMs);
+        output->thread = std::thread(&NullAudioEngine::renderLoop, this, std::ref(*output));
+        mOutputs.push_back(std::move(output));
+    }
+}
+
+void NullAudioEngine::deInit()
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    for (auto &output : mOutputs)
+    {
+        {
+            std::lock_guard<std::mutex> lock(output->mutex);
+            output->quit = true;
+            for (auto &done : output->done)
+                done = nullptr;
+        }
+        output->cond.notify_one();
+        if (output->thread.joinable())
+            output->thread.join();
+        LOG_INFO("tts:audio:null", 0, "Display %u wrote %llu frames with %llu underruns, %llu stream underruns",
+                output->displayId, (unsigned long long) output->written,
+                (unsigned long long) output->metrics.underruns.load(),
+                (unsigned long long) output->metrics.streamUnderruns.load());
+        closeFiles(*output);
+        output->tap.close();
+    }
+    mOutputs.clear();
+}
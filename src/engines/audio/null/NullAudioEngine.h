@@ -0,0 +1,134 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef SRC_ENGINE_NULLAUDIOENGINE_H_
+#define SRC_ENGINE_NULLAUDIOENGINE_H_
+
+#include <AudioEngine.h>
+#include <AudioEngineFactory.h>
+#include <AudioMixer.h>
+#include <SpeechDecoder.h>
+#include <SpeechStream.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Audio sink without a device, for benchmarks on machines with no sound
+// server. The mixed output is consumed by a simulated clock at real-time
+// pace, or as fast as it is produced. Optionally logs every block written
+// with its timestamp; the "wav-file" variant also keeps the samples in one
+// WAV file per display.
+class NullAudioEngine: public AudioEngine
+{
+public:
+    explicit NullAudioEngine(bool recordWav);
+    virtual ~NullAudioEngine();
+    void init(unsigned int displayCount);
+    void attachToMainLoop();
+    bool play(unsigned int displayId, AudioVoice voice);
+    void playAsync(unsigned int displayId, AudioVoice voice, std::function<void(bool)> done);
+    bool stop(unsigned int displayId, AudioVoice voice);
+    bool pause(unsigned int displayId);
+    bool resume(unsigned int displayId);
+    const AudioMetrics* getMetrics(unsigned int displayId) const;
+    const AudioTap* getTap(unsigned int displayId) const;
+    void deInit();
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Output
+    {
+        unsigned int displayId = 0;
+        // One per voice, each voice's requests come from one queue
+        SpeechDecoder decoders[VOICE_COUNT];
+        std::thread thread;
+        AudioMetrics metrics;
+        // Written by the render thread only
+        AudioTap tap;
+
+        // Guarded by mutex, shared with the render thread
+        std::mutex mutex;
+        std::condition_variable cond;
+        AudioMixer mixer;
+        std::function<void(bool)> done[VOICE_COUNT];
+        // Sink position of a voice's last frame, known once it is mixed
+        uint64_t endFrame[VOICE_COUNT] = {};
+        // Set by play(), the first sample is counted once written
+        Clock::time_point starts[VOICE_COUNT];
+        bool firstPending[VOICE_COUNT] = {};
+        bool paused = false;
+        bool dropPending = false;
+        bool quit = false;
+        FILE *wavFile = nullptr;
+        FILE *timeline = nullptr;
+        // Frames handed to the sink and consumed by its clock
+        uint64_t written = 0;
+        uint64_t played = 0;
+
+        // Render thread only
+        bool running = false;
+        // Everything is written, waiting for the clock to play it out
+        bool draining = false;
+        Clock::time_point drainStart;
+        Clock::time_point clockStart;
+        uint64_t clockBase = 0;
+        std::vector<float> mixBuffer;
+        std::vector<int16_t> pcmBuffer;
+    };
+
+    // Completions gathered under the lock, run after it is released
+    typedef std::vector<std::pair<std::function<void(bool)>, bool>> Callbacks;
+
+    void loadConfig();
+    bool openFiles(Output& output);
+    void closeFiles(Output& output);
+    bool startPlayback(Output& output, AudioVoice voice, std::function<void(bool)> done);
+    void renderLoop(Output& output);
+    void advanceClock(Output& output, Clock::time_point now);
+    void writeFrames(Output& output, uint64_t target);
+    void writeSilence(Output& output, uint64_t frames);
+    void logEvent(Output& output, const char* event, long value);
+    static bool isBusy(const Output& output);
+    static void runCallbacks(Callbacks& finished);
+
+    const bool mRecordWav;
+    std::vector<std::unique_ptr<Output>> mOutputs;
+    bool mRealtime = true;
+    unsigned int mSampleRate;
+    unsigned int mPeriodMs;
+    unsigned int mBufferMs;
+    bool mTimeline = false;
+    std::string mDirectory;
+    float mDuckLevel = DEFAULT_DUCK_LEVEL;
+    unsigned int mDuckRampMs = DEFAULT_DUCK_RAMP_MS;
+    SilenceTrimmer mTrimmer;
+    StreamLimits mStreamLimits;
+    TapSettings mTapSettings;
+    Clock::time_point mEpoch;
+    bool mReactor = false;
+};
+
+#endif /* SRC_ENGINE_NULLAUDIOENGINE_H_ */
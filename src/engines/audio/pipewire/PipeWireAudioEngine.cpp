@@ -0,0 +1,729 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <glib.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <spa/param/audio/format-utils.h>
+#include <spa/pod/builder.h>
+#include <PipeWireAudioEngine.h>
+#include <TTSConfig.h>
+#include <TTSLog.h>
+#include <TTSUtils.h>
+#include <ThreadPolicy.h>
+
+#define TARGET_PREFIX       "tts"
+#define DEFAULT_SAMPLE_RATE 48000
+#define DEFAULT_LATENCY     256
+#define COMMAND_RING_SIZE   64
+// Each command frees at most one stream, each voice one more as it ends
+#define RELEASE_RING_SIZE   (2 * COMMAND_RING_SIZE)
+// PipeWire's default clock.max-quantum; larger buffers are mixed in parts
+#define MAX_BLOCK_FRAMES    8192
+
+static gboolean runOnMainLoop(gpointer data)
+{
+    std::unique_ptr<std::function<void()>> call(static_cast<std::function<void()>*>(data));
+    (*call)();
+    return G_SOURCE_REMOVE;
+}
+
+PipeWireAudioEngine::Output::Output() : commands(COMMAND_RING_SIZE), released(RELEASE_RING_SIZE)
+{
+    memset(&listener, 0, sizeof(listener));
+}
+
+PipeWireAudioEngine::PipeWireAudioEngine() : AudioEngine(),
+        mSampleRate(DEFAULT_SAMPLE_RATE), mQuantum(0), mLatency(DEFAULT_LATENCY)
+{
+    memset(&mStreamEvents, 0, sizeof(mStreamEvents));
+    mStreamEvents.version = PW_VERSION_STREAM_EVENTS;
+    mStreamEvents.state_changed = streamStateCallback;
+    mStreamEvents.process = streamProcessCallback;
+    mStreamEvents.drained = streamDrainedCallback;
+}
+
+PipeWireAudioEngine::~PipeWireAudioEngine()
+{
+    deInit();
+}
+
+void PipeWireAudioEngine::attachToMainLoop()
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    mReactor = true;
+}
+
+void PipeWireAudioEngine::loadConfig()
+{
+    TTSConfig config;
+    if (config.readFile() != TTSErrors::TTS_CONFIG_ERROR_NONE)
+        return;
+
+    pbnjson::JValue targets;
+    (void) config.getValue("pipewire", "targets", targets);
+    if (targets.isArray())
+    {
+        for (ssize_t i = 0; i < targets.arraySize(); i++)
+            mTargets.push_back(targets[i].asString());
+    }
+    pbnjson::JValue value;
+    (void) config.getValue("pipewire", "sampleRate", value);
+    if (value.isNumber() && value.asNumber<int>() > 0)
+        mSampleRate = value.asNumber<int>();
+    (void) config.getValue("pipewire", "latency", value);
+    if (value.isNumber() && value.asNumber<int>() > 0)
+        mLatency = value.asNumber<int>();
+    (void) config.getValue("pipewire", "quantum", value);
+    if (value.isNumber() && value.asNumber<int>() >= 0)
+        mQuantum = value.asNumber<int>();
+    LOG_DEBUG("PipeWire %u Hz, latency %u frames, quantum %u", mSampleRate, mLatency, mQuantum);
+
+    pbnjson::JValue duckLevel;
+    (void) config.getValue("mixer", "duckLevel", duckLevel);
+    if (duckLevel.isNumber())
+        mDuckLevel = duckLevel.asNumber<double>();
+    pbnjson::JValue duckRamp;
+    (void) config.getValue("mixer", "duckRampMs", duckRamp);
+    if (duckRamp.isNumber() && duckRamp.asNumber<int>() >= 0)
+        mDuckRampMs = duckRamp.asNumber<int>();
+    mStreamLimits = SpeechStream::loadLimits(config);
+    mTrimmer.loadConfig(config);
+    mTapSettings = AudioTap::loadSettings(config);
+}
+
+// Called with the thread loop locked
+bool PipeWireAudioEngine::connectCore()
+{
+    if (mCore)
+        return true;
+    if (!mContext)
+        mContext = pw_context_new(pw_thread_loop_get_loop(mLoop), nullptr, 0);
+    if (!mContext)
+    {
+        LOG_DEBUG("Error: Creating the PipeWire context failed");
+        return false;
+    }
+    mCore = pw_context_connect(mContext, nullptr, 0);
+    if (!mCore)
+    {
+        LOG_DEBUG("Error: Connecting to PipeWire failed: %s", strerror(errno));
+        return false;
+    }
+    for (auto &output : mOutputs)
+    {
+        if (!openOutput(*output))
+            LOG_DEBUG("Error: Could not open the PipeWire stream of display %u", output->displayId);
+    }
+    return true;
+}
+
+bool PipeWireAudioEngine::openOutput(Output& output)
+{
+    pw_properties *props = pw_properties_new(PW_KEY_MEDIA_TYPE, "Audio",
+            PW_KEY_MEDIA_CATEGORY, "Playback", PW_KEY_MEDIA_ROLE, "Accessibility", nullptr);
+    pw_properties_setf(props, PW_KEY_NODE_NAME, "tts-display%u", output.displayId);
+    // The node asks for this latency, the graph runs at the smallest one asked
+    pw_properties_setf(props, PW_KEY_NODE_LATENCY, "%u/%u", mLatency, mSampleRate);
+    if (mQuantum > 0)
+        pw_properties_setf(props, PW_KEY_NODE_FORCE_QUANTUM, "%u", mQuantum);
+    if (!output.target.empty())
+        pw_properties_set(props, PW_KEY_TARGET_OBJECT, output.target.c_str());
+
+    // The stream owns props from here on
+    output.stream = pw_stream_new(mCore, "tts", props);
+    if (!output.stream)
+    {
+        LOG_DEBUG("Error: Creating the stream for %s failed: %s", output.target.c_str(), strerror(errno));
+        return false;
+    }
+    pw_stream_add_listener(output.stream, &output.listener, &mStreamEvents, &output);
+
+    uint8_t buffer[1024];
+    spa_pod_builder builder;
+    spa_pod_builder_init(&builder, buffer, sizeof(buffer));
+    spa_audio_info_raw info;
+    memset(&info, 0, sizeof(info));
+    info.format = SPA_AUDIO_FORMAT_F32;
+    info.rate = mSampleRate;
+    info.channels = 1;
+    info.position[0] = SPA_AUDIO_CHANNEL_MONO;
+    const spa_pod *params[1];
+    params[0] = spa_format_audio_raw_build(&builder, SPA_PARAM_EnumFormat, &info);
+
+    // Inactive until there is something to play, so an idle output costs
+    // the graph nothing
+    int err = pw_stream_connect(output.stream, PW_DIRECTION_OUTPUT, PW_ID_ANY,
+            (pw_stream_flags) (PW_STREAM_FLAG_AUTOCONNECT | PW_STREAM_FLAG_MAP_BUFFERS
+                    | PW_STREAM_FLAG_RT_PROCESS | PW_STREAM_FLAG_INACTIVE), params, 1);
+    if (err < 0)
+    {
+        LOG_DEBUG("Error: Connecting the stream for %s failed: %s", output.target.c_str(), strerror(-err));
+        spa_hook_remove(&output.listener);
+        pw_stream_destroy(output.stream);
+        output.stream = nullptr;
+        return false;
+    }
+    output.mixer.setDucking(mDuckLevel, (size_t) mSampleRate * mDuckRampMs / 1000);
+    output.mixer.reserve(MAX_BLOCK_FRAMES);
+    LOG_DEBUG("Opened the stream for %s at %u Hz", output.target.empty() ? "the default sink" : output.target.c_str(),
+            mSampleRate);
+    return true;
+}
+
+bool PipeWireAudioEngine::play(unsigned int displayId, AudioVoice voice)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size())
+    {
+        LOG_DEBUG("Error: No audio output for display %u", displayId);
+        return false;
+    }
+    bool finished = false;
+    bool result = false;
+    std::shared_ptr<SpeechStream> stream;
+
+    // Completions run on the thread loop, which holds its lock for them
+    if (!startPlayback(*mOutputs[displayId], voice, [this, &finished, &result](bool ret) {
+        result = ret;
+        finished = true;
+        pw_thread_loop_signal(mLoop, false);
+    }, stream))
+        return false;
+    feed(std::move(stream));
+    LoopLock lock(mLoop);
+    while (!finished)
+        pw_thread_loop_wait(mLoop);
+    LOG_DEBUG("PipeWire Play is completed");
+    return result;
+}
+
+void PipeWireAudioEngine::playAsync(unsigned int displayId, AudioVoice voice, std::function<void(bool)> done)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size())
+    {
+        LOG_DEBUG("Error: No audio output for display %u", displayId);
+        done(false);
+        return;
+    }
+    std::shared_ptr<SpeechStream> stream;
+    // Completions come from the thread loop, report them on the main loop
+    if (!startPlayback(*mOutputs[displayId], voice, [done](bool ret) {
+        g_idle_add(runOnMainLoop, new std::function<void()>([done, ret] { done(ret); }));
+    }, stream))
+    {
+        done(false);
+        return;
+    }
+    feed(std::move(stream));
+}
+
+bool PipeWireAudioEngine::startPlayback(Output& output, AudioVoice voice, std::function<void(bool)> done,
+        std::shared_ptr<SpeechStream>& stream)
+{
+    if (!mLoop)
+        return false;
+    std::vector<uint8_t> data;
+    unsigned int slot = TTSUtils::getVoiceSlot(output.displayId, voice, mOutputs.size());
+    Clock::time_point start = Clock::now();
+    if (!SpeechDecoder::readFile(TTSUtils::getAudioFilePath(slot), data))
+        return false;
+    output.metrics.fileRead.record(AudioMetrics::elapsedUs(start));
+    output.metrics.utterances++;
+    // Decoded before taking the lock, the thread loop never waits on it
+    std::vector<float> samples;
+    if (!output.decoders[voice].decode(data.data(), data.size(), mSampleRate, samples))
+        return false;
+    output.metrics.trimmedMs += output.decoders[voice].getTrimmedMs();
+    // Prefilled to the high watermark before the data thread sees it
+    stream = std::make_shared<SpeechStream>(std::move(samples), mStreamLimits, mSampleRate);
+    (void) stream->feed();
+
+    LoopLock lock(mLoop);
+    disposeReleased(output);
+    if (!connectCore())
+        return false;
+    if (!output.stream && !openOutput(output))
+        return false;
+    if (output.done[voice])
+    {
+        LOG_DEBUG("Error: Display %u voice %d is already playing", output.displayId, (int) voice);
+        return false;
+    }
+
+    Command command;
+    command.type = Command::SET_VOICE;
+    command.voice = voice;
+    command.serial = output.serials[voice] + 1;
+    command.stream = stream;
+    command.start = start;
+    if (output.commands.push(&command, 1) != 1)
+    {
+        LOG_DEBUG("Error: Command ring of display %u is full", output.displayId);
+        return false;
+    }
+    // New audio follows what is queued, so the drain is not waited for
+    if (output.draining)
+    {
+        output.draining = false;
+        finishWritten(output);
+    }
+    output.serials[voice] = command.serial;
+    output.written[voice] = false;
+    output.streams[voice] = stream;
+    output.done[voice] = std::move(done);
+    if (!output.paused)
+        (void) pw_stream_set_active(output.stream, true);
+    return true;
+}
+
+void PipeWireAudioEngine::feed(std::shared_ptr<SpeechStream> stream)
+{
+    // The rest follows as the data thread drains the ring
+    if (mReactor)
+        SpeechStream::feedOnMainLoop(std::move(stream));
+    else
+        while (!stream->feed() && stream->waitForSpace())
+            ;
+}
+
+void PipeWireAudioEngine::finishVoice(Output& output, AudioVoice voice, bool result)
+{
+    std::function<void(bool)> done = std::move(output.done[voice]);
+    output.done[voice] = nullptr;
+    output.written[voice] = false;
+    std::shared_ptr<SpeechStream> stream = std::move(output.streams[voice]);
+    output.streams[voice] = nullptr;
+    if (stream && stream->getUnderruns() > 0)
+    {
+        output.metrics.streamUnderruns += stream->getUnderruns();
+        LOG_INFO("tts:audio:pipewire", 0, "Display %u stream underran %lu times", output.displayId,
+                stream->getUnderruns());
+    }
+    if (done)
+        done(result);
+}
+
+void PipeWireAudioEngine::finishAll(Output& output, bool result)
+{
+    for (unsigned int voice = 0; voice < VOICE_COUNT; voice++)
+    {
+        if (output.done[voice])
+            finishVoice(output, (AudioVoice) voice, result);
+    }
+}
+
+void PipeWireAudioEngine::finishWritten(Output& output)
+{
+    for (unsigned int voice = 0; voice < VOICE_COUNT; voice++)
+    {
+        if (output.done[voice] && output.written[voice])
+            finishVoice(output, (AudioVoice) voice, true);
+    }
+}
+
+bool PipeWireAudioEngine::isBusy(const Output& output)
+{
+    for (const auto &done : output.done)
+    {
+        if (done)
+            return true;
+    }
+    return false;
+}
+
+// Thread loop, with its lock held
+void PipeWireAudioEngine::disposeReleased(Output& output)
+{
+    std::shared_ptr<SpeechStream> stream;
+    while (output.released.pop(&stream, 1) == 1)
+        stream.reset();
+}
+
+// Data thread: the thread loop may already have dropped its reference, so
+// the last one is handed over rather than dropped here
+void PipeWireAudioEngine::releaseStream(Output& output, std::shared_ptr<SpeechStream> stream)
+{
+    // Full only if the thread loop stalled, the stream is then freed here
+    if (stream)
+        (void) output.released.push(&stream, 1);
+}
+
+// Data thread, must not block
+void PipeWireAudioEngine::runCommands(Output& output)
+{
+    Command command;
+    while (output.commands.pop(&command, 1) == 1)
+    {
+        unsigned int voice = command.voice;
+        releaseStream(output, output.mixer.releaseVoice(command.voice));
+        if (command.type == Command::SET_VOICE)
+        {
+            output.mixer.setVoice(command.voice, std::move(command.stream));
+            output.active[voice] = true;
+            output.firstPending[voice] = true;
+            output.mixSerials[voice] = command.serial;
+            output.starts[voice] = command.start;
+        }
+        else
+        {
+            output.active[voice] = false;
+            output.firstPending[voice] = false;
+        }
+    }
+}
+
+void PipeWireAudioEngine::streamProcessCallback(void* userdata)
+{
+    Output &output = *static_cast<Output*>(userdata);
+    Report report;
+    memset(&report, 0, sizeof(report));
+    // PipeWire schedules its data thread itself, only the CPU set is ours;
+    // the thread loop applies it
+    if (!output.pinned)
+    {
+        output.pinned = true;
+        report.tid = (int32_t) syscall(SYS_gettid);
+    }
+    runCommands(output);
+
+    // Nothing is queued while idle, so a drain can complete
+    bool mixing = output.mixer.isActive();
+    int64_t delayUs = 0;
+    if (mixing)
+    {
+        // What is queued this cycle is heard once the graph delay has passed
+        pw_time time;
+        bool timed = pw_stream_get_time_n(output.stream, &time, sizeof(time)) == 0 && time.rate.denom > 0;
+        if (timed)
+            delayUs = std::max<int64_t>(time.delay * 1000000 * time.rate.num / time.rate.denom, 0);
+
+        Clock::time_point writeStart = Clock::now();
+        pw_buffer *buffer = pw_stream_dequeue_buffer(output.stream);
+        if (!buffer)
+            return;
+        spa_data &data = buffer->buffer->datas[0];
+        float *dst = static_cast<float*>(data.data);
+        uint32_t frames = 0;
+        if (dst)
+        {
+            frames = data.maxsize / sizeof(float);
+            if (buffer->requested > 0)
+                frames = std::min<uint64_t>(frames, buffer->requested);
+            size_t mixed = output.mixer.mix(dst, frames);
+            std::fill(dst + mixed, dst + frames, 0.0f);
+            if (output.tap.isOpen())
+            {
+                // Stamped on the graph's clock, the cycle's own CLOCK_MONOTONIC time
+                if (timed)
+                    output.tap.stamp(time.now + delayUs * 1000);
+                output.tap.write(dst, frames);
+            }
+        }
+        data.chunk->offset = 0;
+        data.chunk->stride = sizeof(float);
+        data.chunk->size = frames * sizeof(float);
+        (void) pw_stream_queue_buffer(output.stream, buffer);
+        output.metrics.writeStall.record(AudioMetrics::elapsedUs(writeStart));
+        output.metrics.latency.record(delayUs);
+    }
+
+    for (unsigned int voice = 0; voice < VOICE_COUNT; voice++)
+    {
+        report.serials[voice] = output.mixSerials[voice];
+        if (mixing && output.firstPending[voice])
+        {
+            output.firstPending[voice] = false;
+            report.started |= 1u << voice;
+            report.firstSampleUs[voice] = std::chrono::duration_cast<std::chrono::microseconds>(
+                    Clock::now() - output.starts[voice]).count() + delayUs;
+        }
+        if (output.active[voice] && !output.mixer.isActive((AudioVoice) voice))
+        {
+            output.active[voice] = false;
+            output.firstPending[voice] = false;
+            releaseStream(output, output.mixer.releaseVoice((AudioVoice) voice));
+            report.ended |= 1u << voice;
+        }
+    }
+    report.idle = !output.mixer.isActive();
+    if (report.started || report.ended || report.tid)
+    {
+        // Copied into the loop's queue, never waits for the thread loop
+        (void) pw_loop_invoke(pw_thread_loop_get_loop(output.engine->mLoop), reportCallback, 0,
+                &report, sizeof(report), false, &output);
+    }
+}
+
+int PipeWireAudioEngine::reportCallback(spa_loop* loop, bool async, uint32_t seq, const void* data,
+        size_t size, void* userdata)
+{
+    Output &output = *static_cast<Output*>(userdata);
+    Report report;
+    if (size != sizeof(report))
+        return -EINVAL;
+    memcpy(&report, data, sizeof(report));
+    output.engine->handleReport(output, report);
+    return 0;
+}
+
+// Thread loop, with its lock held
+void PipeWireAudioEngine::handleReport(Output& output, const Report& report)
+{
+    if (report.tid)
+        ThreadPolicy::get().applyAffinity(THREAD_RENDER, report.tid);
+    disposeReleased(output);
+    for (unsigned int voice = 0; voice < VOICE_COUNT; voice++)
+    {
+        // Stopped or replaced since the data thread wrote it
+        if (!output.done[voice] || report.serials[voice] != output.serials[voice])
+            continue;
+        if (report.started & (1u << voice))
+        {
+            int64_t us = report.firstSampleUs[voice];
+            output.metrics.firstSample.record(us);
+            LOG_INFO("tts:audio:pipewire", 0, "Display %u voice %u first sample after %lld us",
+                    output.displayId, voice, (long long) us);
+        }
+        if (report.ended & (1u << voice))
+        {
+            // A voice that ended under another one is done once written
+            if (!report.idle)
+                finishVoice(output, (AudioVoice) voice, true);
+            else
+                output.written[voice] = true;
+        }
+    }
+    if (!report.idle || !isBusy(output) || output.draining)
+        return;
+
+    for (unsigned int voice = 0; voice < VOICE_COUNT; voice++)
+    {
+        // Another voice is on its way, what is written plays ahead of it
+        if (output.done[voice] && !output.written[voice])
+        {
+            finishWritten(output);
+            return;
+        }
+    }
+    output.draining = true;
+    output.drainStart = Clock::now();
+    (void) pw_stream_flush(output.stream, true);
+}
+
+void PipeWireAudioEngine::streamDrainedCallback(void* userdata)
+{
+    Output &output = *static_cast<Output*>(userdata);
+    if (!output.draining)
+        return;
+    output.draining = false;
+    output.metrics.drain.record(AudioMetrics::elapsedUs(output.drainStart));
+    (void) pw_stream_set_active(output.stream, false);
+    output.engine->finishAll(output, true);
+}
+
+void PipeWireAudioEngine::streamStateCallback(void* userdata, pw_stream_state old, pw_stream_state state,
+        const char* error)
+{
+    Output &output = *static_cast<Output*>(userdata);
+    LOG_DEBUG("Display %u stream %s -> %s", output.displayId, pw_stream_state_as_string(old),
+            pw_stream_state_as_string(state));
+    if (state == PW_STREAM_STATE_ERROR)
+    {
+        LOG_DEBUG("Error: Display %u stream failed: %s", output.displayId, error ? error : "unknown");
+        output.draining = false;
+        output.engine->finishAll(output, false);
+    }
+}
+
+bool PipeWireAudioEngine::stop(unsigned int displayId, AudioVoice voice)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size() || !mLoop)
+        return true;
+    Output &output = *mOutputs[displayId];
+    LoopLock lock(mLoop);
+    disposeReleased(output);
+    if (!output.done[voice])
+    {
+        // A pause taken during synthesis ends with the utterance
+        if (!isBusy(output))
+            output.paused = false;
+        return true;
+    }
+    LOG_INFO("tts:audio:pipewire", 0, "INFO: Got Stop Command While Playing ");
+    Command command;
+    command.type = Command::CLEAR_VOICE;
+    command.voice = voice;
+    if (output.commands.push(&command, 1) != 1)
+        LOG_DEBUG("Error: Command ring of display %u is full", output.displayId);
+    if (output.streams[voice])
+        output.streams[voice]->abort();
+    // Reports still on their way no longer match
+    output.serials[voice]++;
+    // Completions always run under the lock, play() waits on it
+    finishVoice(output, voice, true);
+    // Drop what the graph still holds unless another voice is in it
+    if (!isBusy(output))
+    {
+        output.draining = false;
+        output.paused = false;
+        if (output.stream)
+        {
+            (void) pw_stream_flush(output.stream, false);
+            (void) pw_stream_set_active(output.stream, false);
+        }
+    }
+    return true;
+}
+
+bool PipeWireAudioEngine::pause(unsigned int displayId)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size() || !mLoop)
+        return false;
+    Output &output = *mOutputs[displayId];
+    {
+        LoopLock lock(mLoop);
+        if (output.paused)
+            return false;
+        output.paused = true;
+        if (output.stream)
+            (void) pw_stream_set_active(output.stream, false);
+    }
+    LOG_INFO("tts:audio:pipewire", 0, "Display %u paused", displayId);
+    return true;
+}
+
+bool PipeWireAudioEngine::resume(unsigned int displayId)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size() || !mLoop)
+        return false;
+    Output &output = *mOutputs[displayId];
+    {
+        LoopLock lock(mLoop);
+        if (!output.paused)
+            return false;
+        output.paused = false;
+        if (output.stream && isBusy(output))
+            (void) pw_stream_set_active(output.stream, true);
+    }
+    LOG_INFO("tts:audio:pipewire", 0, "Display %u resumed", displayId);
+    return true;
+}
+
+const AudioMetrics* PipeWireAudioEngine::getMetrics(unsigned int displayId) const
+{
+    return (displayId < mOutputs.size()) ? &mOutputs[displayId]->metrics : nullptr;
+}
+
+const AudioTap* PipeWireAudioEngine::getTap(unsigned int displayId) const
+{
+    return (displayId < mOutputs.size()) ? &mOutputs[displayId]->tap : nullptr;
+}
+
+void PipeWireAudioEngine::init(unsigned int displayCount)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    loadConfig();
+    // Read here rather than on the data thread
+    (void) ThreadPolicy::get();
+    if (!mLoop)
+    {
+        pw_init(nullptr, nullptr);
+        mLoop = pw_thread_loop_new("tts-pipewire", nullptr);
+        if (!mLoop || pw_thread_loop_start(mLoop) < 0)
+        {
+            LOG_DEBUG("Error: Starting the PipeWire thread loop failed");
+            if (mLoop)
+                pw_thread_loop_destroy(mLoop);
+            mLoop = nullptr;
+            pw_deinit();
+            return;
+        }
+    }
+
+    LoopLock lock(mLoop);
+    for (unsigned int displayId = mOutputs.size(); displayId < displayCount; displayId++)
+    {
+        std::unique_ptr<Output> output(new Output);
+        output->engine = this;
+        output->displayId = displayId;
+        for (auto &decoder : output->decoders)
+            decoder.setTrimmer(mTrimmer);
+        // Same nodes the pulse engine plays to, an empty name is the default sink
+        if (displayId < mTargets.size())
+            output->target = mTargets[displayId];
+        else
+            output->target = TARGET_PREFIX + std::to_string(displayId + 1);
+        if (mTapSettings.enabled)
+            (void) output->tap.open("tts-tap-" + std::to_string(displayId), mSampleRate, mTapSettings.capacityMs);
+        if (mCore && !openOutput(*output))
+            LOG_DEBUG("Error: Could not open the PipeWire stream of display %u", displayId);
+        mOutputs.push_back(std::move(output));
+    }
+    if (!connectCore())
+        LOG_DEBUG("Error: Could not connect to PipeWire, retrying on play");
+}
+
+void PipeWireAudioEngine::deInit()
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (mLoop)
+    {
+        {
+            LoopLock lock(mLoop);
+            for (auto &output : mOutputs)
+            {
+                for (auto &done : output->done)
+                    done = nullptr;
+                for (auto &stream : output->streams)
+                {
+                    if (stream)
+                        stream->abort();
+                    stream = nullptr;
+                }
+                if (output->stream)
+                {
+                    spa_hook_remove(&output->listener);
+                    pw_stream_destroy(output->stream);
+                    output->stream = nullptr;
+                }
+            }
+            if (mCore)
+            {
+                pw_core_disconnect(mCore);
+                mCore = nullptr;
+            }
+        }
+        pw_thread_loop_stop(mLoop);
+        if (mContext)
+        {
+            pw_context_destroy(mContext);
+            mContext = nullptr;
+        }
+        pw_thread_loop_destroy(mLoop);
+        mLoop = nullptr;
+        pw_deinit();
+    }
+    mOutputs.clear();
+}
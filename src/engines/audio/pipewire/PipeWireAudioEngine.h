@@ -0,0 +1,176 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef SRC_ENGINE_PIPEWIREAUDIOENGINE_H_
+#define SRC_ENGINE_PIPEWIREAUDIOENGINE_H_
+
+#include <pipewire/pipewire.h>
+#include <AudioEngine.h>
+#include <AudioEngineFactory.h>
+#include <AudioMixer.h>
+#include <SPSCRing.h>
+#include <SilenceTrimmer.h>
+#include <SpeechDecoder.h>
+#include <SpeechStream.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Plays through native PipeWire streams, one per output, without the
+// pulse compatibility layer. The process callback runs on PipeWire's
+// realtime data thread and only touches lock-free state: voices reach it
+// through a command ring, and what it has written is reported back to the
+// thread loop with non-blocking invokes. It neither allocates nor frees,
+// streams it is done with go back to the thread loop.
+class PipeWireAudioEngine: public AudioEngine
+{
+public:
+    PipeWireAudioEngine();
+    virtual ~PipeWireAudioEngine();
+    void init(unsigned int displayCount);
+    void attachToMainLoop();
+    bool play(unsigned int displayId, AudioVoice voice);
+    void playAsync(unsigned int displayId, AudioVoice voice, std::function<void(bool)> done);
+    bool stop(unsigned int displayId, AudioVoice voice);
+    bool pause(unsigned int displayId);
+    bool resume(unsigned int displayId);
+    const AudioMetrics* getMetrics(unsigned int displayId) const;
+    const AudioTap* getTap(unsigned int displayId) const;
+    void deInit();
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    // Thread loop to data thread
+    struct Command
+    {
+        enum Type { SET_VOICE, CLEAR_VOICE } type = CLEAR_VOICE;
+        AudioVoice voice = VOICE_SPEECH;
+        uint32_t serial = 0;
+        std::shared_ptr<SpeechStream> stream;
+        Clock::time_point start;
+    };
+
+    // Data thread to thread loop, copied by the invoke
+    struct Report
+    {
+        // Voices whose last sample was written, or first one queued
+        uint32_t ended;
+        uint32_t started;
+        // Nothing left to mix after this cycle
+        bool idle;
+        // Set once, the thread loop pins the data thread
+        int32_t tid;
+        uint32_t serials[VOICE_COUNT];
+        int64_t firstSampleUs[VOICE_COUNT];
+    };
+
+    struct Output
+    {
+        PipeWireAudioEngine *engine = nullptr;
+        unsigned int displayId = 0;
+        std::string target;
+        pw_stream *stream = nullptr;
+        spa_hook listener;
+        // One per voice, each voice's requests come from one queue
+        SpeechDecoder decoders[VOICE_COUNT];
+        // Recorded from both threads, read from anywhere
+        AudioMetrics metrics;
+        // Written by the data thread only
+        AudioTap tap;
+
+        // Guarded by the thread loop lock
+        std::function<void(bool)> done[VOICE_COUNT];
+        std::shared_ptr<SpeechStream> streams[VOICE_COUNT];
+        uint32_t serials[VOICE_COUNT] = {};
+        // All of the voice is queued, it ends with the drain
+        bool written[VOICE_COUNT] = {};
+        bool paused = false;
+        // Everything is queued, waiting for the drained event
+        bool draining = false;
+        Clock::time_point drainStart;
+        // Pushed under the thread loop lock, popped by the data thread
+        SPSCRing<Command> commands;
+        // Pushed by the data thread, dropped under the thread loop lock
+        SPSCRing<std::shared_ptr<SpeechStream>> released;
+
+        // Data thread only
+        AudioMixer mixer;
+        bool active[VOICE_COUNT] = {};
+        bool firstPending[VOICE_COUNT] = {};
+        uint32_t mixSerials[VOICE_COUNT] = {};
+        Clock::time_point starts[VOICE_COUNT];
+        bool pinned = false;
+
+        Output();
+    };
+
+    class LoopLock
+    {
+    public:
+        explicit LoopLock(pw_thread_loop* loop) : mLoop(loop)
+        {
+            pw_thread_loop_lock(mLoop);
+        }
+        ~LoopLock()
+        {
+            pw_thread_loop_unlock(mLoop);
+        }
+    private:
+        pw_thread_loop *mLoop;
+    };
+
+    void loadConfig();
+    bool connectCore();
+    bool openOutput(Output& output);
+    bool startPlayback(Output& output, AudioVoice voice, std::function<void(bool)> done,
+            std::shared_ptr<SpeechStream>& stream);
+    void feed(std::shared_ptr<SpeechStream> stream);
+    void finishVoice(Output& output, AudioVoice voice, bool result);
+    void finishAll(Output& output, bool result);
+    void finishWritten(Output& output);
+    static bool isBusy(const Output& output);
+    void handleReport(Output& output, const Report& report);
+    static void disposeReleased(Output& output);
+    static void releaseStream(Output& output, std::shared_ptr<SpeechStream> stream);
+    static void runCommands(Output& output);
+    static void streamStateCallback(void* userdata, pw_stream_state old, pw_stream_state state, const char* error);
+    static void streamProcessCallback(void* userdata);
+    static void streamDrainedCallback(void* userdata);
+    static int reportCallback(spa_loop* loop, bool async, uint32_t seq, const void* data,
+            size_t size, void* userdata);
+
+    std::vector<std::unique_ptr<Output>> mOutputs;
+    pw_thread_loop *mLoop = nullptr;
+    pw_context *mContext = nullptr;
+    pw_core *mCore = nullptr;
+    pw_stream_events mStreamEvents;
+    std::vector<std::string> mTargets;
+    unsigned int mSampleRate;
+    unsigned int mQuantum;
+    unsigned int mLatency;
+    float mDuckLevel = DEFAULT_DUCK_LEVEL;
+    unsigned int mDuckRampMs = DEFAULT_DUCK_RAMP_MS;
+    StreamLimits mStreamLimits;
+    SilenceTrimmer mTrimmer;
+    TapSettings mTapSettings;
+    bool mReactor = false;
+};
+
+#endif /* SRC_ENGINE_PIPEWIREAUDIOENGINE_H_ */
@@ -14,250 +14,911 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
 #include <iostream>
+#include <fstream>
+#include <iterator>
 #include <errno.h>
-#include <fcntl.h>
 #include <string.h>
-#include <stdio.h>
-#include <pulse/error.h>
-#include <unistd.h>
 #include <AudioEngine.h>
+#include <DspKernels.h>
 #include <PulseAudioEngine.h>
+#include <TTSConfig.h>
 #include <TTSLog.h>
+#include <TTSUtils.h>
+#include <ThreadPolicy.h>
 
-#define BUFSIZE         1024
-#define AUDIO_FILE_1    "/tmp/sttsResultOne.pcm"
-#define AUDIO_FILE_2    "/tmp/sttsResultTwo.pcm"
+#define SINK_NAME_PREFIX "tts"
+#define CLIENT_NAME      "tts"
+#define DEFAULT_LATENCY_PROFILE "balanced"
+// A gapless stream nobody continued gets no gap silence after this
+#define GAPLESS_IDLE_TIMEOUT_MS 500
+// Shortest wait before checking the played out position again
+#define PLAYED_OUT_MIN_WAIT_USEC (5 * PA_USEC_PER_MSEC)
 
+// Stream format until the sink is known
 static pa_sample_spec sample_spec =
 {
     .format = PA_SAMPLE_S16LE,
-    .rate = 22050,
+    .rate = RAW_PCM_RATE,
     .channels = 1
 };
 
-PulseAudioEngine::PulseAudioEngine() : AudioEngine(), mIsStopPlaytts1(false), mIsStopPlaytts2(false), mSimpletts1(nullptr), mSimpletts2(nullptr)
+// Built in profiles, pulse.latencyProfiles in the config may override them
+static const struct
 {
+    const char *name;
+    unsigned int tlengthMs;
+    unsigned int prebufMs;
+    unsigned int minreqMs;
+} latencyProfiles[] =
+{
+    { "low-latency", 40, 20, 10 },
+    { "balanced", 200, 100, 50 },
+    { "power-save", 2000, 1000, 500 },
+};
 
+static void applyRenderPolicy(pa_mainloop_api* api, void* userdata)
+{
+    ThreadPolicy::get().apply(THREAD_RENDER);
 }
 
-void PulseAudioEngine::resume()
+PulseAudioEngine::PulseAudioEngine() : AudioEngine()
 {
+    mLatencyProfile = { DEFAULT_LATENCY_PROFILE, 200, 100, 50 };
+}
 
+PulseAudioEngine::~PulseAudioEngine()
+{
+    deInit();
 }
 
-void PulseAudioEngine::pause()
+bool PulseAudioEngine::pause(unsigned int displayId)
 {
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size())
+        return false;
+    Output &output = *mOutputs[displayId];
 
+    MainloopLock lock(mThreadedMainloop);
+    if (output.paused)
+        return false;
+    output.paused = true;
+    // The mixer position and the server's buffer survive the cork
+    if (output.stream && pa_stream_get_state(output.stream) == PA_STREAM_READY)
+        operationDone(pa_stream_cork(output.stream, 1, nullptr, nullptr));
+    LOG_INFO("tts:audio:pulse", 0, "%s paused", output.sinkName.c_str());
+    return true;
 }
 
-bool PulseAudioEngine::play(unsigned int displayId)
+bool PulseAudioEngine::resume(unsigned int displayId)
 {
-    std::string audio_file;
     LOG_TRACE("Entering function %s", __FUNCTION__);
-    if (mIsStopPlaytts1){
-        mIsStopPlaytts1 = false;
+    if (displayId >= mOutputs.size())
+        return false;
+    Output &output = *mOutputs[displayId];
+
+    MainloopLock lock(mThreadedMainloop);
+    if (!output.paused)
+        return false;
+    output.paused = false;
+    // Whatever is buffered plays at once, the write callback refills it
+    if (output.stream && pa_stream_get_state(output.stream) == PA_STREAM_READY
+            && (output.mixer.isActive() || output.drainOp || output.playedTimer))
+        operationDone(pa_stream_cork(output.stream, 0, nullptr, nullptr));
+    LOG_INFO("tts:audio:pulse", 0, "%s resumed", output.sinkName.c_str());
+    return true;
+}
+
+void PulseAudioEngine::attachToMainLoop()
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    mReactor = true;
+}
+
+void PulseAudioEngine::loadConfig()
+{
+    TTSConfig config;
+    if (config.readFile() != TTSErrors::TTS_CONFIG_ERROR_NONE)
+        return;
+
+    pbnjson::JValue gapless;
+    (void) config.getValue("pulse", "gapless", gapless);
+    mGapless = gapless.isBoolean() && gapless.asBool();
+    pbnjson::JValue gapSilence;
+    (void) config.getValue("pulse", "gapSilenceMs", gapSilence);
+    if (gapSilence.isNumber() && gapSilence.asNumber<int>() > 0)
+        mGapSilenceMs = gapSilence.asNumber<int>();
+    LOG_DEBUG("Gapless playback %s, gap %u ms", mGapless ? "on" : "off", mGapSilenceMs);
+
+    pbnjson::JValue duckLevel;
+    (void) config.getValue("mixer", "duckLevel", duckLevel);
+    if (duckLevel.isNumber())
+        mDuckLevel = duckLevel.asNumber<double>();
+    pbnjson::JValue duckRamp;
+    (void) config.getValue("mixer", "duckRampMs", duckRamp);
+    if (duckRamp.isNumber() && duckRamp.asNumber<int>() >= 0)
+        mDuckRampMs = duckRamp.asNumber<int>();
+    LOG_DEBUG("Ducking to %.2f over %u ms", mDuckLevel, mDuckRampMs);
+    mTrimmer.loadConfig(config);
+    mTapSettings = AudioTap::loadSettings(config);
+
+    pbnjson::JValue name;
+    (void) config.getValue("pulse", "latencyProfile", name);
+    if (name.isString())
+        mLatencyProfile.name = name.asString();
+
+    bool found = false;
+    for (const auto &profile : latencyProfiles)
+    {
+        if (mLatencyProfile.name == profile.name)
+        {
+            mLatencyProfile = { profile.name, profile.tlengthMs, profile.prebufMs, profile.minreqMs };
+            found = true;
+        }
     }
-    if (mIsStopPlaytts2){
-        mIsStopPlaytts2 = false;
+    pbnjson::JValue custom;
+    (void) config.getValue("pulse", "latencyProfiles", custom);
+    if (custom.isObject() && custom.hasKey(mLatencyProfile.name))
+    {
+        pbnjson::JValue profile = custom[mLatencyProfile.name];
+        if (profile["tlengthMs"].isNumber())
+            mLatencyProfile.tlengthMs = profile["tlengthMs"].asNumber<int>();
+        if (profile["prebufMs"].isNumber())
+            mLatencyProfile.prebufMs = profile["prebufMs"].asNumber<int>();
+        if (profile["minreqMs"].isNumber())
+            mLatencyProfile.minreqMs = profile["minreqMs"].asNumber<int>();
+        found = true;
+    }
+    if (!found)
+    {
+        LOG_DEBUG("Unknown latency profile %s, using %s", mLatencyProfile.name.c_str(), DEFAULT_LATENCY_PROFILE);
+        mLatencyProfile = { DEFAULT_LATENCY_PROFILE, 200, 100, 50 };
     }
+    LOG_DEBUG("Latency profile %s: tlength %u ms prebuf %u ms minreq %u ms", mLatencyProfile.name.c_str(),
+            mLatencyProfile.tlengthMs, mLatencyProfile.prebufMs, mLatencyProfile.minreqMs);
+}
+
+pa_buffer_attr PulseAudioEngine::getBufferAttr(const pa_sample_spec& spec) const
+{
+    pa_buffer_attr attr;
+    attr.maxlength = (uint32_t) -1;
+    attr.tlength = pa_usec_to_bytes(mLatencyProfile.tlengthMs * PA_USEC_PER_MSEC, &spec);
+    attr.prebuf = pa_usec_to_bytes(mLatencyProfile.prebufMs * PA_USEC_PER_MSEC, &spec);
+    attr.minreq = pa_usec_to_bytes(mLatencyProfile.minreqMs * PA_USEC_PER_MSEC, &spec);
+    attr.fragsize = (uint32_t) -1;
+    return attr;
+}
 
-    if (displayId)
+// Turns the synthesized file into float samples at the stream rate and
+// hands them to the mixer
+bool PulseAudioEngine::prepareAudio(Output& output, AudioVoice voice)
+{
+    std::vector<uint8_t> &data = output.voices[voice].data;
+    // The gap only separates consecutive utterances of the speech voice
+    size_t silence = 0;
+    if (voice == VOICE_SPEECH && output.streaming && mGapSilenceMs > 0)
+        silence = (size_t) output.spec.rate * mGapSilenceMs / 1000;
+    std::vector<float> samples;
+    bool ret = output.decoder.decode(data.data(), data.size(), output.spec.rate, samples, silence);
+    std::vector<uint8_t>().swap(data);
+    if (!ret)
+        return false;
+    output.metrics.trimmedMs += output.decoder.getTrimmedMs();
+    output.mixer.setVoice(voice, std::move(samples));
+    output.voices[voice].firstPending = true;
+    return true;
+}
+
+bool PulseAudioEngine::play(unsigned int displayId, AudioVoice voice)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size() || !mThreadedMainloop)
     {
-        if (playAudiotts2(AUDIO_FILE_2))
-            return true;
+        LOG_DEBUG("Error: No audio output for display %u", displayId);
+        return false;
     }
-    else
+    Output &output = *mOutputs[displayId];
+    bool finished = false;
+    bool result = false;
+
+    MainloopLock lock(mThreadedMainloop);
+    if (!startPlayback(output, voice, [this, &finished, &result](bool ret) {
+        result = ret;
+        finished = true;
+        pa_threaded_mainloop_signal(mThreadedMainloop, 0);
+    }))
+        return false;
+    while (!finished)
+        pa_threaded_mainloop_wait(mThreadedMainloop);
+    LOG_DEBUG("PulseAudio Play is completed");
+    return result;
+}
+
+void PulseAudioEngine::playAsync(unsigned int displayId, AudioVoice voice,
+        std::function<void(bool)> done)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size() || !mGlibMainloop)
     {
-        if (playAudiotts1(AUDIO_FILE_1))
-            return true;
+        LOG_DEBUG("Error: No audio output for display %u", displayId);
+        done(false);
+        return;
     }
-    return true;
+    if (!startPlayback(*mOutputs[displayId], voice, done))
+        done(false);
 }
-bool PulseAudioEngine::playAudiotts1(std::string audio_file)
+
+bool PulseAudioEngine::startPlayback(Output& output, AudioVoice voice, std::function<void(bool)> done)
 {
-    int fd;
-    int error;
-    bool retVal = true;
-    LOG_DEBUG("Entering function : PulseAudioEngine::playAudiotts1");
-    if ((fd = open(audio_file.c_str(), O_RDONLY)) < 0)
+    Voice &v = output.voices[voice];
+    if (v.done)
     {
-        LOG_DEBUG("Error: File opening failed: %s", strerror(errno));
-        retVal= false;
+        LOG_DEBUG("Error: %s voice %d is already playing", output.sinkName.c_str(), (int) voice);
+        return false;
     }
-    else
+
+    AudioMetrics::Clock::time_point start = AudioMetrics::Clock::now();
+    unsigned int slot = TTSUtils::getVoiceSlot(output.displayId, voice, mOutputs.size());
+    if (!SpeechDecoder::readFile(TTSUtils::getAudioFilePath(slot), v.data))
+        return false;
+    output.metrics.fileRead.record(AudioMetrics::elapsedUs(start));
+    output.metrics.utterances++;
+    // Continue a kept stream, the gap goes in front of this utterance
+    cancelIdleTimer(output);
+
+    if (!connectContext())
     {
-        LOG_DEBUG("PulseAudioEngine::play : audio_file name =  %s", audio_file.c_str());
-        if (!(mSimpletts1 = pa_simple_new(NULL, audio_file.c_str(), PA_STREAM_PLAYBACK, "tts1", "playback", &sample_spec, NULL, NULL, &error)))
+        v.data.clear();
+        return false;
+    }
+    v.done = std::move(done);
+    v.pending = true;
+    v.start = start;
+    resumePending();
+    return true;
+}
+
+// Starts every playback whose context and stream are ready by now
+void PulseAudioEngine::resumePending()
+{
+    if (!mContext || pa_context_get_state(mContext) != PA_CONTEXT_READY)
+        return;
+
+    for (auto &output : mOutputs)
+    {
+        bool pending = false;
+        for (const Voice &v : output->voices)
+            pending = pending || v.pending;
+        if (!pending)
+            continue;
+        if (!output->stream)
         {
-           LOG_DEBUG("Error: Playback stream creation failed: %s", pa_strerror(error));
-           (void)close(fd);
-           retVal = false;
+            if (!openOutput(*output))
+                finishPlayback(*output, false);
+            continue;
         }
-        else
+        if (pa_stream_get_state(output->stream) != PA_STREAM_READY)
+            continue;
+
+        for (unsigned int voice = 0; voice < VOICE_COUNT; voice++)
         {
-            uint8_t buf[BUFSIZE];
-            ssize_t rSize;
-            do
-            {
-                // Read the data
-                if ((rSize = read(fd, buf, sizeof(buf))) <= 0)
-                {
-                    if (rSize == 0) // EOF
-                       break;
-                }
-                if (true == mIsStopPlaytts1)
-                {
-                    LOG_INFO("tts:audio:pulse", 0, "INFO: Got Stop Command While Playing ");
-                    break;
-                }
-
-                // Play the data
-                if (pa_simple_write(mSimpletts1, buf, (size_t) rSize, &error) < 0)
-                {
-                    LOG_DEBUG("Error: Data playing failed: %s", pa_strerror(error));
-                    (void)close(fd);
-                    retVal = false;
-                    break;
-                }
-            }while(rSize != 0);
+            Voice &v = output->voices[voice];
+            if (!v.pending)
+                continue;
+            v.pending = false;
+            if (!prepareAudio(*output, (AudioVoice) voice))
+                finishVoice(*output, (AudioVoice) voice, false);
         }
-        if(retVal)
+        if (!output->mixer.isActive())
+            continue;
+        // A paused output still buffers, it starts on resume()
+        if (!output->paused)
+            operationDone(pa_stream_cork(output->stream, 0, nullptr, nullptr));
+        // The server may have asked for data while corked and idle
+        size_t writable = pa_stream_writable_size(output->stream);
+        if (writable > 0 && writable != (size_t) -1)
+            writeData(*output, writable);
+    }
+}
+
+bool PulseAudioEngine::connectContext()
+{
+    if (mContext)
+        return true;
+
+    pa_mainloop_api *api = nullptr;
+    if (mReactor)
+    {
+        if (!mGlibMainloop)
+            mGlibMainloop = pa_glib_mainloop_new(nullptr);
+        if (mGlibMainloop)
+            api = pa_glib_mainloop_get_api(mGlibMainloop);
+    }
+    else if (mThreadedMainloop)
+    {
+        api = pa_threaded_mainloop_get_api(mThreadedMainloop);
+    }
+    if (!api)
+        return false;
+
+    mApi = api;
+    mContext = pa_context_new(api, CLIENT_NAME);
+    if (!mContext)
+        return false;
+    pa_context_set_state_callback(mContext, contextStateCallback, this);
+    if (pa_context_connect(mContext, nullptr, PA_CONTEXT_NOFLAGS, nullptr) < 0)
+    {
+        LOG_DEBUG("Error: Context connection failed: %s", pa_strerror(pa_context_errno(mContext)));
+        pa_context_unref(mContext);
+        mContext = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void PulseAudioEngine::contextStateCallback(pa_context* context, void* userdata)
+{
+    PulseAudioEngine *engine = static_cast<PulseAudioEngine*>(userdata);
+    pa_context_state_t state = pa_context_get_state(context);
+
+    if (state == PA_CONTEXT_READY)
+    {
+        // Open every output up front so the first utterance pays no setup
+        for (auto &output : engine->mOutputs)
         {
-            (void)close(fd);
-            if (mIsStopPlaytts1)
-            {
-                mIsStopPlaytts1 = false;
-                if (pa_simple_flush(mSimpletts1, &error) < 0)
-                {
-                    (void)fprintf(stderr, __FILE__": pa_simple_flush() failed: %s\n", pa_strerror(error));
-                    LOG_DEBUG("Error: Sample flush failed");
-                    retVal = false;
-                }
-            }
-            else
-            {
-                if (pa_simple_drain(mSimpletts1, &error) < 0)
-                {
-                    LOG_DEBUG("Error: Sample drain failed: %s", pa_strerror(error));
-                    retVal = false;
-                }
-            }
+            if (!output->stream)
+                (void) engine->openOutput(*output);
         }
-        if(retVal==true)
+        engine->resumePending();
+    }
+    else if (!PA_CONTEXT_IS_GOOD(state))
+    {
+        LOG_DEBUG("Error: Context lost: %s", pa_strerror(pa_context_errno(context)));
+        for (auto &output : engine->mOutputs)
         {
-            if (mSimpletts1)
-            {
-                pa_simple_free(mSimpletts1);
-                mSimpletts1 = nullptr;
-            }
-            LOG_DEBUG("PulseAudio Play is completed/n");
+            engine->releaseStream(*output);
+            engine->finishPlayback(*output, false);
         }
+        // Reconnect on the next playback
+        pa_context_set_state_callback(context, nullptr, nullptr);
+        pa_context_unref(context);
+        engine->mContext = nullptr;
     }
-    return retVal;
 }
 
-bool PulseAudioEngine::playAudiotts2(std::string audio_file)
+// Creates the stream once the sink's native rate is known
+bool PulseAudioEngine::openOutput(Output& output)
+{
+    if (output.sinkInfoOp)
+        return true;
+    output.sinkInfoOp = pa_context_get_sink_info_by_name(mContext, output.sinkName.c_str(),
+            sinkInfoCallback, &output);
+    if (!output.sinkInfoOp)
+        return createStream(output);
+    return true;
+}
+
+void PulseAudioEngine::sinkInfoCallback(pa_context* context, const pa_sink_info* info, int eol, void* userdata)
 {
-    int fd;
-    int error;
-    bool returnValue  = true;
-    LOG_DEBUG("Entering function : PulseAudioEngine::playAudiotts2");
-    if ((fd = open(audio_file.c_str(), O_RDONLY)) < 0)
+    Output &output = *static_cast<Output*>(userdata);
+    if (eol == 0 && info)
     {
-        LOG_DEBUG("Error: File opening failed: %s", strerror(errno));
-        returnValue = false;
+        // Match the sink so the server has nothing to resample or convert
+        output.spec.rate = info->sample_spec.rate;
+        output.spec.format = (info->sample_spec.format == PA_SAMPLE_FLOAT32LE) ?
+                PA_SAMPLE_FLOAT32LE : PA_SAMPLE_S16LE;
+        return;
     }
-    else
+    if (eol < 0)
+        LOG_DEBUG("No sink info for %s, keeping %u Hz", output.sinkName.c_str(), output.spec.rate);
+
+    operationDone(output.sinkInfoOp);
+    output.sinkInfoOp = nullptr;
+    if (!output.stream && !output.engine->createStream(output))
+        output.engine->finishPlayback(output, false);
+}
+
+bool PulseAudioEngine::createStream(Output& output)
+{
+    LOG_DEBUG("Opening %s at %u Hz %s", output.sinkName.c_str(), output.spec.rate,
+            pa_sample_format_to_string(output.spec.format));
+    output.mixer.setDucking(mDuckLevel, (size_t) output.spec.rate * mDuckRampMs / 1000);
+    if (mTapSettings.enabled)
     {
-        LOG_DEBUG("PulseAudioEngine::play : audio_file name =  %s", audio_file.c_str());
+        (void) output.tap.open("tts-tap-" + std::to_string(output.displayId), output.spec.rate,
+                mTapSettings.capacityMs);
+    }
+    output.stream = pa_stream_new(mContext, output.sinkName.c_str(), &output.spec, nullptr);
+    if (!output.stream)
+    {
+        LOG_DEBUG("Error: Playback stream creation failed: %s", pa_strerror(pa_context_errno(mContext)));
+        return false;
+    }
+    pa_stream_set_state_callback(output.stream, streamStateCallback, &output);
+    pa_stream_set_write_callback(output.stream, streamWriteCallback, &output);
+    pa_stream_set_underflow_callback(output.stream, streamUnderflowCallback, &output);
+    // ADJUST_LATENCY makes tlength the end to end latency, not just our buffer
+    pa_buffer_attr attr = getBufferAttr(output.spec);
+    if (pa_stream_connect_playback(output.stream, output.sinkName.c_str(), &attr,
+            PA_STREAM_START_CORKED | PA_STREAM_ADJUST_LATENCY | PA_STREAM_INTERPOLATE_TIMING
+            | PA_STREAM_AUTO_TIMING_UPDATE, nullptr, nullptr) < 0)
+    {
+        LOG_DEBUG("Error: Playback stream connection failed: %s", pa_strerror(pa_context_errno(mContext)));
+        releaseStream(output);
+        return false;
+    }
+    return true;
+}
 
-        if (!(mSimpletts2 = pa_simple_new(NULL, audio_file.c_str(), PA_STREAM_PLAYBACK, "tts2", "playback", &sample_spec, NULL, NULL, &error)))
+void PulseAudioEngine::streamStateCallback(pa_stream* stream, void* userdata)
+{
+    Output &output = *static_cast<Output*>(userdata);
+    pa_stream_state_t state = pa_stream_get_state(stream);
+
+    if (state == PA_STREAM_READY)
+    {
+        const pa_buffer_attr *attr = pa_stream_get_buffer_attr(stream);
+        if (attr)
         {
-            LOG_DEBUG("Error: Playback stream creation failed: %s", pa_strerror(error));
-            (void)close(fd);
-            returnValue = false;
+            output.writeSize = attr->minreq;
+            LOG_DEBUG("%s negotiated tlength %u prebuf %u minreq %u bytes", output.sinkName.c_str(),
+                    attr->tlength, attr->prebuf, attr->minreq);
         }
+        output.engine->resumePending();
+    }
+    else if (!PA_STREAM_IS_GOOD(state))
+    {
+        LOG_DEBUG("Error: Stream on %s failed", output.sinkName.c_str());
+        // Recreated on the next playback
+        output.engine->releaseStream(output);
+        output.engine->finishPlayback(output, false);
+    }
+}
+
+void PulseAudioEngine::streamWriteCallback(pa_stream* stream, size_t nbytes, void* userdata)
+{
+    Output &output = *static_cast<Output*>(userdata);
+    if (output.mixer.isActive())
+        output.engine->writeData(output, nbytes);
+}
+
+// Runs dry at the end of every utterance too, only a shortfall while
+// there is audio left to give counts
+void PulseAudioEngine::streamUnderflowCallback(pa_stream* stream, void* userdata)
+{
+    Output &output = *static_cast<Output*>(userdata);
+    if (!output.mixer.isActive())
+        return;
+    output.metrics.underruns++;
+    LOG_INFO("tts:audio:pulse", 0, "%s underrun, %llu so far", output.sinkName.c_str(),
+            (unsigned long long) output.metrics.underruns.load());
+}
+
+// Mixes the voices straight into the server's buffer
+void PulseAudioEngine::writeData(Output& output, size_t nbytes)
+{
+    size_t frameSize = pa_frame_size(&output.spec);
+    size_t written = 0;
+    AudioMetrics::Clock::time_point writeStart = AudioMetrics::Clock::now();
+    if (output.tap.isOpen() && output.mixer.isActive())
+    {
+        // Interpolated locally, what is written next plays after everything buffered
+        pa_usec_t latency = 0;
+        int negative = 0;
+        if (pa_stream_get_latency(output.stream, &latency, &negative) == 0 && !negative)
+            output.tap.stamp(AudioTap::nowNs() + (int64_t) latency * 1000);
+    }
+    while (nbytes >= frameSize && output.mixer.isActive())
+    {
+        void *buffer = nullptr;
+        size_t size = nbytes;
+        if (output.writeSize > 0)
+            size = std::min(size, output.writeSize);
+        if (pa_stream_begin_write(output.stream, &buffer, &size) < 0 || !buffer)
+        {
+            LOG_DEBUG("Error: Data playing failed: %s", pa_strerror(pa_context_errno(mContext)));
+            finishPlayback(output, false);
+            return;
+        }
+        size_t frames = std::min(size, nbytes) / frameSize;
+        output.mixBuffer.resize(frames);
+        frames = output.mixer.mix(output.mixBuffer.data(), frames);
+        if (frames == 0)
+        {
+            pa_stream_cancel_write(output.stream);
+            break;
+        }
+        if (output.spec.format == PA_SAMPLE_FLOAT32LE)
+            memcpy(buffer, output.mixBuffer.data(), frames * sizeof(float));
         else
+            getDspKernels().floatToS16(output.mixBuffer.data(), static_cast<int16_t*>(buffer), frames);
+        if (pa_stream_write(output.stream, buffer, frames * frameSize, nullptr, 0, PA_SEEK_RELATIVE) < 0)
+        {
+            LOG_DEBUG("Error: Data playing failed: %s", pa_strerror(pa_context_errno(mContext)));
+            finishPlayback(output, false);
+            return;
+        }
+        output.tap.write(output.mixBuffer.data(), frames);
+        nbytes -= frames * frameSize;
+        written += frames;
+    }
+    if (written > 0)
+    {
+        output.metrics.writeStall.record(AudioMetrics::elapsedUs(writeStart));
+        // Heard once what the server buffered ahead of it has played
+        pa_usec_t latency = sampleLatency(output);
+        for (Voice &v : output.voices)
         {
-            uint8_t buf[BUFSIZE];
-            ssize_t rSize;
-            do
-            {
-                // Read the data
-                if ((rSize = read(fd, buf, sizeof(buf))) <= 0)
-                {
-                    if (rSize == 0) // EOF
-                    break;
-                }
-                if (true == mIsStopPlaytts2)
-                {
-                    LOG_INFO("tts:audio:pulse", 0, "INFO: Got Stop Command While Playing ");
-                    break;
-                }
-
-                // Play the data
-                if (pa_simple_write(mSimpletts2, buf, (size_t) rSize, &error) < 0)
-                {
-                    LOG_DEBUG("Error: Data playing failed: %s", pa_strerror(error));
-                    (void)close(fd);
-                    returnValue = false;
-	            break;
-                }
-            }while(rSize != 0);
+            if (!v.firstPending)
+                continue;
+            v.firstPending = false;
+            output.metrics.firstSample.record(AudioMetrics::elapsedUs(v.start) + latency);
         }
-        if(returnValue)
+    }
+    if (output.mixer.isActive())
+    {
+        // A voice that ended under another one is done once written
+        finishWrittenVoices(output);
+    }
+    else if (!output.drainOp)
+    {
+        if (mGapless && output.nextPending)
         {
-            (void)close(fd);
-            if (mIsStopPlaytts2)
-            {
-                 mIsStopPlaytts2 = false;
-                 if (pa_simple_flush(mSimpletts2, &error) < 0)
-                 {
-                      (void)fprintf(stderr, __FILE__": pa_simple_flush() failed: %s\n", pa_strerror(error));
-                      LOG_DEBUG("Error: Sample flush failed");
-                      returnValue = false;
-                 }
-            }
-            else
-            {
-                if (pa_simple_drain(mSimpletts2, &error) < 0)
-                {
-                     LOG_DEBUG("Error: Sample drain failed: %s", pa_strerror(error));
-                     returnValue = false;
-                }
-            }
+            // No drain, the next utterance continues the stream; what was
+            // written is done once it has been heard
+            output.streaming = true;
+            waitPlayedOut(output);
         }
-        if(returnValue)
+        else
         {
-            if (mSimpletts2)
-            {
-                pa_simple_free(mSimpletts2);
-                mSimpletts2 = nullptr;
-            }
-            LOG_DEBUG("PulseAudio Play is completed/n");
+            output.drainStart = AudioMetrics::Clock::now();
+            output.drainOp = pa_stream_drain(output.stream, streamDrainCallback, &output);
         }
     }
-    return returnValue;
 }
 
-bool PulseAudioEngine::stop(unsigned int displayId)
+void PulseAudioEngine::streamDrainCallback(pa_stream* stream, int success, void* userdata)
 {
-    LOG_TRACE("Entering function %s", __FUNCTION__);
-    if (displayId)
-        mIsStopPlaytts2 = true;
+    Output &output = *static_cast<Output*>(userdata);
+    operationDone(output.drainOp);
+    output.drainOp = nullptr;
+    if (!success)
+        LOG_DEBUG("Error: Sample drain failed");
     else
-        mIsStopPlaytts1 = true;
-    return true;
+        output.metrics.drain.record(AudioMetrics::elapsedUs(output.drainStart));
+    if (success && isBusy(output))
+        output.engine->finishWrittenVoices(output);
+    else
+        output.engine->finishPlayback(output, success != 0);
+}
+
+pa_usec_t PulseAudioEngine::sampleLatency(Output& output)
+{
+    pa_usec_t latency = 0;
+    int negative = 0;
+    // Fails with no data until the first timing update arrived
+    if (pa_stream_get_latency(output.stream, &latency, &negative) < 0 || negative)
+        return 0;
+    output.latencySum += latency;
+    output.latencyMax = std::max(output.latencyMax, latency);
+    output.latencySamples++;
+    output.metrics.latency.record(latency);
+    return latency;
+}
+
+void PulseAudioEngine::reportLatency(Output& output)
+{
+    if (output.latencySamples > 0)
+    {
+        LOG_INFO("tts:audio:pulse", 0, "%s latency profile: %s avg: %llu us max: %llu us (%u samples)",
+                output.sinkName.c_str(), mLatencyProfile.name.c_str(),
+                (unsigned long long) (output.latencySum / output.latencySamples),
+                (unsigned long long) output.latencyMax, output.latencySamples);
+    }
+    output.latencySum = 0;
+    output.latencyMax = 0;
+    output.latencySamples = 0;
+}
+
+bool PulseAudioEngine::isBusy(const Output& output)
+{
+    for (const Voice &v : output.voices)
+    {
+        if (v.done)
+            return true;
+    }
+    return false;
+}
+
+void PulseAudioEngine::finishWrittenVoices(Output& output)
+{
+    for (unsigned int voice = 0; voice < VOICE_COUNT; voice++)
+    {
+        const Voice &v = output.voices[voice];
+        if (v.done && !v.pending && !output.mixer.isActive((AudioVoice) voice))
+            finishVoice(output, (AudioVoice) voice, true);
+    }
+}
+
+void PulseAudioEngine::finishPlayback(Output& output, bool result)
+{
+    if (!isBusy(output))
+    {
+        // e.g. the idle drain of a gapless stream
+        idleOutput(output, result);
+        return;
+    }
+    for (unsigned int voice = 0; voice < VOICE_COUNT; voice++)
+    {
+        if (output.voices[voice].done)
+            finishVoice(output, (AudioVoice) voice, result);
+    }
+}
+
+void PulseAudioEngine::finishVoice(Output& output, AudioVoice voice, bool result)
+{
+    Voice &v = output.voices[voice];
+    std::function<void(bool)> done = std::move(v.done);
+    v.done = nullptr;
+    v.pending = false;
+    v.data.clear();
+    output.mixer.clearVoice(voice);
+
+    // The stream goes idle with the last voice
+    if (!isBusy(output))
+        idleOutput(output, result);
+    if (done)
+        done(result);
+}
+
+void PulseAudioEngine::idleOutput(Output& output, bool result)
+{
+    reportLatency(output);
+    cancelPlayedOut(output);
+    if (output.drainOp)
+    {
+        pa_operation_cancel(output.drainOp);
+        operationDone(output.drainOp);
+        output.drainOp = nullptr;
+    }
+    if (!result || !output.stream)
+        output.streaming = false;
+    if (output.streaming && !output.idleTimer)
+    {
+        output.idleTimer = pa_context_rttime_new(mContext,
+                pa_rtclock_now() + GAPLESS_IDLE_TIMEOUT_MS * PA_USEC_PER_MSEC,
+                idleTimeoutCallback, &output);
+    }
+    // Everything was heard; corked, the stream cannot run dry while the
+    // next utterance is synthesized
+    if (output.stream && pa_stream_get_state(output.stream) == PA_STREAM_READY)
+        operationDone(pa_stream_cork(output.stream, 1, nullptr, nullptr));
+}
+
+// Stream time of the last sample written, reached once it has been heard
+void PulseAudioEngine::waitPlayedOut(Output& output)
+{
+    pa_usec_t now = 0;
+    pa_usec_t latency = 0;
+    int negative = 0;
+    if (pa_stream_get_time(output.stream, &now) < 0
+            || pa_stream_get_latency(output.stream, &latency, &negative) < 0)
+    {
+        // No timing update yet, the write position is all there is
+        finishWrittenVoices(output);
+        return;
+    }
+    output.playedEndUsec = now + (negative ? 0 : latency);
+    armPlayedOut(output, output.playedEndUsec - now);
 }
 
-void PulseAudioEngine::init()
+void PulseAudioEngine::armPlayedOut(Output& output, pa_usec_t delay)
+{
+    cancelPlayedOut(output);
+    output.playedTimer = pa_context_rttime_new(mContext,
+            pa_rtclock_now() + std::max(delay, (pa_usec_t) PLAYED_OUT_MIN_WAIT_USEC),
+            playedOutCallback, &output);
+}
+
+void PulseAudioEngine::playedOutCallback(pa_mainloop_api* api, pa_time_event* event,
+        const struct timeval* tv, void* userdata)
+{
+    Output &output = *static_cast<Output*>(userdata);
+    api->time_free(event);
+    output.playedTimer = nullptr;
+    // Paused, or the server runs behind the estimate
+    pa_usec_t now = 0;
+    if (output.stream && pa_stream_get_time(output.stream, &now) == 0 && now < output.playedEndUsec)
+    {
+        output.engine->armPlayedOut(output, output.playedEndUsec - now);
+        return;
+    }
+    output.engine->finishWrittenVoices(output);
+}
+
+void PulseAudioEngine::cancelPlayedOut(Output& output)
+{
+    if (output.playedTimer)
+    {
+        mApi->time_free(output.playedTimer);
+        output.playedTimer = nullptr;
+    }
+}
+
+void PulseAudioEngine::idleTimeoutCallback(pa_mainloop_api* api, pa_time_event* event,
+        const struct timeval* tv, void* userdata)
+{
+    Output &output = *static_cast<Output*>(userdata);
+    api->time_free(event);
+    output.idleTimer = nullptr;
+    output.streaming = false;
+}
+
+void PulseAudioEngine::cancelIdleTimer(Output& output)
+{
+    if (output.idleTimer)
+    {
+        mApi->time_free(output.idleTimer);
+        output.idleTimer = nullptr;
+    }
+}
+
+void PulseAudioEngine::releaseStream(Output& output)
+{
+    cancelIdleTimer(output);
+    cancelPlayedOut(output);
+    output.streaming = false;
+    if (output.sinkInfoOp)
+    {
+        pa_operation_cancel(output.sinkInfoOp);
+        operationDone(output.sinkInfoOp);
+        output.sinkInfoOp = nullptr;
+    }
+    if (!output.stream)
+        return;
+    if (output.drainOp)
+    {
+        pa_operation_cancel(output.drainOp);
+        operationDone(output.drainOp);
+        output.drainOp = nullptr;
+    }
+    pa_stream_set_state_callback(output.stream, nullptr, nullptr);
+    pa_stream_set_write_callback(output.stream, nullptr, nullptr);
+    pa_stream_set_underflow_callback(output.stream, nullptr, nullptr);
+    pa_stream_disconnect(output.stream);
+    pa_stream_unref(output.stream);
+    output.stream = nullptr;
+}
+
+void PulseAudioEngine::operationDone(pa_operation* operation)
+{
+    if (operation)
+        pa_operation_unref(operation);
+}
+
+bool PulseAudioEngine::stop(unsigned int displayId, AudioVoice voice)
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mOutputs.size())
+        return true;
+    Output &output = *mOutputs[displayId];
+
+    MainloopLock lock(mThreadedMainloop);
+    bool streaming = (voice == VOICE_SPEECH) && output.streaming;
+    if (!output.voices[voice].done && !streaming)
+    {
+        // A pause taken during synthesis ends with the utterance
+        if (!isBusy(output))
+            output.paused = false;
+        return true;
+    }
+    LOG_INFO("tts:audio:pulse", 0, "INFO: Got Stop Command While Playing ");
+    output.mixer.clearVoice(voice);
+    bool others = false;
+    for (unsigned int other = 0; other < VOICE_COUNT; other++)
+        others = others || (other != (unsigned int) voice && output.voices[other].done);
+    // Drop what the server still holds unless another voice is in it; the
+    // stream itself stays open
+    if (!others)
+    {
+        if (output.stream && pa_stream_get_state(output.stream) == PA_STREAM_READY)
+            operationDone(pa_stream_flush(output.stream, nullptr, nullptr));
+        cancelIdleTimer(output);
+        output.paused = false;
+    }
+    output.streaming = false;
+    if (output.voices[voice].done)
+        finishVoice(output, voice, true);
+    else if (!others)
+        idleOutput(output, true);
+    return true;
 }
 
+void PulseAudioEngine::setNextPending(unsigned int displayId, bool pending)
+{
+    if (displayId >= mOutputs.size())
+        return;
+    MainloopLock lock(mThreadedMainloop);
+    mOutputs[displayId]->nextPending = pending;
+}
+
+const AudioMetrics* PulseAudioEngine::getMetrics(unsigned int displayId) const
+{
+    return (displayId < mOutputs.size()) ? &mOutputs[displayId]->metrics : nullptr;
+}
+
+const AudioTap* PulseAudioEngine::getTap(unsigned int displayId) const
+{
+    return (displayId < mOutputs.size()) ? &mOutputs[displayId]->tap : nullptr;
+}
+
+void PulseAudioEngine::init(unsigned int displayCount)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    loadConfig();
+    if (!mReactor && !mThreadedMainloop)
+    {
+        mThreadedMainloop = pa_threaded_mainloop_new();
+        if (mThreadedMainloop && pa_threaded_mainloop_start(mThreadedMainloop) < 0)
+        {
+            LOG_DEBUG("Error: Failed to start the pulse mainloop");
+            pa_threaded_mainloop_free(mThreadedMainloop);
+            mThreadedMainloop = nullptr;
+        }
+        else if (mThreadedMainloop)
+        {
+            // Stream writes run on the mainloop thread, it is the render thread
+            MainloopLock lock(mThreadedMainloop);
+            pa_mainloop_api_once(pa_threaded_mainloop_get_api(mThreadedMainloop), applyRenderPolicy, nullptr);
+        }
+    }
+
+    MainloopLock lock(mThreadedMainloop);
+    // Display N plays on the "tts<N+1>" sink
+    for (unsigned int displayId = mOutputs.size(); displayId < displayCount; displayId++)
+    {
+        std::unique_ptr<Output> output(new Output);
+        output->engine = this;
+        output->displayId = displayId;
+        output->sinkName = SINK_NAME_PREFIX + std::to_string(displayId + 1);
+        output->spec = sample_spec;
+        output->decoder.setTrimmer(mTrimmer);
+        mOutputs.push_back(std::move(output));
+    }
+    if (!connectContext())
+        LOG_DEBUG("Error: Could not connect to the pulse server, retrying on play");
+}
 
 void PulseAudioEngine::deInit()
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
+    {
+        MainloopLock lock(mThreadedMainloop);
+        for (auto &output : mOutputs)
+        {
+            for (Voice &v : output->voices)
+                v.done = nullptr;
+            releaseStream(*output);
+            output->tap.close();
+        }
+        if (mContext)
+        {
+            pa_context_set_state_callback(mContext, nullptr, nullptr);
+            pa_context_disconnect(mContext);
+            pa_context_unref(mContext);
+            mContext = nullptr;
+        }
+    }
+    if (mThreadedMainloop)
+    {
+        pa_threaded_mainloop_stop(mThreadedMainloop);
+        pa_threaded_mainloop_free(mThreadedMainloop);
+        mThreadedMainloop = nullptr;
+    }
+    if (mGlibMainloop)
+    {
+        pa_glib_mainloop_free(mGlibMainloop);
+        mGlibMainloop = nullptr;
+    }
 }
@@ -17,29 +17,159 @@
 #ifndef SRC_ENGINE_PULSEAUDIOENGINE_H_
 #define SRC_ENGINE_PULSEAUDIOENGINE_H_
 
-#include <pulse/simple.h>
+#include <pulse/pulseaudio.h>
+#include <pulse/glib-mainloop.h>
+#include <pulse/thread-mainloop.h>
 #include <AudioEngine.h>
 #include <AudioEngineFactory.h>
-#include <atomic>
+#include <AudioMixer.h>
+#include <SpeechDecoder.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 
+// One shared context and one long lived, corked playback stream per output.
+// The voices of an output are mixed in process into that one stream.
+// Runs on its own pa_threaded_mainloop, or on the GLib main loop once
+// attachToMainLoop() was called (reactor mode).
 class PulseAudioEngine: public AudioEngine
 {
 public:
     PulseAudioEngine();
-    virtual ~PulseAudioEngine() {};
-    void init();
-    bool play(unsigned int displayId);
-    bool playAudiotts1(std::string audio_file);
-    bool playAudiotts2(std::string audio_file);
-    bool stop(unsigned int displayId);
-    void pause();
-    void resume();
+    virtual ~PulseAudioEngine();
+    void init(unsigned int displayCount);
+    void attachToMainLoop();
+    bool play(unsigned int displayId, AudioVoice voice);
+    void playAsync(unsigned int displayId, AudioVoice voice, std::function<void(bool)> done);
+    bool stop(unsigned int displayId, AudioVoice voice);
+    void setNextPending(unsigned int displayId, bool pending);
+    bool pause(unsigned int displayId);
+    bool resume(unsigned int displayId);
+    const AudioMetrics* getMetrics(unsigned int displayId) const;
+    const AudioTap* getTap(unsigned int displayId) const;
     void deInit();
 private:
-    pa_simple *mSimpletts1;
-    pa_simple *mSimpletts2;
-    std::atomic<bool> mIsStopPlaytts1;
-    std::atomic<bool> mIsStopPlaytts2;
+    // One utterance handed to an output
+    struct Voice
+    {
+        // Synthesized file until the stream is ready, then in the mixer
+        bool pending = false;
+        std::vector<uint8_t> data;
+        std::function<void(bool)> done;
+        // Set by play(), the first sample is counted once written
+        AudioMetrics::Clock::time_point start;
+        bool firstPending = false;
+    };
+
+    // Everything below is guarded by the mainloop lock in threaded mode
+    struct Output
+    {
+        PulseAudioEngine *engine = nullptr;
+        unsigned int displayId = 0;
+        std::string sinkName;
+        // Mono at the sink's native rate, S16 or float
+        pa_sample_spec spec;
+        Voice voices[VOICE_COUNT];
+        AudioMixer mixer;
+        std::vector<float> mixBuffer;
+        pa_operation *sinkInfoOp = nullptr;
+        SpeechDecoder decoder;
+        pa_stream *stream = nullptr;
+        pa_operation *drainOp = nullptr;
+        // Negotiated minreq, the size of each write
+        size_t writeSize = 0;
+        pa_usec_t latencySum = 0;
+        pa_usec_t latencyMax = 0;
+        unsigned int latencySamples = 0;
+        AudioMetrics metrics;
+        AudioMetrics::Clock::time_point drainStart;
+        // At the stream's rate, reopened along with it
+        AudioTap tap;
+        // Gapless: the stream is kept, corked once played out, for the next
+        // utterance; the written voices finish at playedEndUsec stream time
+        bool nextPending = false;
+        bool streaming = false;
+        pa_time_event *idleTimer = nullptr;
+        pa_time_event *playedTimer = nullptr;
+        pa_usec_t playedEndUsec = 0;
+        // Corked by pause(); playback may still fill the buffer meanwhile
+        bool paused = false;
+    };
+
+    // Buffer targets in milliseconds of audio, selected by pulse.latencyProfile
+    struct LatencyProfile
+    {
+        std::string name;
+        unsigned int tlengthMs;
+        unsigned int prebufMs;
+        unsigned int minreqMs;
+    };
+
+    // No-op on the GLib main loop
+    class MainloopLock
+    {
+    public:
+        explicit MainloopLock(pa_threaded_mainloop* mainloop) : mMainloop(mainloop)
+        {
+            if (mMainloop)
+                pa_threaded_mainloop_lock(mMainloop);
+        }
+        ~MainloopLock()
+        {
+            if (mMainloop)
+                pa_threaded_mainloop_unlock(mMainloop);
+        }
+    private:
+        pa_threaded_mainloop *mMainloop;
+    };
+
+    void loadConfig();
+    pa_buffer_attr getBufferAttr(const pa_sample_spec& spec) const;
+    bool prepareAudio(Output& output, AudioVoice voice);
+    pa_usec_t sampleLatency(Output& output);
+    void reportLatency(Output& output);
+    bool startPlayback(Output& output, AudioVoice voice, std::function<void(bool)> done);
+    bool connectContext();
+    bool openOutput(Output& output);
+    bool createStream(Output& output);
+    void resumePending();
+    void writeData(Output& output, size_t nbytes);
+    void finishVoice(Output& output, AudioVoice voice, bool result);
+    void finishWrittenVoices(Output& output);
+    void finishPlayback(Output& output, bool result);
+    void idleOutput(Output& output, bool result);
+    static bool isBusy(const Output& output);
+    void releaseStream(Output& output);
+    void waitPlayedOut(Output& output);
+    void armPlayedOut(Output& output, pa_usec_t delay);
+    void cancelPlayedOut(Output& output);
+    void cancelIdleTimer(Output& output);
+    static void contextStateCallback(pa_context* context, void* userdata);
+    static void sinkInfoCallback(pa_context* context, const pa_sink_info* info, int eol, void* userdata);
+    static void streamStateCallback(pa_stream* stream, void* userdata);
+    static void streamWriteCallback(pa_stream* stream, size_t nbytes, void* userdata);
+    static void streamUnderflowCallback(pa_stream* stream, void* userdata);
+    static void streamDrainCallback(pa_stream* stream, int success, void* userdata);
+    static void playedOutCallback(pa_mainloop_api* api, pa_time_event* event,
+            const struct timeval* tv, void* userdata);
+    static void idleTimeoutCallback(pa_mainloop_api* api, pa_time_event* event,
+            const struct timeval* tv, void* userdata);
+    static void operationDone(pa_operation* operation);
+
+    std::vector<std::unique_ptr<Output>> mOutputs;
+    pa_threaded_mainloop *mThreadedMainloop = nullptr;
+    pa_glib_mainloop *mGlibMainloop = nullptr;
+    pa_mainloop_api *mApi = nullptr;
+    pa_context *mContext = nullptr;
+    bool mReactor = false;
+    LatencyProfile mLatencyProfile;
+    bool mGapless = false;
+    unsigned int mGapSilenceMs = 0;
+    float mDuckLevel = DEFAULT_DUCK_LEVEL;
+    unsigned int mDuckRampMs = DEFAULT_DUCK_RAMP_MS;
+    SilenceTrimmer mTrimmer;
+    TapSettings mTapSettings;
 };
 
 #endif /* SRC_ENGINE_PULSEAUDIOENGINE_H_ */
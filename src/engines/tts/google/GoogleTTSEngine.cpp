@@ -19,6 +19,7 @@
 #include <GoogleTTSEngine.h>
 #include <TTSErrors.h>
 #include <TTSLog.h>
+#include <TTSUtils.h>
 #include <algorithm>
 
 using google::cloud::texttospeech::v1::AudioConfig;
@@ -27,19 +28,34 @@ using google::cloud::texttospeech::v1::VoiceSelectionParams;
 using google::cloud::texttospeech::v1::AudioEncoding;
 
 #define GOOGLE_APPLICATION_ENDPOINT   "texttospeech.googleapis.com"
-#define AUDIO_FILE_1                  "/tmp/sttsResultOne.pcm"
-#define AUDIO_FILE_2                  "/tmp/sttsResultTwo.pcm"
 #define DEFAULT_LANGUAGE              "en-US"
 #define TTS_ENGINE_NAME               "google"
 #define GOOGLE_TTS_REQUEST_TAG        1
 
 GoogleTTSEngine::GoogleTTSEngine(double pitch, double speakRate) : TTSEngine(),mSpeakRate(speakRate),mPitch(pitch),
-     mIsStopDisplay1(false), mIsStopDisplay2(false)
+     mDisplayCount(0), mPollSource(0)
 {
     setenv("GOOGLE_APPLICATION_CREDENTIALS", GOOGLE_ENV_FILE , 1);
     mCredentials = grpc::GoogleDefaultCredentials();
 }
 
+GoogleTTSEngine::~GoogleTTSEngine()
+{
+    if (mPollSource)
+        g_source_remove(mPollSource);
+    if (mAsyncQueue) {
+        for (AsyncSpeak *call : mAsyncCalls) {
+            if (call)
+                call->context.TryCancel();
+        }
+        mAsyncQueue->Shutdown();
+        void* tag = nullptr;
+        bool ok = false;
+        while (mAsyncQueue->Next(&tag, &ok))
+            delete static_cast<AsyncSpeak*>(tag);
+    }
+}
+
 void GoogleTTSEngine::getStatus()
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
@@ -48,6 +64,7 @@ void GoogleTTSEngine::getStatus()
 void GoogleTTSEngine::getSupportedLanguages(std::vector<std::string> &  vecLang, unsigned int displayId)
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
+    std::lock_guard<std::mutex> lock(mLanguagesMutex);
     if(mAvailableLanguages.size() != 0){
         vecLang = mAvailableLanguages;
         return;
@@ -76,31 +93,26 @@ void GoogleTTSEngine::getSupportedLanguages(std::vector<std::string> &  vecLang,
     }
 }
 
-int GoogleTTSEngine::speak(std::string text, LSHandle* sh, std::string language, unsigned int displayId)
+int GoogleTTSEngine::speak(const std::string& text, LSHandle* sh, const std::string& language, unsigned int displayId)
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
-    if ((mIsStopDisplay2) && (DISPLAY_1== displayId))
-        mIsStopDisplay2 = false;
-    if ((mIsStopDisplay1) && (DISPLAY_0 == displayId))
-        mIsStopDisplay1 = false;
+    if (displayId >= mDisplayCount)
+        return TTSErrors::INVALID_PARAM;
+    std::atomic<bool> &isStop = mIsStop[displayId];
+    isStop = false;
+
+    // Started while the previous utterance played, or stale
+    std::unique_ptr<Prefetch> prefetch = takePrefetch(displayId);
+    if (prefetch && prefetch->text == text && prefetch->language == language)
+        return waitForPrefetch(*prefetch, displayId);
+    prefetch.reset();
 
     auto channel = grpc::CreateChannel(GOOGLE_APPLICATION_ENDPOINT, mCredentials);
 
     std::unique_ptr<TextToSpeech::Stub> textToSpeech = TextToSpeech::NewStub(channel);
 
     SynthesizeSpeechRequest speechRequest;
-    SynthesisInput* synthInput = speechRequest.mutable_input();
-    synthInput->set_text(text);
-
-    VoiceSelectionParams* voiceSelParams = speechRequest.mutable_voice();
-    if(!language.empty())
-        voiceSelParams->set_language_code(language);
-    else
-        voiceSelParams->set_language_code(DEFAULT_LANGUAGE);
-
-    AudioConfig *audio_config = speechRequest.mutable_audio_config();
-    audio_config->set_audio_encoding(AudioEncoding::LINEAR16);
-    audio_config->set_sample_rate_hertz(DEFAULT_SPEECH_SAMPLE_RATE);
+    buildSpeechRequest(text, language, speechRequest);
 
     SynthesizeSpeechResponse speechResponse;
     ClientContext context;
@@ -109,13 +121,30 @@ int GoogleTTSEngine::speak(std::string text, LSHandle* sh, std::string language,
     std::unique_ptr<ClientAsyncResponseReader<SynthesizeSpeechResponse> > ttsRpc(textToSpeech->PrepareAsyncSynthesizeSpeech(&context, speechRequest, &grpcCallQueue));
     ttsRpc->StartCall();
     ttsRpc->Finish(&speechResponse, &gStatus, (void*)GOOGLE_TTS_REQUEST_TAG);
+    if (!waitForReply(grpcCallQueue, (void*)GOOGLE_TTS_REQUEST_TAG, displayId))
+    {
+        context.TryCancel();
+        grpcCallQueue.Shutdown();
+        void* tag = nullptr;
+        bool ok = false;
+        while (grpcCallQueue.Next(&tag, &ok))
+            ;
+        return TTSErrors::SPEECH_DATA_CREATION_ERROR;
+    }
+    return saveSpeechResponse(gStatus, speechResponse, displayId);
+}
+
+// Blocks on a single-call queue, false when the display is stopped first
+bool GoogleTTSEngine::waitForReply(CompletionQueue& queue, void* tag, unsigned int displayId)
+{
+    std::atomic<bool> &isStop = mIsStop[displayId];
     void* got_tag = nullptr;
     bool ok = false;
     do{
-        switch(grpcCallQueue.AsyncNext(&got_tag, &ok, std::chrono::system_clock::now() + std::chrono::milliseconds(DEFAULT_DEADLINE_DURATION))){
+        switch(queue.AsyncNext(&got_tag, &ok, std::chrono::system_clock::now() + std::chrono::milliseconds(DEFAULT_DEADLINE_DURATION))){
             case grpc::CompletionQueue::SHUTDOWN:
                 LOG_DEBUG("While Waiting For Reply from Google...Got SHUTDOWN");
-                break;
+                return false;
             case grpc::CompletionQueue::GOT_EVENT:
                 LOG_DEBUG("While Waiting For Reply from Google...Got EVENT");
                 break;
@@ -126,30 +155,172 @@ int GoogleTTSEngine::speak(std::string text, LSHandle* sh, std::string language,
                 LOG_DEBUG("While Waiting For Reply from Google...Got NO CASE MATCH");
                 break;
         }
-        if(mIsStopDisplay1 || mIsStopDisplay2){
+        if(isStop){
             LOG_DEBUG("Got Stop While Waiting For Reply From Google");
-            break;
+            isStop = false;
+            return false;
         }
-    }while(!(ok && (got_tag == (void *)GOOGLE_TTS_REQUEST_TAG)));
-    if ((mIsStopDisplay2) && (DISPLAY_1 == displayId))
+    }while(!(ok && (got_tag == tag)));
+    return true;
+}
+
+void GoogleTTSEngine::speakAsync(const std::string& text, LSHandle* sh, const std::string& language,
+        unsigned int displayId, std::function<void(int)> done)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mDisplayCount || mAsyncCalls[displayId])
     {
-        mIsStopDisplay2 = false;
-        return TTSErrors::SPEECH_DATA_CREATION_ERROR;
+        done(TTSErrors::INVALID_PARAM);
+        return;
+    }
+    if (!mTextToSpeech)
+    {
+        // The reactor path keeps one channel instead of one per utterance
+        mChannel = grpc::CreateChannel(GOOGLE_APPLICATION_ENDPOINT, mCredentials);
+        mTextToSpeech = TextToSpeech::NewStub(mChannel);
+        mAsyncQueue.reset(new CompletionQueue);
+    }
+    AsyncSpeak *call = new (std::nothrow) AsyncSpeak;
+    if (call == nullptr)
+    {
+        done(TTSErrors::TTS_MEMORY_ERROR);
+        return;
     }
-    if ((mIsStopDisplay1) && (DISPLAY_0 == displayId))
+    mIsStop[displayId] = false;
+
+    SynthesizeSpeechRequest speechRequest;
+    buildSpeechRequest(text, language, speechRequest);
+    call->displayId = displayId;
+    call->done = std::move(done);
+    call->rpc = mTextToSpeech->PrepareAsyncSynthesizeSpeech(&call->context, speechRequest, mAsyncQueue.get());
+    call->rpc->StartCall();
+    call->rpc->Finish(&call->response, &call->status, (void*)call);
+    mAsyncCalls[displayId] = call;
+
+    if (!mPollSource)
+        mPollSource = g_timeout_add(ASYNC_POLL_INTERVAL_MS, pollAsyncCalls, this);
+}
+
+void GoogleTTSEngine::prefetch(const std::string& text, const std::string& language, unsigned int displayId)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    if (displayId >= mDisplayCount)
+        return;
+    std::unique_ptr<Prefetch> prefetch(new (std::nothrow) Prefetch);
+    if (!prefetch)
+        return;
+    prefetch->text = text;
+    prefetch->language = language;
+    SynthesizeSpeechRequest speechRequest;
+    buildSpeechRequest(text, language, speechRequest);
+
+    // Started here and collected by speak(), a stale one is cancelled
+    // when replaced and the deadline bounds one that is never used
+    prefetch->context.set_deadline(std::chrono::system_clock::now()
+            + std::chrono::milliseconds(PREFETCH_DEADLINE_MS));
+    prefetch->textToSpeech = TextToSpeech::NewStub(
+            grpc::CreateChannel(GOOGLE_APPLICATION_ENDPOINT, mCredentials));
+    prefetch->rpc = prefetch->textToSpeech->PrepareAsyncSynthesizeSpeech(&prefetch->context,
+            speechRequest, &prefetch->queue);
+    prefetch->rpc->StartCall();
+    prefetch->rpc->Finish(&prefetch->response, &prefetch->status, (void*)GOOGLE_TTS_REQUEST_TAG);
+
+    std::unique_ptr<Prefetch> previous;
     {
-        mIsStopDisplay1 = false;
+        std::lock_guard<std::mutex> lock(mPrefetchMutex);
+        previous = std::move(mPrefetches[displayId]);
+        mPrefetches[displayId] = std::move(prefetch);
+    }
+}
+
+// Cancels the call if it is still running and drains its queue
+GoogleTTSEngine::Prefetch::~Prefetch()
+{
+    context.TryCancel();
+    queue.Shutdown();
+    void* tag = nullptr;
+    bool ok = false;
+    while (queue.Next(&tag, &ok))
+        ;
+}
+
+std::unique_ptr<GoogleTTSEngine::Prefetch> GoogleTTSEngine::takePrefetch(unsigned int displayId)
+{
+    std::lock_guard<std::mutex> lock(mPrefetchMutex);
+    if (displayId >= mPrefetches.size())
+        return nullptr;
+    return std::move(mPrefetches[displayId]);
+}
+
+int GoogleTTSEngine::waitForPrefetch(Prefetch& prefetch, unsigned int displayId)
+{
+    LOG_DEBUG("Waiting For Prefetched Reply from Google...");
+    if (!waitForReply(prefetch.queue, (void*)GOOGLE_TTS_REQUEST_TAG, displayId))
         return TTSErrors::SPEECH_DATA_CREATION_ERROR;
+    return saveSpeechResponse(prefetch.status, prefetch.response, displayId);
+}
+
+gboolean GoogleTTSEngine::pollAsyncCalls(gpointer data)
+{
+    GoogleTTSEngine *engine = static_cast<GoogleTTSEngine*>(data);
+    void* got_tag = nullptr;
+    bool ok = false;
+
+    // An already expired deadline only collects finished calls
+    while (engine->mAsyncQueue->AsyncNext(&got_tag, &ok, std::chrono::system_clock::now())
+            == grpc::CompletionQueue::GOT_EVENT)
+    {
+        AsyncSpeak *call = static_cast<AsyncSpeak*>(got_tag);
+        unsigned int displayId = call->displayId;
+        engine->mAsyncCalls[displayId] = nullptr;
+
+        int ret = TTSErrors::SPEECH_DATA_CREATION_ERROR;
+        if (engine->mIsStop[displayId])
+            LOG_DEBUG("Got Stop While Waiting For Reply From Google");
+        else if (ok)
+            ret = engine->saveSpeechResponse(call->status, call->response, displayId);
+        engine->mIsStop[displayId] = false;
+
+        std::function<void(int)> done = std::move(call->done);
+        delete call;
+        done(ret);
+    }
+
+    for (AsyncSpeak *call : engine->mAsyncCalls)
+    {
+        if (call)
+            return G_SOURCE_CONTINUE;
     }
-    if(gStatus.error_code() == grpc::StatusCode::OK)
+    engine->mPollSource = 0;
+    return G_SOURCE_REMOVE;
+}
+
+void GoogleTTSEngine::buildSpeechRequest(const std::string& text, const std::string& language,
+        SynthesizeSpeechRequest& speechRequest)
+{
+    SynthesisInput* synthInput = speechRequest.mutable_input();
+    synthInput->set_text(text);
+
+    VoiceSelectionParams* voiceSelParams = speechRequest.mutable_voice();
+    if(!language.empty())
+        voiceSelParams->set_language_code(language);
+    else
+        voiceSelParams->set_language_code(DEFAULT_LANGUAGE);
+
+    AudioConfig *audio_config = speechRequest.mutable_audio_config();
+    audio_config->set_audio_encoding(AudioEncoding::LINEAR16);
+    audio_config->set_sample_rate_hertz(DEFAULT_SPEECH_SAMPLE_RATE);
+}
+
+int GoogleTTSEngine::saveSpeechResponse(const Status& status, const SynthesizeSpeechResponse& response,
+        unsigned int displayId)
+{
+    if(status.error_code() == grpc::StatusCode::OK)
     {
-        std::string synthOutput = speechResponse.audio_content();
+        const std::string& synthOutput = response.audio_content();
         std::ofstream outfile;
 
-        if (DISPLAY_1 == displayId)
-	    outfile.open(AUDIO_FILE_2, std::ofstream::out | std::ofstream::binary);
-	else
-            outfile.open(AUDIO_FILE_1, std::ofstream::out | std::ofstream::binary);
+        outfile.open(TTSUtils::getAudioFilePath(displayId), std::ofstream::out | std::ofstream::binary);
         if(outfile.is_open())
             outfile << synthOutput;
 
@@ -157,7 +328,7 @@ int GoogleTTSEngine::speak(std::string text, LSHandle* sh, std::string language,
     }
     else
     {
-        LOG_DEBUG("Synthesize speech failed: Error %d: %s", gStatus.error_code(), gStatus.error_message().c_str());
+        LOG_DEBUG("Synthesize speech failed: Error %d: %s", status.error_code(), status.error_message().c_str());
         return TTSErrors::SPEECH_DATA_CREATION_ERROR;
     }
 
@@ -172,21 +343,37 @@ void GoogleTTSEngine::start()
 void GoogleTTSEngine::stop(unsigned int displayId)
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
-    if (displayId)
-        mIsStopDisplay2 = true;
-    else
-        mIsStopDisplay1 = true;
+    if (displayId < mDisplayCount)
+    {
+        mIsStop[displayId] = true;
+        // Reactor path: the cancelled call completes on the next poll
+        if (mAsyncCalls[displayId])
+            mAsyncCalls[displayId]->context.TryCancel();
+    }
 }
 
-void GoogleTTSEngine::init()
+void GoogleTTSEngine::init(unsigned int displayCount)
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
+    mIsStop.reset(new std::atomic<bool>[displayCount]);
+    for (unsigned int displayId = 0; displayId < displayCount; displayId++)
+        mIsStop[displayId] = false;
+    mAsyncCalls.assign(displayCount, nullptr);
+    {
+        std::lock_guard<std::mutex> lock(mPrefetchMutex);
+        mPrefetches.clear();
+        mPrefetches.resize(displayCount);
+    }
+    mDisplayCount = displayCount;
 }
 
 void GoogleTTSEngine::deInit()
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
 
+    for (unsigned int displayId = 0; displayId < mDisplayCount; displayId++)
+        takePrefetch(displayId);
+
     if (mCredentials.get()) {
         mCredentials.reset();
     }
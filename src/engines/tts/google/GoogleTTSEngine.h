@@ -23,6 +23,9 @@
 #include <TTSEngineFactory.h>
 #include <vector>
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <glib.h>
 
 #include <grpc++/grpc++.h>
 
@@ -34,9 +37,9 @@
 #define DEFAULT_DEADLINE_DURATION 1000
 #define GOOGLE_ENV_FILE "/etc/google/google_tts_credentials.json"
 #define DEFAULT_SPEECH_SAMPLE_RATE 22050
+#define ASYNC_POLL_INTERVAL_MS 20
+#define PREFETCH_DEADLINE_MS 10000
 
-#define DISPLAY_0 0 //Display One Functionality
-#define DISPLAY_1 1 //Display Two Functionality
 using grpc::Channel;
 using grpc::ChannelCredentials;
 using grpc::ClientContext;
@@ -54,13 +57,16 @@ class GoogleTTSEngine: public TTSEngine
 public:
     GoogleTTSEngine(double pitch = DEFAULT_PITCH, double speakRate = DEFAULT_SPEAK_RATE);
 
-    virtual ~GoogleTTSEngine() {};
+    virtual ~GoogleTTSEngine();
     void getStatus();
     void getSupportedLanguages(std::vector<std::string> &  vecLang, unsigned int displayId);
-    int speak(std::string text, LSHandle* sh, std::string language, unsigned int displayId);
+    int speak(const std::string& text, LSHandle* sh, const std::string& language, unsigned int displayId);
+    void speakAsync(const std::string& text, LSHandle* sh, const std::string& language,
+            unsigned int displayId, std::function<void(int)> done);
+    void prefetch(const std::string& text, const std::string& language, unsigned int displayId);
     void start();
     void stop(unsigned int displayId);
-    void init();
+    void init(unsigned int displayCount);
     void deInit();
     std::string getName();
     void setSpeakRate(double rate);
@@ -68,6 +74,37 @@ public:
     double getSpeakRate(void) const;
     double getPitch(void) const;
 private:
+    // One in-flight SynthesizeSpeech call of the reactor path
+    struct AsyncSpeak
+    {
+        ClientContext context;
+        SynthesizeSpeechResponse response;
+        Status status;
+        std::unique_ptr<ClientAsyncResponseReader<SynthesizeSpeechResponse>> rpc;
+        unsigned int displayId = 0;
+        std::function<void(int)> done;
+    };
+    // Lookahead synthesis, completed on its own queue by the speak() that uses it
+    struct Prefetch
+    {
+        ~Prefetch();
+        std::string text;
+        std::string language;
+        ClientContext context;
+        CompletionQueue queue;
+        std::unique_ptr<TextToSpeech::Stub> textToSpeech;
+        std::unique_ptr<ClientAsyncResponseReader<SynthesizeSpeechResponse>> rpc;
+        Status status;
+        SynthesizeSpeechResponse response;
+    };
+    std::unique_ptr<Prefetch> takePrefetch(unsigned int displayId);
+    int waitForPrefetch(Prefetch& prefetch, unsigned int displayId);
+    bool waitForReply(CompletionQueue& queue, void* tag, unsigned int displayId);
+    void buildSpeechRequest(const std::string& text, const std::string& language,
+            SynthesizeSpeechRequest& speechRequest);
+    int saveSpeechResponse(const Status& status, const SynthesizeSpeechResponse& response,
+            unsigned int displayId);
+    static gboolean pollAsyncCalls(gpointer data);
     std::string mTextToSpeak;
     std::string mOutputLanguage;
     SynthesizeSpeechRequest mSpeechRequest;
@@ -77,8 +114,16 @@ private:
     double mSpeakRate;
     double mPitch;
     std::vector<std::string> mAvailableLanguages;
-    std::atomic<bool>mIsStopDisplay1 ;
-    std::atomic<bool>mIsStopDisplay2 ;
+    std::mutex mLanguagesMutex;
+    unsigned int mDisplayCount;
+    std::unique_ptr<std::atomic<bool>[]> mIsStop;
+    // Reactor path, main loop thread only. gRPC exposes no fd for the
+    // completion queue so it is polled while calls are outstanding.
+    std::unique_ptr<CompletionQueue> mAsyncQueue;
+    std::vector<AsyncSpeak*> mAsyncCalls;
+    guint mPollSource;
+    std::vector<std::unique_ptr<Prefetch>> mPrefetches;
+    std::mutex mPrefetchMutex;
 };
 
 #endif /* SRC_ENGINES_GOOGLETTSENGINE_H_ */
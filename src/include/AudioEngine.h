@@ -18,18 +18,53 @@
 #define SRC_CORE_AUDIOENGINE_H_
 
 
+#include <functional>
 #include <string>
+#include <AudioMetrics.h>
+#include <AudioTap.h>
+
+// Voices one output plays at once, mixed into a single stream. A voice
+// ducks every lower one while it plays.
+enum AudioVoice
+{
+    VOICE_SPEECH = 0,
+    VOICE_ALERT,
+    VOICE_COUNT
+};
 
 class AudioEngine
 {
 public:
     AudioEngine() = default;
     virtual ~AudioEngine() = default;
-    virtual bool play(unsigned int displayId) = 0;
-    virtual bool stop(unsigned int displayId) = 0;
-    virtual void pause() = 0;
-    virtual void resume() = 0;
-    virtual void init() = 0;
+    virtual bool play(unsigned int displayId, AudioVoice voice) = 0;
+    // Reactor mode counterpart of play(), see TTSEngine::speakAsync()
+    virtual void playAsync(unsigned int displayId, AudioVoice voice,
+            std::function<void(bool)> done)
+    {
+        done(play(displayId, voice));
+    }
+    virtual bool stop(unsigned int displayId, AudioVoice voice) = 0;
+    // Hint given before play() of the speech voice: another utterance
+    // follows on this output
+    virtual void setNextPending(unsigned int displayId, bool pending) {}
+    // Holds the output with its buffered audio and position; false when
+    // already paused or, for resume(), not paused
+    virtual bool pause(unsigned int displayId) = 0;
+    virtual bool resume(unsigned int displayId) = 0;
+    // Lives as long as the output, nullptr when the engine keeps none
+    virtual const AudioMetrics* getMetrics(unsigned int displayId) const
+    {
+        return nullptr;
+    }
+    // Same lifetime, nullptr when the engine cannot tap what it plays
+    virtual const AudioTap* getTap(unsigned int displayId) const
+    {
+        return nullptr;
+    }
+    virtual void init(unsigned int displayCount) = 0;
+    // Called before init() in reactor mode
+    virtual void attachToMainLoop() {}
     virtual void deInit() = 0;
 };
 
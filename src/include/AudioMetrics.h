@@ -0,0 +1,72 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef SRC_INCLUDE_AUDIOMETRICS_H_
+#define SRC_INCLUDE_AUDIOMETRICS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <pbnjson.hpp>
+
+#define HISTOGRAM_BUCKETS 24
+
+// Durations in log2 buckets of microseconds: bucket n holds values below
+// 2^n us, the last one everything longer. Recording never blocks, so a
+// realtime thread can record while another one reads.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+    void record(uint64_t us);
+    pbnjson::JValue toJson() const;
+
+private:
+    std::atomic<uint64_t> mBuckets[HISTOGRAM_BUCKETS];
+    std::atomic<uint64_t> mCount;
+    std::atomic<uint64_t> mSumUs;
+    std::atomic<uint64_t> mMaxUs;
+};
+
+// What one audio output went through since the engine started. Each
+// engine fills in what its sink can tell; the rest stays zero.
+struct AudioMetrics
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // Audio buffered ahead of the speaker, sampled on writes
+    LatencyHistogram latency;
+    // Time one write to the sink took
+    LatencyHistogram writeStall;
+    // From the play call until the first sample is heard
+    LatencyHistogram firstSample;
+    // From the last sample written until playback completed
+    LatencyHistogram drain;
+    // Reading the synthesized file
+    LatencyHistogram fileRead;
+    std::atomic<uint64_t> utterances { 0 };
+    // The sound server or device ran out of audio
+    std::atomic<uint64_t> underruns { 0 };
+    // The render side ran out of decoded speech
+    std::atomic<uint64_t> streamUnderruns { 0 };
+    std::atomic<uint64_t> trimmedMs { 0 };
+
+    static uint64_t elapsedUs(Clock::time_point since);
+    pbnjson::JValue toJson() const;
+};
+
+#endif /* SRC_INCLUDE_AUDIOMETRICS_H_ */
@@ -0,0 +1,82 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SRC_INCLUDE_AUDIOMIXER_H_
+#define SRC_INCLUDE_AUDIOMIXER_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <AudioEngine.h>
+#include <SpeechStream.h>
+
+#define DEFAULT_DUCK_LEVEL 0.25f
+#define DEFAULT_DUCK_RAMP_MS 30
+
+// Mixes the voices of one output into mono float frames. While a voice
+// plays, every lower voice ramps down to the duck level and ramps back up
+// once it ends. Not thread safe, the audio engine serializes access.
+class AudioMixer
+{
+public:
+    AudioMixer();
+    // rampFrames: length of a full duck or restore ramp, 0 switches at once
+    void setDucking(float level, size_t rampFrames);
+    // Sizes the buffers up front; mix() then never allocates, it mixes
+    // larger requests in blocks of this many frames
+    void reserve(size_t frames);
+    // Replaces whatever the voice still had to play
+    void setVoice(AudioVoice voice, std::vector<float> samples);
+    // Same, pulling the samples from a stream as they are mixed
+    void setVoice(AudioVoice voice, std::shared_ptr<SpeechStream> stream);
+    void clearVoice(AudioVoice voice);
+    // Same, but hands the voice's stream to the caller, so the last
+    // reference need not be dropped on the mixing thread
+    std::shared_ptr<SpeechStream> releaseVoice(AudioVoice voice);
+    bool isActive(AudioVoice voice) const;
+    bool isActive() const;
+    // A stream voice is waiting on its producer; mix() would pad silence
+    bool isStarved() const;
+    // Mixes up to frames frames into out, returns how many were produced.
+    // Voices that end early are padded with silence; 0 once all are done.
+    size_t mix(float* out, size_t frames);
+
+private:
+    struct Voice
+    {
+        // Whole utterance
+        std::vector<float> samples;
+        // Block last read from the stream, keeps its capacity across voices
+        std::vector<float> block;
+        size_t offset = 0;
+        std::shared_ptr<SpeechStream> stream;
+        float gain = 1.0f;
+    };
+
+    static const std::vector<float>& getSource(const Voice& v);
+    float getTargetGain(unsigned int voice) const;
+    size_t mixBlock(float* out, size_t frames);
+
+    Voice mVoices[VOICE_COUNT];
+    std::vector<float> mScratch;
+    // 0 until reserve(), blocks are then never longer
+    size_t mBlockFrames = 0;
+    float mDuckLevel;
+    // Gain change per frame while ramping
+    float mRampStep;
+};
+
+#endif /* SRC_INCLUDE_AUDIOMIXER_H_ */
@@ -0,0 +1,113 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef SRC_INCLUDE_AUDIOTAP_H_
+#define SRC_INCLUDE_AUDIOTAP_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <TTSConfig.h>
+
+#define AUDIO_TAP_MAGIC                 0x50415454
+#define AUDIO_TAP_VERSION               1
+#define DEFAULT_TAP_CAPACITY_MS         2000
+#define AUDIO_TAP_STAMPS                256
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "the tap's counters are shared with other processes");
+
+// Start of the shared mapping, followed by the stamp ring at stampsOffset
+// and the samples, mono float32 at sampleRate, at samplesOffset.
+//
+// Frame n of the stream sits at samples[n % capacityFrames]. The writer
+// raises writeStart before it overwrites anything and writeEnd once the
+// frames are in, so a reader copies frames below writeEnd and then checks
+// that writeStart is not more than capacityFrames past the first one it
+// copied; otherwise those frames were overwritten while it read.
+//
+// Stamp n sits at stamps[n % stampCapacity] and is complete once
+// stampCount is past n; it is checked against stampCount the same way.
+// Frames between two stamps play back to back at sampleRate.
+struct AudioTapHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sampleRate;
+    uint32_t channels;
+    uint32_t capacityFrames;
+    uint32_t stampCapacity;
+    uint32_t stampsOffset;
+    uint32_t samplesOffset;
+    alignas(64) std::atomic<uint64_t> writeStart;
+    std::atomic<uint64_t> writeEnd;
+    alignas(64) std::atomic<uint64_t> stampCount;
+};
+
+// The first frame written after it reaches the speaker at playNs,
+// CLOCK_MONOTONIC nanoseconds
+struct AudioTapStamp
+{
+    uint64_t frame;
+    int64_t playNs;
+};
+
+struct TapSettings
+{
+    bool enabled = false;
+    unsigned int capacityMs = DEFAULT_TAP_CAPACITY_MS;
+};
+
+// Publishes what one output plays into a sealed memfd ring that a local
+// consumer maps read-only, such as an echo canceller wanting the exact
+// reference signal. The render thread only copies into the mapping and
+// updates counters; there is no IPC per block.
+class AudioTap
+{
+public:
+    AudioTap() = default;
+    ~AudioTap();
+    AudioTap(const AudioTap&) = delete;
+    AudioTap& operator=(const AudioTap&) = delete;
+    static TapSettings loadSettings(const TTSConfig& config);
+    static int64_t nowNs();
+
+    // Replaces a mapping of another rate, consumers of the old one have
+    // to ask again
+    bool open(const std::string& name, unsigned int sampleRate, unsigned int capacityMs);
+    void close();
+
+    // Render thread only
+    bool isOpen() const { return mHeader != nullptr; }
+    void stamp(int64_t playNs);
+    void write(const float* samples, size_t frames);
+
+    // A new read-only descriptor of the mapping for a consumer, -1 when
+    // closed; the caller closes it
+    int openReadOnly(unsigned int& sampleRate, unsigned int& capacityFrames) const;
+
+private:
+    mutable std::mutex mMutex;
+    int mFd = -1;
+    size_t mSize = 0;
+    AudioTapHeader *mHeader = nullptr;
+    AudioTapStamp *mStamps = nullptr;
+    float *mSamples = nullptr;
+};
+
+#endif /* SRC_INCLUDE_AUDIOTAP_H_ */
@@ -0,0 +1,49 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SRC_INCLUDE_DSPKERNELS_H_
+#define SRC_INCLUDE_DSPKERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// Per sample PCM kernels of the playback path. Float samples are
+// normalized to [-1, 1). Buffers need no particular alignment.
+struct DspKernels
+{
+    const char *name;
+    void (*s16ToFloat)(const int16_t* in, float* out, size_t count);
+    // Rounds to nearest and saturates
+    void (*floatToS16)(const float* in, int16_t* out, size_t count);
+    // buf[i] *= gain + i * step
+    void (*gainRamp)(float* buf, size_t count, float gain, float step);
+    // dst[i] += src[i] * gain
+    void (*mixAdd)(float* dst, const float* src, size_t count, float gain);
+    float (*dot)(const float* a, const float* b, size_t count);
+    // Largest |sample|, 32768 for -32768
+    int (*peakS16)(const int16_t* in, size_t count);
+};
+
+// Best variant for this CPU, picked on first use
+const DspKernels& getDspKernels();
+const DspKernels& getScalarDspKernels();
+
+// Variants compiled into this build, nullptr when unavailable
+const DspKernels* getSse2DspKernels();
+const DspKernels* getAvx2DspKernels();
+const DspKernels* getNeonDspKernels();
+
+#endif /* SRC_INCLUDE_DSPKERNELS_H_ */
@@ -17,7 +17,11 @@
 #ifndef SRC_CORE_ENGINEHANDLER_H_
 #define SRC_CORE_ENGINEHANDLER_H_
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include <luna-service2/lunaservice.hpp>
 #include <AudioEngine.h>
@@ -25,6 +29,7 @@
 #include <TTSEngine.h>
 #include <TTSParameters.h>
 #include <TTSRequestTypes.h>
+#include <TTSUtils.h>
 
 class TTSRequest;
 class EngineHandler
@@ -35,28 +40,71 @@ public:
     virtual ~EngineHandler();
 
     bool handleRequest(TTSRequest* request, unsigned int displayId);
+    void handleRequestAsync(TTSRequest* request, unsigned int displayId,
+            std::function<void(bool)> done);
     void loadEngine();
     void unloadEngine();
 
     bool setConfig(bool status_flag);
+    bool getConfigValue(const std::string& category, const std::string& key, pbnjson::JValue& value) const;
 
     void getStatusInfo(TTSRequest* pTTSRequest, unsigned int displayId);
     void getLanguages(TTSRequest* pTTSRequest, unsigned int displayId);
-    void saveSpeakRequestInfo(SpeakRequest* request, unsigned int displayId);
-    bool getSpeakRequestInfo(unsigned int displayId, SpeakRequestInfo& info);
-    void updateSpeakRequestInfo(unsigned int displayId, MsgStatus_t msgStatus);
-    void removeSpeakRequestInfo(unsigned int displayId);
+    // Each voice of a display runs at most one request at a time
+    void saveSpeakRequestInfo(SpeakRequest* request, unsigned int displayId,
+            AudioVoice voice = VOICE_SPEECH);
+    bool getSpeakRequestInfo(unsigned int displayId, SpeakRequestInfo& info,
+            AudioVoice voice = VOICE_SPEECH);
+    void updateSpeakRequestInfo(unsigned int displayId, MsgStatus_t msgStatus,
+            AudioVoice voice = VOICE_SPEECH);
+    void removeSpeakRequestInfo(unsigned int displayId,
+            AudioVoice voice = VOICE_SPEECH);
+    unsigned int getDisplayCount() const;
+    pbnjson::JValue getMetrics(unsigned int displayId) const;
+    // Thread count, RSS and context switches of the whole process
+    pbnjson::JValue getProcessMetrics() const;
+    const AudioTap* getAudioTap(unsigned int displayId) const;
+    bool isReactorMode() const;
+    // Called from the thread running the request whenever a display's task
+    // status or current language may have changed; set before requests run
+    void setStatusListener(std::function<void(unsigned int)> listener);
 private:
-    std::shared_ptr<TTSEngine> mTTSEngine[DUAL_DISPLAYS] = {nullptr};
-    std::shared_ptr<AudioEngine> mAudioEngine[DUAL_DISPLAYS] = {nullptr};
+    struct DisplayState
+    {
+        // Written by the dispatchers, read by getStatus on the main loop
+        std::mutex statusMutex;
+        Task_Status_t eTaskStatus = TTS_TASK_NOT_READY;
+        std::string currentLanguage = "en-US";
+        std::mutex runningInfoMutex;
+        bool hasSpeakRequestInfo[VOICE_COUNT] = {};
+        SpeakRequestInfo speakRequestInfo[VOICE_COUNT];
+        ProcessStats utteranceStats;
+        // Time to synthesize, network round trip included
+        LatencyHistogram synthesis;
+    };
+
+    void beginSpeak(SpeakRequest* pSpeakRequest, unsigned int displayId);
+    void finishSpeak(SpeakRequest* pSpeakRequest, unsigned int displayId,
+            int ttsRet, bool audioRet);
+    static AudioVoice getVoice(SpeakRequest* pSpeakRequest);
+
+    // Engines are shared by every display, each display keeps its own state
+    std::shared_ptr<TTSEngine> mTTSEngine = {nullptr};
+    std::shared_ptr<AudioEngine> mAudioEngine = {nullptr};
     TTSConfig* mConfigHandler = {nullptr};
     pbnjson::JValue mTTSEngineName;
     pbnjson::JValue mAudioEngineName;
     pbnjson::JValue mDisplayCount;
-    Task_Status_t meTTSTaskStatus[DUAL_DISPLAYS];
-    std::string mCurrentLanguage[DUAL_DISPLAYS];
-    std::map<unsigned int, SpeakRequestInfo> mSpeakRequestInfoMap;
-    std::mutex mRunningInfoMutex[DUAL_DISPLAYS];
+    std::vector<std::unique_ptr<DisplayState>> mDisplays;
+    // Queues, synthesis and playback all run on the main loop thread
+    bool mReactorMode = false;
+    std::function<void(unsigned int)> mStatusListener;
+    // metrics.utteranceStats: read /proc around every utterance, for
+    // measurements only
+    bool mUtteranceStats = false;
+    // Sampled when an utterance finishes, while its threads still exist
+    std::atomic<int> mPeakThreads {0};
+    std::atomic<unsigned int> mUtterances {0};
 };
 
 #endif /* SRC_CORE_ENGINEHANDLER_H_ */
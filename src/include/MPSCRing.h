@@ -0,0 +1,105 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SRC_INCLUDE_MPSCRING_H_
+#define SRC_INCLUDE_MPSCRING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#define MPSC_CACHE_LINE 64
+
+// Bounded lock-free ring for many producers and one consumer, based on
+// Dmitry Vyukov's bounded queue. Each cell carries a sequence number so a
+// producer claims a slot with a single CAS and publishes it with a release
+// store; the consumer never writes a shared index. push() fails instead of
+// waiting when the ring is full.
+template <typename T>
+class MPSCRing
+{
+public:
+    explicit MPSCRing(size_t capacity) : mDequeuePos(0)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+        mMask = size - 1;
+        mBuffer.reset(new Cell[size]);
+        for (size_t i = 0; i < size; i++)
+            mBuffer[i].sequence.store(i, std::memory_order_relaxed);
+        mEnqueuePos.store(0, std::memory_order_relaxed);
+    }
+
+    MPSCRing(const MPSCRing&) = delete;
+    MPSCRing& operator=(const MPSCRing&) = delete;
+
+    // Safe from any thread
+    bool push(const T& value)
+    {
+        Cell* cell;
+        size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &mBuffer[pos & mMask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t) sequence - (intptr_t) pos;
+            if (diff == 0) {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1,
+                        std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Only one thread at a time may consume
+    bool pop(T& value)
+    {
+        Cell* cell = &mBuffer[mDequeuePos & mMask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        if ((intptr_t) sequence - (intptr_t) (mDequeuePos + 1) < 0)
+            return false;
+        value = cell->value;
+        cell->sequence.store(mDequeuePos + mMask + 1, std::memory_order_release);
+        ++mDequeuePos;
+        return true;
+    }
+
+    size_t capacity() const { return mMask + 1; }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> mBuffer;
+    size_t mMask;
+    char mPad0[MPSC_CACHE_LINE];
+    std::atomic<size_t> mEnqueuePos;
+    char mPad1[MPSC_CACHE_LINE];
+    size_t mDequeuePos;
+};
+
+#endif /* SRC_INCLUDE_MPSCRING_H_ */
@@ -0,0 +1,49 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SRC_INCLUDE_POLYPHASERESAMPLER_H_
+#define SRC_INCLUDE_POLYPHASERESAMPLER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define RESAMPLER_DEFAULT_TAPS 32
+
+// Rational L/M resampler for mono S16: a Kaiser windowed sinc prototype split
+// into L phases, so each output sample costs one taps long dot product.
+// Works on whole utterances, the filter delay is compensated.
+class PolyphaseResampler
+{
+public:
+    PolyphaseResampler(unsigned int inRate, unsigned int outRate,
+            unsigned int taps = RESAMPLER_DEFAULT_TAPS);
+
+    void process(const int16_t* in, size_t count, std::vector<int16_t>& out) const;
+    unsigned int getInRate() const { return mInRate; }
+    unsigned int getOutRate() const { return mOutRate; }
+
+private:
+    unsigned int mInRate;
+    unsigned int mOutRate;
+    unsigned int mUp;
+    unsigned int mDown;
+    unsigned int mTaps;
+    // mUp phases of mTaps coefficients, stored reversed for the dot product
+    std::vector<float> mPhases;
+};
+
+#endif /* SRC_INCLUDE_POLYPHASERESAMPLER_H_ */
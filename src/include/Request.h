@@ -17,6 +17,7 @@
 #ifndef SRC_INCLUDE_REQUEST_H_
 #define SRC_INCLUDE_REQUEST_H_
 
+#include <functional>
 #include <TTSRequestTypes.h>
 
 class Request
@@ -25,6 +26,8 @@ public:
     virtual ~Request() = default;
     virtual REQUEST_TYPE getType() = 0;
     virtual bool execute() = 0;
+    // Reactor mode: done may run later from the main loop
+    virtual void executeAsync(std::function<void(bool)> done) { done(execute()); }
     virtual RequestType* getRequest() = 0;
 };
 
@@ -18,6 +18,7 @@
 #define SRC_CORE_REQUESTHANDLER_H_
 
 #include <memory>
+#include <set>
 #include <vector>
 #include <EngineHandler.h>
 #include <RequestQueue.h>
@@ -29,17 +30,31 @@ public:
     RequestHandler(std::shared_ptr<EngineHandler> engineHandler);
     virtual ~RequestHandler(){};
     bool sendRequest(TTSRequest* request, unsigned int displayId);
+    // Speak requests of one batch, queued together; deleted on failure
+    bool sendBatch(std::vector<TTSRequest*>& requests, unsigned int displayId);
+    // Speak requests waiting on the display, urgent ones included
+    size_t getQueueDepth(unsigned int displayId);
     void start();
     void stop();
 
 private:
+    // Independent speak/alert/control queues for one display output
+    struct DisplayPipeline
+    {
+        DisplayPipeline(unsigned int displayId, size_t ingressCapacity);
+        RequestQueue speakQueue;
+        // Urgent speak requests, mixed over speakQueue's playback
+        RequestQueue alertQueue;
+        RequestQueue controlQueue;
+    };
+
     bool CheckToStopRunningSpeak(SpeakRequestInfo& runningRequest, TTSRequest* pRequest);
+    void clearSpeech(unsigned int displayId);
     void stopSpeech(unsigned int displayId);
-    RequestQueue mSpeakRequestQueueDisplay1;
-    RequestQueue mSpeakRequestQueueDisplay2;
-    RequestQueue mControlRequestQueueDisplay1;
-    RequestQueue mControlRequestQueueDisplay2;
+    DisplayPipeline* getPipeline(unsigned int displayId);
+    std::vector<std::unique_ptr<DisplayPipeline>> mPipelines;
     std::shared_ptr<EngineHandler> mEngineHandler;
+    std::set<std::string> mCoalesceApps;
 };
 
 #endif /* SRC_CORE_REQUESTHANDLER_H_ */
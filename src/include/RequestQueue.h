@@ -17,35 +17,81 @@
 #ifndef REQUESTQUEUE_H_
 #define REQUESTQUEUE_H_
 
-#include <vector>
+#include <atomic>
+#include <list>
+#include <unordered_map>
 #include <thread>
 #include <mutex>
-#include <condition_variable>
+#include <vector>
+#include <glib.h>
+#include <MPSCRing.h>
 #include <Request.h>
+#include <TimerWheel.h>
 #include <TTSLog.h>
 
+#define DEFAULT_INGRESS_CAPACITY 256
+
 class TTSRequest;
 class RequestQueue
 {
 public:
     RequestQueue();
-    RequestQueue(std::string name);
+    RequestQueue(std::string name, size_t ingressCapacity = DEFAULT_INGRESS_CAPACITY);
     virtual ~RequestQueue();
-    void addRequest(Request* request);
+    bool addRequest(Request* request);
+    // All in order with nothing in between, after anything added before
+    void addRequests(const std::vector<Request*>& requests);
     void start();
+    void attachToMainLoop();
     void stop();
     bool removeRequest(std::string sAppID, std::string sMsgID);
     void clearQueue();
+    // Requests waiting, the one being executed is not counted. Lock-free,
+    // it may briefly count a request that is still being added.
+    size_t pendingCount() const;
 
 private:
     void dispatchHandler();
-    void setRequestStatus(Request* request);
+    void wakeDispatcher();
+    void waitForRequest(int timeoutMs);
+    Request* takeNextRequest(bool pop, std::vector<Request*>& replaced,
+            std::vector<Request*>& expired, int& timeoutMs);
+    bool dropIfExpired(Request* request);
+    void drainIngress(std::vector<Request*>& replaced);
+    void enqueueRequest(Request* request, std::vector<Request*>& replaced);
+    void takeExpiredRequests(std::vector<Request*>& expired);
+    void unindexRequest(Request* request);
+    void notifyAndDelete(std::vector<Request*>& requests, MsgStatus_t status);
+    void setRequestStatus(Request* request, MsgStatus_t status = TTS_MSG_CANCEL);
+    // Reactor mode: the eventfd and expiry timer are main loop sources and
+    // requests run through executeAsync(), one at a time
+    void reactorDispatch();
+    void armReactorTimer(int timeoutMs);
+    void scheduleReactorDispatch();
+    static gboolean onIngressReady(gint fd, GIOCondition condition, gpointer data);
+    // Stands in for onIngressReady when the eventfd could not be created
+    static gboolean onReactorPoll(gpointer data);
+    static gboolean onReactorTimer(gpointer data);
+    static gboolean onReactorIdle(gpointer data);
     volatile bool mQuit;
     std::string mName;
     std::thread mDispatcherThread;
-    std::vector<Request*> mRequestQueue;
+    bool mReactor = false;
+    bool mBusy = false;
+    guint mFdSource = 0;
+    guint mTimerSource = 0;
+    guint mIdleSource = 0;
+    // Producers only touch mIngress and mEventFd. Everything below mMutex is
+    // owned by the consumer side, which also serializes mIngress.pop().
+    MPSCRing<Request*> mIngress;
+    int mEventFd;
     std::mutex mMutex;
-    std::condition_variable mCondVar;
+    std::list<Request*> mRequestQueue;
+    TimerWheel<Request*> mExpiryWheel;
+    std::unordered_map<std::string, std::list<Request*>::iterator> mCoalesceIndex;
+    // Requests in mIngress and mRequestQueue, raised by producers before
+    // they publish and lowered by the consumer side as requests leave
+    std::atomic<size_t> mPending {0};
 };
 
 #endif /* REQUESTQUEUE_H_ */
@@ -0,0 +1,92 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef SRC_INCLUDE_SPSCRING_H_
+#define SRC_INCLUDE_SPSCRING_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#define SPSC_CACHE_LINE 64
+
+// Lock-free ring for exactly one producer thread and one consumer thread.
+// Capacity is rounded up to a power of two. Items are moved out on pop, so
+// a slot does not keep a shared_ptr alive until it is overwritten.
+template <typename T>
+class SPSCRing
+{
+public:
+    explicit SPSCRing(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+        mBuffer.resize(size);
+        mMask = size - 1;
+    }
+
+    SPSCRing(const SPSCRing&) = delete;
+    SPSCRing& operator=(const SPSCRing&) = delete;
+
+    // Producer side, returns how many items fitted
+    size_t push(const T* data, size_t count)
+    {
+        size_t head = mHead.load(std::memory_order_relaxed);
+        size_t tail = mTail.load(std::memory_order_acquire);
+        count = std::min(count, capacity() - (head - tail));
+        size_t first = std::min(count, capacity() - (head & mMask));
+        std::copy(data, data + first, &mBuffer[head & mMask]);
+        std::copy(data + first, data + count, &mBuffer[0]);
+        mHead.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side, returns how many items were taken
+    size_t pop(T* data, size_t count)
+    {
+        size_t tail = mTail.load(std::memory_order_relaxed);
+        size_t head = mHead.load(std::memory_order_acquire);
+        count = std::min(count, head - tail);
+        size_t first = std::min(count, capacity() - (tail & mMask));
+        std::move(&mBuffer[tail & mMask], &mBuffer[tail & mMask] + first, data);
+        std::move(&mBuffer[0], &mBuffer[0] + (count - first), data + first);
+        mTail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // A snapshot when called from the other side
+    size_t size() const
+    {
+        return mHead.load(std::memory_order_acquire) - mTail.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return mMask + 1; }
+
+private:
+    std::vector<T> mBuffer;
+    size_t mMask;
+    char mPad0[SPSC_CACHE_LINE];
+    // Written by the producer only
+    std::atomic<size_t> mHead { 0 };
+    char mPad1[SPSC_CACHE_LINE];
+    // Written by the consumer only
+    std::atomic<size_t> mTail { 0 };
+};
+
+#endif /* SRC_INCLUDE_SPSCRING_H_ */
@@ -0,0 +1,46 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef SRC_INCLUDE_SILENCETRIMMER_H_
+#define SRC_INCLUDE_SILENCETRIMMER_H_
+
+#include <cstddef>
+#include <TTSConfig.h>
+
+#define DEFAULT_TRIM_THRESHOLD_DB -50
+#define DEFAULT_TRIM_PAD_MS 30
+#define TRIM_WINDOW_MS 10
+
+// Finds the speech in a synthesized utterance so the near silence around
+// it can be cut down to a pad. A 10 ms window is speech once its mean
+// energy reaches the threshold, in dB relative to full scale.
+class SilenceTrimmer
+{
+public:
+    // "trim" config section
+    void loadConfig(const TTSConfig& config);
+    // Range [begin, end) to keep; all of it when disabled or all silent
+    void findSpeech(const float* samples, size_t count, unsigned int rate,
+            size_t& begin, size_t& end) const;
+
+private:
+    bool mEnabled = true;
+    int mThresholdDb = DEFAULT_TRIM_THRESHOLD_DB;
+    unsigned int mPadMs = DEFAULT_TRIM_PAD_MS;
+};
+
+#endif /* SRC_INCLUDE_SILENCETRIMMER_H_ */
@@ -0,0 +1,52 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SRC_INCLUDE_SPEECHDECODER_H_
+#define SRC_INCLUDE_SPEECHDECODER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <PolyphaseResampler.h>
+#include <SilenceTrimmer.h>
+
+// Files without a WAV header are raw PCM in this format
+#define RAW_PCM_RATE 22050
+#define RAW_PCM_CHANNELS 1
+
+// Turns a synthesized utterance (16 bit WAV or raw PCM) into mono float
+// samples at an output rate, trimming the silence around the speech. Keeps
+// the last resampler for the next call.
+class SpeechDecoder
+{
+public:
+    static bool readFile(const std::string& path, std::vector<uint8_t>& data);
+    // silence: frames of silence put in front of the utterance
+    bool decode(const uint8_t* data, size_t size, unsigned int outRate,
+            std::vector<float>& samples, size_t silence = 0);
+    void setTrimmer(const SilenceTrimmer& trimmer) { mTrimmer = trimmer; }
+    // Milliseconds the last decode() trimmed off
+    unsigned int getTrimmedMs() const { return mTrimmedMs; }
+
+private:
+    std::unique_ptr<PolyphaseResampler> mResampler;
+    SilenceTrimmer mTrimmer;
+    unsigned int mTrimmedMs = 0;
+};
+
+#endif /* SRC_INCLUDE_SPEECHDECODER_H_ */
@@ -0,0 +1,91 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef SRC_INCLUDE_SPEECHSTREAM_H_
+#define SRC_INCLUDE_SPEECHSTREAM_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <SPSCRing.h>
+#include <TTSConfig.h>
+
+#define DEFAULT_STREAM_DEPTH_MS 400
+#define DEFAULT_STREAM_LOW_WATERMARK_MS 100
+#define DEFAULT_STREAM_HIGH_WATERMARK_MS 300
+
+// Ring sizes in milliseconds of audio, from the "stream" config section
+struct StreamLimits
+{
+    unsigned int depthMs = DEFAULT_STREAM_DEPTH_MS;
+    unsigned int lowWatermarkMs = DEFAULT_STREAM_LOW_WATERMARK_MS;
+    unsigned int highWatermarkMs = DEFAULT_STREAM_HIGH_WATERMARK_MS;
+};
+
+// Carries one decoded utterance from the thread that plays it to the
+// output's render thread. The producer tops the ring up to the high
+// watermark and sleeps on an eventfd until it drains to the low one; the
+// render thread reads and signals it without taking a lock.
+class SpeechStream
+{
+public:
+    SpeechStream(std::vector<float> samples, const StreamLimits& limits, unsigned int rate);
+    ~SpeechStream();
+    SpeechStream(const SpeechStream&) = delete;
+    SpeechStream& operator=(const SpeechStream&) = delete;
+    static StreamLimits loadLimits(const TTSConfig& config);
+
+    // Producer side: pushes up to the high watermark, true once all is in
+    // or the stream was aborted
+    bool feed();
+    // Producer side: false once the stream was aborted
+    bool waitForSpace();
+    // Feeds the stream from GLib timeouts, for reactor mode
+    static void feedOnMainLoop(std::shared_ptr<SpeechStream> stream);
+
+    // Render side: always fills frames until the producer finished, with
+    // silence for an underrun. Returns fewer only at the end.
+    size_t read(float* out, size_t frames);
+    bool isDrained() const;
+    // Nothing buffered yet more to come
+    bool isStarved() const;
+
+    // Either side, wakes a waiting producer
+    void abort();
+    unsigned long getUnderruns() const { return mUnderruns.load(); }
+
+private:
+    void wake();
+
+    SPSCRing<float> mRing;
+    size_t mLowWatermark;
+    size_t mHighWatermark;
+    unsigned int mFeedIntervalMs;
+    // Producer only
+    std::vector<float> mSamples;
+    size_t mFed = 0;
+
+    std::atomic<bool> mFinished { false };
+    std::atomic<bool> mAborted { false };
+    std::atomic<bool> mWaiting { false };
+    std::atomic<unsigned long> mUnderruns { 0 };
+    // Written to wake the producer, -1 if it could not be created
+    int mWakeFd = -1;
+};
+
+#endif /* SRC_INCLUDE_SPEECHSTREAM_H_ */
@@ -17,6 +17,7 @@
 #ifndef SRC_CORE_TTSENGINE_H_
 #define SRC_CORE_TTSENGINE_H_
 
+#include <functional>
 #include <string>
 #include <luna-service2/lunaservice.hpp>
 
@@ -27,12 +28,22 @@ public:
     virtual ~TTSEngine() = default;
     virtual void getStatus() = 0;
     virtual void getSupportedLanguages(std::vector<std::string> &  vecLang, unsigned int displayId) = 0;
-    virtual int speak(const std::string text, LSHandle* sh, std::string language, unsigned int displayId) = 0;
+    virtual int speak(const std::string& text, LSHandle* sh, const std::string& language, unsigned int displayId) = 0;
+    // Reactor mode: must not block the main loop. Engines without an async
+    // path fall back to the blocking speak().
+    virtual void speakAsync(const std::string& text, LSHandle* sh, const std::string& language,
+            unsigned int displayId, std::function<void(int)> done)
+    {
+        done(speak(text, sh, language, displayId));
+    }
+    // Hint that text is likely spoken next into the same slot. An engine
+    // may start synthesizing it now and hand the result to speak().
+    virtual void prefetch(const std::string& text, const std::string& language, unsigned int displayId) {}
     virtual double getPitch(void) const = 0;
     virtual double getSpeakRate(void) const = 0;
     virtual void start() = 0;
     virtual void stop(unsigned int displayId) = 0;
-    virtual void init() = 0;
+    virtual void init(unsigned int displayCount) = 0;
     virtual void deInit() = 0;
     virtual std::string getName()=0;
 };
@@ -43,6 +43,7 @@ enum TTSErrors
     INVALID_JSON_FORMAT,
     INPUT_TEXT_EMPTY,
     ERROR_NONE,
+    INVALID_PLAYBACK_STATE,
     TTS_ERROR_NOT_SUPPORTED = 8282,
 };
 
@@ -78,6 +79,7 @@ static std::map<int, std::string> mTTSErrorTextTable =
         { INVALID_JSON_FORMAT, "Invalid JSON format" },
         { INPUT_TEXT_EMPTY, "Input text must not be empty" },
         { ERROR_NONE, "No error" },
+        { INVALID_PLAYBACK_STATE, "Nothing to pause or resume" },
 };
 std::string getTTSErrorString(int errorCode);
 }
@@ -28,6 +28,8 @@
 #define MSGID_ENGINE_HANDLER            "ENGINE_HANDLER"
 #define MSGID_REQUEST_HANDLER           "REQUEST_HANDLER"
 #define MSGID_REQUEST_QUEUE             "REQUEST_QUEUE"
+#define MSGID_THREAD_POLICY             "THREAD_POLICY"
+#define MSGID_AUDIO_TAP                 "AUDIO_TAP"
 
 //#ifdef USE_PMLOG
 #include "PmLogLib.h"
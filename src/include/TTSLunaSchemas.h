@@ -0,0 +1,44 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef SRC_INCLUDE_TTSLUNASCHEMAS_H_
+#define SRC_INCLUDE_TTSLUNASCHEMAS_H_
+
+#include <TTSLunaUtils.h>
+
+// Request schemas of the Luna methods, compiled once by TTSLunaService
+#define SPEAK_SCHEMA STRICT_SCHEMA(PROPS_12(PROP(text, string), PROP(clear, boolean), PROP(urgent, boolean), \
+        PROP(subscribe, boolean), PROP(appID, string), PROP(feedback, boolean), PROP(language, string), \
+        PROP(displayId, integer), PROP(expiresIn, integer), PROP(deadline, integer), PROP(coalesce, boolean), \
+        PROP(coalesceKey, string))REQUIRED_1(text))
+
+#define STOP_SCHEMA STRICT_SCHEMA(PROPS_4(PROP(msgID, string), PROP(appID, string), PROP(fadeOut, boolean), \
+        PROP(displayId, integer)))
+
+// pause, resume, getAvailableLanguages, getMetrics and getAudioTap
+#define DISPLAY_SCHEMA STRICT_SCHEMA(PROPS_1(PROP(displayId, integer)))
+
+#define SPEAK_BATCH_SCHEMA STRICT_SCHEMA(PROPS_7(OBJARRAY(items, STRICT_SCHEMA(PROPS_7(PROP(text, string), \
+        PROP(language, string), PROP(feedback, boolean), PROP(expiresIn, integer), PROP(deadline, integer), \
+        PROP(coalesce, boolean), PROP(coalesceKey, string))REQUIRED_1(text))), PROP(appID, string), \
+        PROP(displayId, integer), PROP(clear, boolean), PROP(urgent, boolean), PROP(subscribe, boolean), \
+        PROP(language, string))REQUIRED_1(items))
+
+#define STATUS_SCHEMA STRICT_SCHEMA(PROPS_2(PROP(displayId, integer), PROP(subscribe, boolean)))
+
+#endif /* SRC_INCLUDE_TTSLUNASCHEMAS_H_ */
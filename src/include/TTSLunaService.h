@@ -17,6 +17,8 @@
 #ifndef SRC_LUNA_TTSLUNASERVICE_H_
 #define SRC_LUNA_TTSLUNASERVICE_H_
 
+#include <atomic>
+#include <glib.h>
 #include <luna-service2/lunaservice.hpp>
 
 #include <EngineHandler.h>
@@ -34,9 +36,14 @@ public:
     virtual ~TTSLunaService();
     void init();
     bool speak(LSMessage &message);
+    bool speakBatch(LSMessage &message);
     bool stop(LSMessage &message);
+    bool pause(LSMessage &message);
+    bool resume(LSMessage &message);
     bool getAvailableLanguages(LSMessage &message);
     bool getStatus(LSMessage &message);
+    bool getMetrics(LSMessage &message);
+    bool getAudioTap(LSMessage &message);
     bool setParameters(LSMessage &message);
 
 private :
@@ -44,10 +51,46 @@ private :
     std::shared_ptr<EngineHandler> mEngineHandler;
     Parameters *mParameterList;
     static LSHandle *lsHandle;
+    // Compiled once when the service is created, shared by every call
+    const pbnjson::JSchemaFragment mSpeakSchema;
+    const pbnjson::JSchemaFragment mStopSchema;
+    const pbnjson::JSchemaFragment mDisplaySchema;
+    const pbnjson::JSchemaFragment mBatchSchema;
+    const pbnjson::JSchemaFragment mStatusSchema;
+    // Kept current by subscriptions so getStatus can answer right away
+    struct SystemState
+    {
+        bool volumeKnown = false;
+        int volume = 0;
+        bool menuLanguageKnown = false;
+        std::string menuLanguage;
+        LSMessageToken volumeToken = LSMESSAGE_TOKEN_INVALID;
+        LSMessageToken settingsToken = LSMESSAGE_TOKEN_INVALID;
+        void *audioCookie = nullptr;
+        void *settingsCookie = nullptr;
+    };
+    SystemState mSystemState;
+    // What getStatus subscribers of a display were last sent
+    struct StatusFeed
+    {
+        bool pushed = false;
+        std::string status;
+        std::string language;
+        int volume = 0;
+        unsigned int queueDepth = 0;
+        gint64 lastPushUs = 0;
+    };
+    std::vector<StatusFeed> mStatusFeeds;
+    // Set from any thread, checks run on the main loop
+    std::atomic<bool> mStatusCheckPending {false};
+    guint mStatusTimer = 0;
+    gint64 mStatusTimerDueUs = 0;
+    unsigned int mStatusIntervalMs = 0;
 
     void registerService();
     static void responseCallback(Parameters* paramList, LS::Message& message);
-    void addParameters(LSMessage &message);
+    void addParameters(LSMessage &message, const pbnjson::JValue &requestObj);
+    bool sendPauseRequest(LSMessage &message, REQUEST_TYPE type);
     bool addSubscription(LSHandle *sh, LSMessage *message, std::string key);
     void setLSHandle(LSHandle* handle);
 
@@ -56,6 +99,21 @@ private :
     static bool handle_getVolume_callback(LSHandle *sh, LSMessage *reply, void *ctx);
     static bool handle_getSettings_callback(LSHandle *sh, LSMessage *reply, void *ctx);
     static void finalize_getstatus_request(GetStatusRequest*, bool status);
+    static bool parseVolume(LSMessage *message, int& volume);
+    static bool parseMenuLanguage(LSMessage *message, std::string& menuLanguage);
+    void subscribeSystemState();
+    bool readStatus(unsigned int displayId, TTSStatus& status);
+    void recordStatus(unsigned int displayId, const TTSStatus& status);
+    void scheduleStatusCheck();
+    void pushStatusChanges();
+    static pbnjson::JValue statusToJson(const TTSStatus& status);
+    static gboolean onStatusCheck(gpointer data);
+    static gboolean onStatusTimer(gpointer data);
+    void unsubscribeSystemState();
+    static bool handle_audioServerStatus(LSHandle *sh, const char *serviceName, bool connected, void *ctx);
+    static bool handle_settingsServerStatus(LSHandle *sh, const char *serviceName, bool connected, void *ctx);
+    static bool handle_volumeChanged(LSHandle *sh, LSMessage *reply, void *ctx);
+    static bool handle_settingsChanged(LSHandle *sh, LSMessage *reply, void *ctx);
 };
 #endif /* SRC_LUNA_TTSLUNASERVICE_H_ */
 
@@ -17,11 +17,14 @@
 #ifndef SRC_INCLUDE_TTSLUNAUTILS_H_
 #define SRC_INCLUDE_TTSLUNAUTILS_H_
 
+#include <chrono>
+#include <cstring>
 #include <random>
 #include <string>
 #include <pbnjson.hpp>
 #include <luna-service2/lunaservice.hpp>
 #include <TTSErrors.h>
+#include <TTSParameters.h>
 
 #define LS_CATEGORY_TABLE_NAME(name) name##_table
 
@@ -55,6 +58,9 @@
 #define PROPS_7(p1, p2, p3, p4, p5, p6, p7)           ",\"properties\":{" p1 "," p2 "," p3 "," p4 "," p5 "," p6 "," p7 "}"
 #define PROPS_8(p1, p2, p3, p4, p5, p6, p7, p8)       ",\"properties\":{" p1 "," p2 "," p3 "," p4 "," p5 "," p6 "," p7 "," p8 "}"
 #define PROPS_9(p1, p2, p3, p4, p5, p6, p7, p8, p9)   ",\"properties\":{" p1 "," p2 "," p3 "," p4 "," p5 "," p6 "," p7 "," p8 "," p9 "}"
+#define PROPS_10(p1, p2, p3, p4, p5, p6, p7, p8, p9, p10)  ",\"properties\":{" p1 "," p2 "," p3 "," p4 "," p5 "," p6 "," p7 "," p8 "," p9 "," p10 "}"
+#define PROPS_11(p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11)  ",\"properties\":{" p1 "," p2 "," p3 "," p4 "," p5 "," p6 "," p7 "," p8 "," p9 "," p10 "," p11 "}"
+#define PROPS_12(p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12)  ",\"properties\":{" p1 "," p2 "," p3 "," p4 "," p5 "," p6 "," p7 "," p8 "," p9 "," p10 "," p11 "," p12 "}"
 #define REQUIRED_1(p1)                                ",\"required\":[\"" #p1 "\"]"
 #define REQUIRED_2(p1, p2)                            ",\"required\":[\"" #p1 "\",\"" #p2 "\"]"
 #define REQUIRED_3(p1, p2, p3)                        ",\"required\":[\"" #p1 "\",\"" #p2 "\",\"" #p3 "\"]"
@@ -123,15 +129,10 @@ inline bool parsePayload(const std::string &payload, pbnjson::JValue &object)
 }
 
 
-inline bool parsePayload(const std::string &payload, pbnjson::JValue &object, const std::string &schema, int *error)
+// Takes a schema compiled ahead of time, so a call pays for parsing only
+inline bool parsePayload(const std::string &payload, pbnjson::JValue &object, const pbnjson::JSchema &parseSchema,
+                         int *error)
 {
-    pbnjson::JSchema parseSchema = pbnjson::JSchema::AllSchema();
-
-    if (schema.length() > 0)
-    {
-        parseSchema = pbnjson::JSchemaFragment(schema);
-    }
-
     pbnjson::JDomParser parser;
 
     if (!parser.parse(payload, parseSchema))
@@ -155,6 +156,85 @@ inline bool parsePayload(const std::string &payload, pbnjson::JValue &object, co
     return true;
 }
 
+inline bool parsePayload(const std::string &payload, pbnjson::JValue &object, const std::string &schema, int *error)
+{
+    if (schema.empty())
+        return parsePayload(payload, object, pbnjson::JSchema::AllSchema(), error);
+    return parsePayload(payload, object, pbnjson::JSchemaFragment(schema), error);
+}
+
+// Fills the speak fields of params from a parsed speak payload. Stops after
+// the text when it is empty; returns false when the language is not supported.
+inline bool parseSpeakParameters(const pbnjson::JValue &requestObj, Parameters &params)
+{
+    int displayId = 0;
+    int lCount;
+
+    (void) requestObj["text"].asString(params.sText);
+    if (params.sText.empty())
+        return true;
+    params.bFeedback = requestObj["feedback"].asBool();
+    params.eStatus = TTS_MSG_ERROR;
+    params.sAppID = requestObj["appID"].asString();
+    (void) requestObj["displayId"].asNumber(displayId);
+    params.displayId = displayId;
+    params.eTaskStatus = TTS_TASK_NOT_READY;
+    params.eLang = LANG_ENUS;
+    params.sLangStr = "en-US";
+
+    bool languageSupported = true;
+    std::string sInputLang = requestObj["language"].asString();
+    if (!sInputLang.empty())
+    {
+        for (lCount = 0; lCount < LANG_MAX; lCount++)
+        {
+            if (!strcmp(TTSLanguageTable[lCount].languageStr.c_str(), sInputLang.c_str()))
+            {
+                params.eLang = TTSLanguageTable[lCount].ttsLanguage;
+                params.sLangStr = sInputLang;
+                break;
+            }
+        }
+
+        if (lCount == LANG_MAX)
+        {
+            params.eLang = LANG_ERR;
+            languageSupported = false;
+        }
+    }
+
+    params.bClear = requestObj["clear"].asBool();
+    params.bUrgent = requestObj["urgent"].asBool();
+    params.bHasNext = false;
+    params.batchIndex = 0;
+    params.sCoalesceKey = requestObj["coalesceKey"].asString();
+    params.bCoalesce = requestObj["coalesce"].asBool() || !params.sCoalesceKey.empty();
+
+    // expiresIn is relative in ms, deadline is absolute epoch time in ms;
+    // both end up on the steady clock the queue expires requests with
+    params.bExpires = false;
+    auto now = std::chrono::steady_clock::now();
+    int64_t expiresIn = 0;
+    if (requestObj.hasKey("expiresIn") && requestObj["expiresIn"].asNumber(expiresIn) == CONV_OK)
+    {
+        params.bExpires = true;
+        params.tExpiry = now + std::chrono::milliseconds(expiresIn);
+    }
+    int64_t deadline = 0;
+    if (requestObj.hasKey("deadline") && requestObj["deadline"].asNumber(deadline) == CONV_OK)
+    {
+        auto remaining = std::chrono::milliseconds(deadline)
+                - std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::system_clock::now().time_since_epoch());
+        auto expiry = now + remaining;
+        if (!params.bExpires || expiry < params.tExpiry)
+            params.tExpiry = expiry;
+        params.bExpires = true;
+    }
+
+    return languageSupported;
+}
+
 inline void respondWithError(LS::Message &message, const std::string &errorText, unsigned int errorCode = -1,
                              bool failedSubscription = false)
 {
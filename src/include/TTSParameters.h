@@ -17,14 +17,12 @@
 #ifndef TTSPARAMPOLICY_H_
 #define TTSPARAMPOLICY_H_
 
+#include <chrono>
 #include <string>
 
 #define GET_MSG_STATUS_TEXT(x) TTS_MsgStatusTable[(x)]
 #define GET_TASK_STATUS_TEXT(x) TTS_TaskStatusTable[(x)]
 
-#define DUAL_DISPLAYS 2
-#define DISPLAY_0 0 //Display One Functionality
-#define DISPLAY_1 1 //Display Two Functionality
 typedef enum _TTS_LANGUAGE_T
 {
     LANG_ERR = -1,
@@ -113,6 +111,7 @@ typedef enum MsgStatus
     TTS_MSG_STOP,
     TTS_MSG_CANCEL,
     TTS_MSG_ERROR,
+    TTS_MSG_EXPIRED,
 } MsgStatus_t;
 
 static std::string TTS_MsgStatusTable[] = {
@@ -121,6 +120,7 @@ static std::string TTS_MsgStatusTable[] = {
     "stopped",
     "canceled",
     "error",
+    "expired",
 };
 
 typedef enum Task_Status
@@ -144,6 +144,15 @@ typedef struct Parameters
     MsgStatus_t eStatus;
     Task_Status_t eTaskStatus;
     unsigned int displayId;
+    bool bExpires;
+    std::chrono::steady_clock::time_point tExpiry;
+    bool bCoalesce;
+    std::string sCoalesceKey;
+    bool bHasNext;          // another speak request was queued behind it on dequeue
+    bool bUrgent;           // mixed over ongoing speech, which is ducked
+    std::string sBatchID;   // set for items of one speakBatch call
+    unsigned int batchIndex;
+    std::string sLookahead; // text of the batch item that follows, same language
 }Parameters;
 
 static std::string TTS_TaskStatusTable[] = {
@@ -162,6 +171,7 @@ typedef struct TTSStatus
     int pitch;
     int speechRate;
     int volume;
+    unsigned int queueDepth;
 }TTSStatus;
 
 typedef bool (*pfnSetTraceSubscriptionCB)(Parameters* paramList);
@@ -29,8 +29,10 @@ public:
     REQUEST_TYPE getType();
     RequestType* getRequest();
     bool execute();
+    void executeAsync(std::function<void(bool)> done);
 
 private:
+    unsigned int getDisplayId();
     RequestType* mReqType;
     TTSRequest & operator = (const TTSRequest &rh)= delete;
     TTSRequest (const TTSRequest &rh)= delete;
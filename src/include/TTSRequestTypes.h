@@ -23,7 +23,7 @@
 
 enum REQUEST_TYPE
 {
-    SPEAK = 100, START, STOP, GET_STATUS, GET_LANGUAGES
+    SPEAK = 100, START, STOP, GET_STATUS, GET_LANGUAGES, PAUSE, RESUME
 };
 
 typedef struct RequestType
@@ -38,7 +38,6 @@ typedef struct SpeakRequest
     const REQUEST_TYPE commandId = SPEAK;
     Parameters* msgParameters;
     LSHandle* sh;
-    std::string text_to_speak;
     void (*replyCB)(Parameters* msgParameters, LS::Message &message);
     LS::Message message;
 } SpeakRequest;
@@ -56,8 +55,19 @@ typedef struct StopRequest
     std::string sAppID;
     std::string sMsgID;
     unsigned int displayId;
+    // Running voices the stop matched, set before it is queued
+    bool stopSpeech = true;
+    bool stopAlert = false;
 } StopRequest;
 
+// Used for both PAUSE and RESUME
+typedef struct PauseRequest
+{
+    explicit PauseRequest(REQUEST_TYPE type) : commandId(type) {}
+    const REQUEST_TYPE commandId;
+    unsigned int displayId = 0;
+} PauseRequest;
+
 typedef struct GetStatusRequest
 {
     const REQUEST_TYPE commandId = GET_STATUS;
@@ -21,13 +21,29 @@
 #include <pbnjson.hpp>
 #include <TTSErrors.h>
 
+// Process wide figures used to compare the execution modes
+struct ProcessStats
+{
+    int threads = 0;
+    long rssKb = 0;
+    long contextSwitches = 0;
+};
+
 class TTSUtils
 {
 private:
     TTSUtils();
 public:
     static TTSUtils& getInstance();
+    static std::string getAudioFilePath(unsigned int displayId);
+    // TTS engines and audio files are indexed by slot, one per display and voice
+    static unsigned int getVoiceSlot(unsigned int displayId, unsigned int voice,
+            unsigned int displayCount);
+    static bool getProcessStats(ProcessStats& stats);
+    void setDisplayCount(unsigned int displayCount);
     bool isValidDisplayId(LS::Message &request, pbnjson::JValue& requestObj, unsigned int &displayId);
+private:
+    unsigned int mDisplayCount;
 };
 
 #endif
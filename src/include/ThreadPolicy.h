@@ -0,0 +1,76 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef SRC_INCLUDE_THREADPOLICY_H_
+#define SRC_INCLUDE_THREADPOLICY_H_
+
+#include <sched.h>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <TTSConfig.h>
+
+#define DEFAULT_RT_PRIORITY 10
+
+enum ThreadRole
+{
+    THREAD_SYNTHESIS,
+    THREAD_RENDER,
+    THREAD_LUNA,
+    THREAD_ROLE_COUNT
+};
+
+// Scheduling class and CPU set per thread role, from the "threads" config
+// section. Threads apply their role themselves. A role without a realtime
+// policy or CPUs gets SCHED_OTHER and the process's CPU set, whatever the
+// thread inherited. What cannot be applied, for lack of privileges or
+// CPUs, is logged and left as it was.
+class ThreadPolicy
+{
+public:
+    // Loaded on first use
+    static const ThreadPolicy& get();
+    // Scheduling and CPU set of the calling thread
+    void apply(ThreadRole role) const;
+    // CPU set only, for threads whose scheduling someone else owns. tid 0
+    // is the calling thread; another one lets a realtime thread be pinned
+    // without doing the work itself.
+    void applyAffinity(ThreadRole role, pid_t tid = 0) const;
+
+private:
+    struct Settings
+    {
+        // "other", "fifo", "rr" or "rtkit"
+        std::string policy = "other";
+        int priority = DEFAULT_RT_PRIORITY;
+        std::vector<int> cpus;
+    };
+
+    ThreadPolicy();
+    void loadConfig(const TTSConfig& config);
+    bool setRealtime(const Settings& settings, std::string& error) const;
+    static bool setNormal(std::string& error);
+    void setAffinity(const Settings& settings, ThreadRole role, pid_t tid) const;
+    static void logApplied(ThreadRole role, pid_t tid);
+
+    Settings mSettings[THREAD_ROLE_COUNT];
+    // Taken before any role was applied
+    cpu_set_t mProcessCpus;
+    bool mHaveProcessCpus = false;
+};
+
+#endif /* SRC_INCLUDE_THREADPOLICY_H_ */
@@ -0,0 +1,132 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SRC_INCLUDE_TIMERWHEEL_H_
+#define SRC_INCLUDE_TIMERWHEEL_H_
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// Hashed timer wheel: schedule/cancel are O(1), advance() only visits the
+// slots of the ticks that elapsed. Not thread safe, callers serialize access.
+template <typename Key>
+class TimerWheel
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    TimerWheel(std::chrono::milliseconds tick, size_t slots) :
+            mSlots(slots), mTick(tick), mStart(Clock::now()), mCurrentTick(0) {
+    }
+
+    void schedule(const Key& key, Clock::time_point deadline)
+    {
+        cancel(key);
+        // Nothing advances an idle wheel, catch up before it is used again
+        if (mEntries.empty())
+            skipTo(Clock::now());
+        uint64_t expiryTick = mCurrentTick + 1;
+        if (deadline > mStart) {
+            uint64_t ticks = (deadline - mStart + mTick - Clock::duration(1)) / mTick;
+            if (ticks > expiryTick)
+                expiryTick = ticks;
+        }
+        Slot& slot = mSlots[expiryTick % mSlots.size()];
+        mEntries[key] = slot.insert(slot.end(), Entry { key, expiryTick });
+    }
+
+    bool cancel(const Key& key)
+    {
+        auto found = mEntries.find(key);
+        if (found == mEntries.end())
+            return false;
+        mSlots[found->second->expiryTick % mSlots.size()].erase(found->second);
+        mEntries.erase(found);
+        return true;
+    }
+
+    // Moves the wheel up to now and appends every key whose deadline passed.
+    void advance(Clock::time_point now, std::vector<Key>& expired)
+    {
+        if (now < mStart)
+            return;
+        uint64_t targetTick = (now - mStart) / mTick;
+        if (mEntries.empty()) {
+            skipTo(now);
+            return;
+        }
+        // A longer gap than one revolution visits every slot once instead
+        if (targetTick > mCurrentTick && targetTick - mCurrentTick > mSlots.size()) {
+            for (Slot& slot : mSlots)
+                expireSlot(slot, targetTick, expired);
+            mCurrentTick = targetTick;
+            return;
+        }
+        while (mCurrentTick < targetTick) {
+            ++mCurrentTick;
+            expireSlot(mSlots[mCurrentTick % mSlots.size()], mCurrentTick, expired);
+        }
+    }
+
+    bool empty() const { return mEntries.empty(); }
+
+    Clock::time_point nextTick() const
+    {
+        return mStart + mTick * (mCurrentTick + 1);
+    }
+
+private:
+    struct Entry
+    {
+        Key key;
+        uint64_t expiryTick;
+    };
+    typedef std::list<Entry> Slot;
+
+    void skipTo(Clock::time_point now)
+    {
+        if (now < mStart)
+            return;
+        uint64_t tick = (now - mStart) / mTick;
+        if (tick > mCurrentTick)
+            mCurrentTick = tick;
+    }
+
+    void expireSlot(Slot& slot, uint64_t tick, std::vector<Key>& expired)
+    {
+        auto it = slot.begin();
+        while (it != slot.end()) {
+            if (it->expiryTick <= tick) {
+                expired.push_back(it->key);
+                mEntries.erase(it->key);
+                it = slot.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    std::vector<Slot> mSlots;
+    std::unordered_map<Key, typename Slot::iterator> mEntries;
+    std::chrono::milliseconds mTick;
+    Clock::time_point mStart;
+    uint64_t mCurrentTick;
+};
+
+#endif /* SRC_INCLUDE_TIMERWHEEL_H_ */
@@ -0,0 +1,40 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SRC_INCLUDE_WAVHEADER_H_
+#define SRC_INCLUDE_WAVHEADER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#define WAV_FORMAT_PCM 1
+
+// Format and payload location of a RIFF/WAVE buffer
+struct WavHeader
+{
+    uint16_t audioFormat = 0;
+    uint16_t channels = 0;
+    uint32_t sampleRate = 0;
+    uint16_t bitsPerSample = 0;
+    size_t dataOffset = 0;
+    size_t dataSize = 0;
+};
+
+// False when the buffer does not start with a usable RIFF/WAVE header,
+// callers then treat it as raw PCM
+bool parseWavHeader(const uint8_t* data, size_t size, WavHeader& header);
+
+#endif /* SRC_INCLUDE_WAVHEADER_H_ */
@@ -15,14 +15,20 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <string>
+#include <unistd.h>
 #include <TTSErrors.h>
 #include <TTSLog.h>
+#include <TTSLunaSchemas.h>
 #include <TTSLunaService.h>
 #include <StatusHandler.h>
 #include <TTSUtils.h>
 
 #define GET_SYSTEM_SETTINGS  "luna://com.webos.service.settings/getSystemSettings"
 #define GET_VOLUME  "luna://com.webos.service.audio/master/getVolume"
+#define AUDIO_SERVICE  "com.webos.service.audio"
+#define SETTINGS_SERVICE  "com.webos.service.settings"
+#define SPEAK_BATCH_MAX_ITEMS 64
+#define DEFAULT_STATUS_UPDATES_PER_SEC 4
 
 const std::string service_name = "com.webos.service.tts";
 const double dTTSPitch = 0.0;
@@ -30,8 +36,39 @@ const double dTTSSpeechRate = 0.0;
 
 LSHandle* TTSLunaService::lsHandle = nullptr;
 
+static std::string statusSubscriptionKey(unsigned int displayId)
+{
+    return "getStatus/" + std::to_string(displayId);
+}
+
+// A deadline that has passed would expire the request as soon as it is queued
+static bool isPastDeadline(const pbnjson::JValue& requestObj)
+{
+    int64_t deadline = 0;
+    if (!requestObj.hasKey("deadline") || requestObj["deadline"].asNumber(deadline) != CONV_OK)
+        return false;
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    return deadline <= now;
+}
+
+static bool isSupportedLanguage(const std::string& language)
+{
+    for (int lCount = 0; lCount < LANG_MAX; lCount++)
+    {
+        if (TTSLanguageTable[lCount].languageStr == language)
+            return true;
+    }
+    return false;
+}
+
 TTSLunaService::TTSLunaService() :
-        LS::Handle(LS::registerService(service_name.c_str())) {
+        LS::Handle(LS::registerService(service_name.c_str())),
+        mSpeakSchema(SPEAK_SCHEMA),
+        mStopSchema(STOP_SCHEMA),
+        mDisplaySchema(DISPLAY_SCHEMA),
+        mBatchSchema(SPEAK_BATCH_SCHEMA),
+        mStatusSchema(STATUS_SCHEMA) {
     registerService();
     LOG_INFO(MSGID_LUNA_SERVICE, 0, "%s", __FUNCTION__);
 }
@@ -39,16 +76,34 @@ TTSLunaService::TTSLunaService() :
 void TTSLunaService::init() {
     TTSLunaService::lsHandle = this->get();
     mEngineHandler = std::make_shared<EngineHandler>();
+    TTSUtils::getInstance().setDisplayCount(mEngineHandler->getDisplayCount());
+    mStatusFeeds.resize(mEngineHandler->getDisplayCount());
+    double maxUpdates = DEFAULT_STATUS_UPDATES_PER_SEC;
+    pbnjson::JValue value;
+    if (mEngineHandler->getConfigValue("status", "maxUpdatesPerSec", value) && value.isNumber())
+        maxUpdates = value.asNumber<double>();
+    // Zero or less lifts the limit
+    mStatusIntervalMs = maxUpdates > 0 ? static_cast<unsigned int>(1000 / maxUpdates) : 0;
+    mEngineHandler->setStatusListener([this](unsigned int) {
+        scheduleStatusCheck();
+    });
+
     mRequestHandler = new (std::nothrow) RequestHandler(mEngineHandler);
     if (mRequestHandler)
         mRequestHandler->start();
+    subscribeSystemState();
 }
 
 TTSLunaService::~TTSLunaService() {
     LOG_INFO(MSGID_LUNA_SERVICE, 0, "%s", __FUNCTION__);
     StatusHandler::GetInstance()->Unregister(this);
+    unsubscribeSystemState();
     mRequestHandler->stop();
     delete mRequestHandler;
+    mEngineHandler->setStatusListener(nullptr);
+    // Pending status checks and the rate limit timer
+    while (g_source_remove_by_user_data(this))
+        ;
 }
 
 void TTSLunaService::registerService()
@@ -56,9 +111,14 @@ void TTSLunaService::registerService()
     LOG_DEBUG("Register Service\n");
     LS_CREATE_CATEGORY_BEGIN(TTSLunaService, rootAPI)
     LS_CATEGORY_METHOD(speak)
+    LS_CATEGORY_METHOD(speakBatch)
     LS_CATEGORY_METHOD(stop)
+    LS_CATEGORY_METHOD(pause)
+    LS_CATEGORY_METHOD(resume)
     LS_CATEGORY_METHOD(getAvailableLanguages)
     LS_CATEGORY_METHOD(getStatus)
+    LS_CATEGORY_METHOD(getMetrics)
+    LS_CATEGORY_METHOD(getAudioTap)
     LS_CREATE_CATEGORY_END
 
     try {
@@ -85,9 +145,7 @@ bool TTSLunaService::speak(LSMessage &message)
     unsigned int displayId = 0;
     bool retVal = false;
 
-    const std::string schema = STRICT_SCHEMA(PROPS_7(PROP(text, string), PROP(clear, boolean), PROP(subscribe, boolean), PROP(appID, string), PROP(feedback, boolean), PROP(language, string), PROP(displayId, integer))REQUIRED_1(text));
-
-    if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+    if (!LSUtils::parsePayload(request.getPayload(), requestObj, mSpeakSchema, &parseError))
     {
         const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::INVALID_JSON_FORMAT);
         try {
@@ -102,7 +160,19 @@ bool TTSLunaService::speak(LSMessage &message)
     if (!TTSUtils::getInstance().isValidDisplayId(request, requestObj, displayId))
         return true;
 
-    std::string textString;
+    if ((requestObj.hasKey("expiresIn") && requestObj["expiresIn"].asNumber<int64_t>() <= 0)
+            || isPastDeadline(requestObj))
+    {
+        const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::INVALID_PARAM);
+        try {
+            LSUtils::respondWithError(request, errorStr, TTSErrors::INVALID_PARAM);
+        } catch (LS::Error &lunaError) {
+            LOG_ERROR(MSGID_LUNA_ERROR_RESPONSE, 0,
+                    "Exception on Luna API speak error response: %s", lunaError.what());
+        }
+        return true;
+    }
+
     SpeakRequest *speakRequest = new (std::nothrow)SpeakRequest;
     if(speakRequest == nullptr){
         const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::TTS_MEMORY_ERROR);
@@ -117,14 +187,25 @@ bool TTSLunaService::speak(LSMessage &message)
     }
     else
     {
-        if((requestObj["text"].asString(speakRequest->text_to_speak)) != CONV_OK)
-            LOG_DEBUG("Speak : Text not present to Request");
-
         speakRequest->sh = this->get();
         speakRequest->replyCB = responseCallback;
         speakRequest->message = request;
 
-        if ((speakRequest->text_to_speak).empty())
+        // Built from the payload parsed above, the text lives only in the parameters
+        addParameters(message, requestObj);
+        if (mParameterList == nullptr)
+        {
+            const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::TTS_MEMORY_ERROR);
+            try {
+                LSUtils::respondWithError(request, errorStr, TTSErrors::TTS_MEMORY_ERROR);
+            } catch (const LS::Error& lse) {
+                LOG_ERROR(MSGID_ERROR_CALL, 0, "Exception while sending error response: %s", lse.what());
+            }
+            LOG_ERROR(MSGID_TTS_MEMORY_ERROR, 0, "Failed To Allocatememory for Parameters");
+            delete speakRequest;
+            return true;
+        }
+        if (mParameterList->sText.empty())
         {
             const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::INPUT_TEXT_EMPTY);
             try {
@@ -132,10 +213,11 @@ bool TTSLunaService::speak(LSMessage &message)
             } catch (const LS::Error& lse) {
                 LOG_ERROR(MSGID_ERROR_CALL, 0, "Exception while sending error response: %s", lse.what());
             }
+            delete mParameterList;
+            mParameterList = nullptr;
             delete speakRequest;
             return true;
         }
-        addParameters(message);
         speakRequest->msgParameters = mParameterList;
 
         if(mParameterList->bSubscribed)
@@ -154,14 +236,14 @@ bool TTSLunaService::speak(LSMessage &message)
             }
             LOG_ERROR(MSGID_TTS_MEMORY_ERROR, 0,
                     "Failed To Allocatememory for TTSRequest");
+            delete mParameterList;
+            mParameterList = nullptr;
+            delete speakRequest;
             return true;
         }
-        retVal = mRequestHandler->sendRequest(ttsRequest, displayId);
-    }
 
-    if(retVal)
-    {
-        LOG_DEBUG("Speak Request Complete\n");
+        // The queue owns the parameters once sent and may delete them at
+        // any time, through coalescing, expiry or a stop
         responseObj.put("language", mParameterList->sLangStr);
         responseObj.put("returnValue", true);
         if(mParameterList->bSubscribed)
@@ -170,6 +252,14 @@ bool TTSLunaService::speak(LSMessage &message)
             responseObj.put("subscribed", false);
         if(mParameterList->bFeedback == true || mParameterList->bSubscribed == true)
             responseObj.put("msgID", mParameterList->sMsgID);
+        mParameterList = nullptr;
+        retVal = mRequestHandler->sendRequest(ttsRequest, displayId);
+    }
+
+    if(retVal)
+    {
+        LOG_DEBUG("Speak Request Complete\n");
+        scheduleStatusCheck();
         LSUtils::postToClient(request, responseObj);
     }
     else
@@ -187,6 +277,148 @@ bool TTSLunaService::speak(LSMessage &message)
     return true;
 }
 
+bool TTSLunaService::speakBatch(LSMessage &message)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    LOG_INFO(MSGID_LUNA_SERVICE, 0, "%s", __FUNCTION__);
+
+    LS::Message request(&message);
+    pbnjson::JValue requestObj;
+    int parseError = 0;
+    unsigned int displayId = 0;
+
+    auto respondError = [&request](int errorCode) {
+        const std::string errorStr = TTSErrors::getTTSErrorString(errorCode);
+        try {
+            LSUtils::respondWithError(request, errorStr, errorCode);
+        } catch (LS::Error &lunaError) {
+            LOG_ERROR(MSGID_LUNA_ERROR_RESPONSE, 0,
+                    "Exception on Luna API speakBatch error response: %s", lunaError.what());
+        }
+    };
+
+    if (!LSUtils::parsePayload(request.getPayload(), requestObj, mBatchSchema, &parseError))
+    {
+        respondError(TTSErrors::INVALID_JSON_FORMAT);
+        return true;
+    }
+
+    if (!TTSUtils::getInstance().isValidDisplayId(request, requestObj, displayId))
+        return true;
+
+    // The whole batch is rejected before anything is queued
+    pbnjson::JValue items = requestObj["items"];
+    ssize_t itemCount = items.arraySize();
+    if (itemCount <= 0 || itemCount > SPEAK_BATCH_MAX_ITEMS)
+    {
+        respondError(TTSErrors::INVALID_PARAM);
+        return true;
+    }
+    std::string batchLanguage = requestObj["language"].asString();
+    for (ssize_t i = 0; i < itemCount; i++)
+    {
+        pbnjson::JValue item = items[i];
+        std::string language = item.hasKey("language") ? item["language"].asString() : batchLanguage;
+        if (!language.empty() && !isSupportedLanguage(language))
+        {
+            respondError(TTSErrors::LANG_NOT_SUPPORTED);
+            return true;
+        }
+        if (item["text"].asString().empty())
+        {
+            respondError(TTSErrors::INPUT_TEXT_EMPTY);
+            return true;
+        }
+        if ((item.hasKey("expiresIn") && item["expiresIn"].asNumber<int64_t>() <= 0)
+                || isPastDeadline(item))
+        {
+            respondError(TTSErrors::INVALID_PARAM);
+            return true;
+        }
+    }
+
+    // Each item is built like a speak call carrying the batch-level options
+    std::string batchID = LSUtils::generateRandomString(12);
+    std::vector<TTSRequest*> requests;
+    std::vector<Parameters*> params;
+    for (ssize_t i = 0; i < itemCount; i++)
+    {
+        pbnjson::JValue itemObj = items[i].duplicate();
+        for (const char* key : {"appID", "displayId", "clear", "urgent"})
+        {
+            if (requestObj.hasKey(key))
+                itemObj.put(key, requestObj[key]);
+        }
+        if (!itemObj.hasKey("language") && !batchLanguage.empty())
+            itemObj.put("language", batchLanguage);
+
+        SpeakRequest *speakRequest = new (std::nothrow) SpeakRequest;
+        addParameters(message, itemObj);
+        TTSRequest *ttsRequest = nullptr;
+        if (speakRequest && mParameterList)
+        {
+            speakRequest->sh = this->get();
+            speakRequest->replyCB = responseCallback;
+            speakRequest->message = request;
+            speakRequest->msgParameters = mParameterList;
+            ttsRequest = new (std::nothrow) TTSRequest(reinterpret_cast<RequestType*>(speakRequest), mEngineHandler);
+        }
+        if (!ttsRequest)
+        {
+            LOG_ERROR(MSGID_TTS_MEMORY_ERROR, 0, "Failed To Allocatememory for batch item %zd", i);
+            delete mParameterList;
+            delete speakRequest;
+            mParameterList = nullptr;
+            for (TTSRequest *queued : requests)
+                delete queued;
+            respondError(TTSErrors::TTS_MEMORY_ERROR);
+            return true;
+        }
+        // Status updates name the item by its own id and its place in the batch
+        if (mParameterList->sMsgID.empty())
+            mParameterList->sMsgID = LSUtils::generateRandomString(12);
+        mParameterList->sBatchID = batchID;
+        mParameterList->batchIndex = i;
+        requests.push_back(ttsRequest);
+        params.push_back(mParameterList);
+    }
+    // The items belong to their requests now
+    mParameterList = nullptr;
+
+    // Lets the engine synthesize the next item while this one plays
+    for (size_t i = 0; i + 1 < params.size(); i++)
+    {
+        if (params[i]->sLangStr == params[i + 1]->sLangStr)
+            params[i]->sLookahead = params[i + 1]->sText;
+    }
+
+    bool subscribed = params.front()->bSubscribed;
+    if (subscribed)
+        addSubscription(lsHandle, &message, batchID);
+
+    pbnjson::JValue msgIDs = pbnjson::Array();
+    for (Parameters *param : params)
+        msgIDs.append(param->sMsgID);
+
+    // The queue owns the items once sent, and deletes them on failure
+    if (!mRequestHandler->sendBatch(requests, displayId))
+    {
+        LOG_DEBUG("Speak Batch Not Sent\n");
+        respondError(TTSErrors::SPEECH_DATA_CREATION_ERROR);
+        return true;
+    }
+
+    LOG_DEBUG("Speak Batch Complete\n");
+    scheduleStatusCheck();
+    pbnjson::JValue responseObj = pbnjson::Object();
+    responseObj.put("returnValue", true);
+    responseObj.put("batchID", batchID);
+    responseObj.put("msgIDs", msgIDs);
+    responseObj.put("subscribed", subscribed);
+    LSUtils::postToClient(request, responseObj);
+    return true;
+}
+
 bool TTSLunaService::stop(LSMessage &message)
 {
    LOG_INFO(MSGID_LUNA_SERVICE, 0, "%s", __FUNCTION__);
@@ -197,8 +429,7 @@ bool TTSLunaService::stop(LSMessage &message)
    pbnjson::JValue requestObj;
    int parseError = 0;
    unsigned int displayId = 0;
-   const std::string schema = STRICT_SCHEMA(PROPS_4(PROP(msgID, string),PROP(appID, string), PROP(fadeOut, boolean), PROP(displayId, integer)));
-   if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+   if (!LSUtils::parsePayload(request.getPayload(), requestObj, mStopSchema, &parseError))
    {
       const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::INVALID_JSON_FORMAT);
       try {
@@ -256,6 +487,74 @@ bool TTSLunaService::stop(LSMessage &message)
     return true;
 }
 
+bool TTSLunaService::pause(LSMessage &message)
+{
+    LOG_INFO(MSGID_LUNA_SERVICE, 0, "%s", __FUNCTION__);
+    return sendPauseRequest(message, PAUSE);
+}
+
+bool TTSLunaService::resume(LSMessage &message)
+{
+    LOG_INFO(MSGID_LUNA_SERVICE, 0, "%s", __FUNCTION__);
+    return sendPauseRequest(message, RESUME);
+}
+
+bool TTSLunaService::sendPauseRequest(LSMessage &message, REQUEST_TYPE type)
+{
+    LS::Message request(&message);
+    std::string payload;
+    pbnjson::JValue requestObj;
+    int parseError = 0;
+    unsigned int displayId = 0;
+
+    if (!LSUtils::parsePayload(request.getPayload(), requestObj, mDisplaySchema, &parseError))
+    {
+        const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::INVALID_JSON_FORMAT);
+        try {
+            LSUtils::respondWithError(request, errorStr, TTSErrors::INVALID_JSON_FORMAT);
+        } catch (LS::Error &lunaError) {
+            LOG_ERROR(MSGID_LUNA_ERROR_RESPONSE, 0,
+                    "Exception on Luna API pause/resume error response: %s", lunaError.what());
+        }
+        return true;
+    }
+
+    if (!TTSUtils::getInstance().isValidDisplayId(request, requestObj, displayId))
+        return true;
+
+    PauseRequest *pauseRequest = new (std::nothrow) PauseRequest(type);
+    if (pauseRequest == nullptr)
+        return true;
+    pauseRequest->displayId = displayId;
+    TTSRequest* ttsRequest = new (std::nothrow) TTSRequest(reinterpret_cast<RequestType*>(pauseRequest), mEngineHandler);
+    if (ttsRequest == nullptr)
+    {
+        delete pauseRequest;
+        return true;
+    }
+    bool retVal = mRequestHandler->sendRequest(ttsRequest, displayId);
+    delete ttsRequest;
+    if (!retVal)
+    {
+        LOG_DEBUG("%s Request Not Completed\n", type == PAUSE ? "Pause" : "Resume");
+        const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::INVALID_PLAYBACK_STATE);
+        try {
+            LSUtils::respondWithError(request, errorStr, TTSErrors::INVALID_PLAYBACK_STATE);
+        } catch (LS::Error &lunaError) {
+            LOG_ERROR(MSGID_LUNA_ERROR_RESPONSE, 0,
+                    "Exception on Luna API pause/resume error response: %s", lunaError.what());
+        }
+        return true;
+    }
+
+    pbnjson::JValue responseObj = pbnjson::Object();
+    responseObj.put("returnValue", true);
+
+    LSUtils::generatePayload(responseObj, payload);
+    request.respond(payload.c_str());
+    return true;
+}
+
 bool TTSLunaService::getAvailableLanguages(LSMessage &message)
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
@@ -270,8 +569,7 @@ bool TTSLunaService::getAvailableLanguages(LSMessage &message)
     unsigned int displayId = 0;
 
     /* Added to Support Multiple Devices for OSE */
-    const std::string schema = STRICT_SCHEMA(PROPS_1(PROP(displayId, integer)));
-    if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+    if (!LSUtils::parsePayload(request.getPayload(), requestObj, mDisplaySchema, &parseError))
     {
         const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::INVALID_JSON_FORMAT);
         try {
@@ -363,8 +661,7 @@ bool TTSLunaService::getStatus(LSMessage &message)
     bool retVal = false;
     std::string payload;
 
-    const std::string schema = STRICT_SCHEMA(PROPS_1(PROP(displayId, integer)));
-    if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+    if (!LSUtils::parsePayload(request.getPayload(), requestObj, mStatusSchema, &parseError))
     {
         const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::INVALID_JSON_FORMAT);
         try {
@@ -379,6 +676,15 @@ bool TTSLunaService::getStatus(LSMessage &message)
     if (!TTSUtils::getInstance().isValidDisplayId(request, requestObj, displayId))
         return true;
 
+    // Later changes are pushed by pushStatusChanges()
+    if (LSMessageIsSubscription(&message))
+    {
+        TTSStatus current {};
+        if (addSubscription(lsHandle, &message, statusSubscriptionKey(displayId))
+                && readStatus(displayId, current))
+            recordStatus(displayId, current);
+    }
+
     GetStatusRequest* getStatusRequest = new (std::nothrow)GetStatusRequest;
     if(getStatusRequest == nullptr){
         LOG_ERROR(MSGID_TTS_MEMORY_ERROR, 0, "Memory Allocation Error In GetStatusRequest");
@@ -444,7 +750,21 @@ bool TTSLunaService::getStatus(LSMessage &message)
 
     getStatusRequest->pTTSStatus->pitch = dTTSPitch;
     getStatusRequest->pTTSStatus->speechRate = dTTSSpeechRate;
+    getStatusRequest->pTTSStatus->queueDepth = mRequestHandler->getQueueDepth(displayId);
 
+    // Answered from the subscribed snapshot once both values have arrived,
+    // queried one-shot until then
+    if (mSystemState.volumeKnown && mSystemState.menuLanguageKnown)
+    {
+        getStatusRequest->pTTSStatus->volume = mSystemState.volume;
+        getStatusRequest->pTTSStatus->ttsMenuLangStr = mSystemState.menuLanguage;
+        if (retVal)
+            statusResponse(getStatusRequest->pTTSStatus, request, true);
+        delete getStatusRequest->pTTSStatus;
+        delete getStatusRequest;
+        delete ptrTTSRequest;
+        return true;
+    }
 
     LSError lserror;
     LSErrorInit(&lserror);
@@ -473,6 +793,124 @@ bool TTSLunaService::getStatus(LSMessage &message)
     return true;
 }
 
+// Answered in place, the counters need neither the queues nor the engines' locks
+bool TTSLunaService::getMetrics(LSMessage &message)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    LOG_INFO(MSGID_LUNA_SERVICE, 0, "%s", __FUNCTION__);
+
+    LS::Message request(&message);
+    pbnjson::JValue requestObj;
+    int parseError = 0;
+    unsigned int displayId = 0;
+    std::string payload;
+
+    if (!LSUtils::parsePayload(request.getPayload(), requestObj, mDisplaySchema, &parseError))
+    {
+        const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::INVALID_JSON_FORMAT);
+        try {
+            LSUtils::respondWithError(request, errorStr, TTSErrors::INVALID_JSON_FORMAT);
+        } catch (LS::Error &lunaError) {
+            LOG_ERROR(MSGID_LUNA_ERROR_RESPONSE, 0,
+                    "Exception on Luna API getMetrics error response: %s", lunaError.what());
+        }
+        return true;
+    }
+
+    pbnjson::JValue metrics = pbnjson::Array();
+    if (requestObj.hasKey("displayId"))
+    {
+        if (!TTSUtils::getInstance().isValidDisplayId(request, requestObj, displayId))
+            return true;
+        metrics.append(mEngineHandler->getMetrics(displayId));
+    }
+    else
+    {
+        // Every display when none is given
+        for (displayId = 0; displayId < mEngineHandler->getDisplayCount(); displayId++)
+            metrics.append(mEngineHandler->getMetrics(displayId));
+    }
+
+    pbnjson::JValue responseObj = pbnjson::Object();
+    responseObj.put("metrics", metrics);
+    responseObj.put("process", mEngineHandler->getProcessMetrics());
+    responseObj.put("returnValue", true);
+    LSUtils::generatePayload(responseObj, payload);
+    try {
+        request.respond(payload.c_str());
+    } catch (LS::Error &lunaError) {
+        LOG_ERROR(MSGID_LUNA_ERROR_RESPONSE, 0,
+                "Exception on Luna API getMetrics response: %s", lunaError.what());
+    }
+    return true;
+}
+
+// Hands out the display's tap as a read-only memfd with the reply, see
+// AudioTapHeader for the layout. Nothing else crosses the bus afterwards.
+bool TTSLunaService::getAudioTap(LSMessage &message)
+{
+    LOG_TRACE("Entering function %s", __FUNCTION__);
+    LOG_INFO(MSGID_LUNA_SERVICE, 0, "%s", __FUNCTION__);
+
+    LS::Message request(&message);
+    pbnjson::JValue requestObj;
+    int parseError = 0;
+    unsigned int displayId = 0;
+
+    if (!LSUtils::parsePayload(request.getPayload(), requestObj, mDisplaySchema, &parseError))
+    {
+        const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::INVALID_JSON_FORMAT);
+        try {
+            LSUtils::respondWithError(request, errorStr, TTSErrors::INVALID_JSON_FORMAT);
+        } catch (LS::Error &lunaError) {
+            LOG_ERROR(MSGID_LUNA_ERROR_RESPONSE, 0,
+                    "Exception on Luna API getAudioTap error response: %s", lunaError.what());
+        }
+        return true;
+    }
+    if (!TTSUtils::getInstance().isValidDisplayId(request, requestObj, displayId))
+        return true;
+
+    unsigned int sampleRate = 0;
+    unsigned int capacityFrames = 0;
+    const AudioTap *tap = mEngineHandler->getAudioTap(displayId);
+    int fd = tap ? tap->openReadOnly(sampleRate, capacityFrames) : -1;
+    if (fd < 0)
+    {
+        const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::TTS_ERROR_NOT_SUPPORTED);
+        try {
+            LSUtils::respondWithError(request, errorStr, TTSErrors::TTS_ERROR_NOT_SUPPORTED);
+        } catch (LS::Error &lunaError) {
+            LOG_ERROR(MSGID_LUNA_ERROR_RESPONSE, 0,
+                    "Exception on Luna API getAudioTap error response: %s", lunaError.what());
+        }
+        return true;
+    }
+
+    pbnjson::JValue responseObj = pbnjson::Object();
+    responseObj.put("displayId", (int) displayId);
+    responseObj.put("sampleRate", (int) sampleRate);
+    responseObj.put("channels", 1);
+    responseObj.put("format", "float32");
+    responseObj.put("capacityFrames", (int) capacityFrames);
+    responseObj.put("version", AUDIO_TAP_VERSION);
+    responseObj.put("returnValue", true);
+
+    LSError lserror;
+    LSErrorInit(&lserror);
+    LSPayload *payload = LSPayloadFromJson(responseObj.peekRaw());
+    LSPayloadAttachFd(payload, fd);
+    if (!LSMessageRespondWithPayload(&message, payload, &lserror))
+    {
+        LSErrorPrint(&lserror, stderr);
+        LSErrorFree(&lserror);
+    }
+    LSPayloadFree(payload);
+    // Duplicated into the reply by the transport
+    close(fd);
+    return true;
+}
+
 void TTSLunaService::responseCallback(Parameters* paramList, LS::Message& message)
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
@@ -503,6 +941,12 @@ void TTSLunaService::responseCallback(Parameters* paramList, LS::Message& messag
        responseObj.put("msgID", paramList->sMsgID);
     }
 
+    if (!paramList->sBatchID.empty())
+    {
+        responseObj.put("batchID", paramList->sBatchID);
+        responseObj.put("batchIndex", (int)paramList->batchIndex);
+    }
+
     if(subscribed)
     {
         std::string messageStatus = GET_MSG_STATUS_TEXT(paramList->eStatus);
@@ -525,71 +969,41 @@ void TTSLunaService::responseCallback(Parameters* paramList, LS::Message& messag
 
 }
 
-void TTSLunaService::addParameters(LSMessage &message)
+// Empty text is left for the caller to reject, before any other error is sent
+void TTSLunaService::addParameters(LSMessage &message, const pbnjson::JValue &requestObj)
 {
     LOG_TRACE("Entering function %s", __FUNCTION__);
 
     LS::Message request(&message);
-    pbnjson::JValue requestObj = pbnjson::Object();
-    int lCount;
-    int displayId = 0;
-
-    LSUtils::parsePayload(request.getPayload(), requestObj);
 
     mParameterList = new (std::nothrow) Parameters;
 
     if(mParameterList != nullptr)
     {
-	if ((requestObj["text"].asString(mParameterList->sText)) != CONV_OK)
+        bool languageSupported = LSUtils::parseSpeakParameters(requestObj, *mParameterList);
+        if (mParameterList->sText.empty())
+        {
             LOG_DEBUG("addParameters : String Text is not present\n");
-        mParameterList->bFeedback = requestObj["feedback"].asBool();
-        mParameterList->bSubscribed = LSMessageIsSubscription(&message);
-        mParameterList->eStatus = TTS_MSG_ERROR;
-        mParameterList->sAppID = requestObj["appID"].asString();
-
-        if (requestObj["displayId"].asNumber(displayId) == CONV_OK)
-            LOG_DEBUG("addParameters : displayId  = %zu\n", displayId);
-
-        mParameterList->displayId = displayId;
-        mParameterList->eTaskStatus = TTS_TASK_NOT_READY;
-        mParameterList->eLang = LANG_ENUS;
+            return;
+        }
+        LOG_DEBUG("addParameters : displayId  = %u\n", mParameterList->displayId);
 
+        mParameterList->bSubscribed = LSMessageIsSubscription(&message);
         if(mParameterList->bSubscribed || mParameterList->bFeedback)
         {
             mParameterList->sMsgID = LSUtils::generateRandomString(12);
         }
 
-        mParameterList->sLangStr = "en-US";
-        std::string sInputLang;
-        sInputLang = requestObj["language"].asString();
-
-        if(!sInputLang.empty())
+        if(!languageSupported)
         {
-            for(lCount = 0; lCount < LANG_MAX; lCount++)
-            {
-                if(!strcmp(TTSLanguageTable[lCount].languageStr.c_str(), sInputLang.c_str()))
-                {
-                    mParameterList->eLang = TTSLanguageTable[lCount].ttsLanguage;
-                    mParameterList->sLangStr = sInputLang;
-                    break;
-                }
-            }
-
-            if(lCount == LANG_MAX)
-            {
-                mParameterList->eLang = LANG_ERR;
-                mParameterList->eStatus = TTS_MSG_ERROR;
-                const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::LANG_NOT_SUPPORTED);
-                try {
-                    LSUtils::respondWithError(request, errorStr, TTSErrors::LANG_NOT_SUPPORTED);
-                } catch (LS::Error &lunaError) {
-                    LOG_ERROR(MSGID_LUNA_ERROR_RESPONSE, 0,
-                            "Exception on Luna API addParameters error response: %s", lunaError.what());
-                }
+            const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::LANG_NOT_SUPPORTED);
+            try {
+                LSUtils::respondWithError(request, errorStr, TTSErrors::LANG_NOT_SUPPORTED);
+            } catch (LS::Error &lunaError) {
+                LOG_ERROR(MSGID_LUNA_ERROR_RESPONSE, 0,
+                        "Exception on Luna API addParameters error response: %s", lunaError.what());
             }
         }
-
-        mParameterList->bClear = requestObj["clear"].asBool();
     }
 }
 
@@ -618,6 +1032,8 @@ void TTSLunaService::update(Parameters* paramList, LS::Message &message)
     LOG_INFO(MSGID_LUNA_SERVICE, 0, "%s", __FUNCTION__);
     LOG_DEBUG(" TTSLunaService::update entry\n");
     responseCallback(paramList,message);
+    // Cancelled and expired requests leave the queue
+    scheduleStatusCheck();
 }
 
 void TTSLunaService::statusResponse(TTSStatus* pTTSStatus, LS::Message& message, bool status)
@@ -625,19 +1041,10 @@ void TTSLunaService::statusResponse(TTSStatus* pTTSStatus, LS::Message& message,
     if(status) {
         std::string payload;
         pbnjson::JValue responseObj = pbnjson::Object();
-        pbnjson::JValue configJSON = pbnjson::Object();
-
-        if(pTTSStatus) {
-            configJSON.put("pitch", pTTSStatus->pitch);
-            configJSON.put("ttsCurrLang", pTTSStatus->ttsLanguageStr);
-            configJSON.put("speech rate", pTTSStatus->speechRate);
-            configJSON.put("status", pTTSStatus->status);
-            configJSON.put("volume", pTTSStatus->volume);
-            configJSON.put("ttsMenuLang", pTTSStatus->ttsMenuLangStr);
-        }
 
-        responseObj.put("status", configJSON);
+        responseObj.put("status", pTTSStatus ? statusToJson(*pTTSStatus) : pbnjson::Object());
         responseObj.put("returnValue", status);
+        responseObj.put("subscribed", message.isSubscription());
         LSUtils::generatePayload(responseObj, payload);
         message.respond(payload.c_str());
     } else {
@@ -661,23 +1068,12 @@ bool TTSLunaService::handle_getVolume_callback(LSHandle *sh, LSMessage *message,
 
     LSMessageRef(message);
     int volume = 0;
-    const char *msgPayload;
-
-    msgPayload = LSMessageGetPayload(message);
-    pbnjson::JValue root = pbnjson::JDomParser::fromString(msgPayload);
-    if(!LSUtils::parsePayload(msgPayload, root)) {
+    if (!parseVolume(message, volume)) {
         finalize_getstatus_request(pgetStatusRequest, false);
         LSMessageUnref(message);
         LOG_DEBUG("handle_getVolume_callback Failed to Parse message\n");
         return false;
     }
-    LOG_DEBUG("getVolume Json object from Audio = %s \n", root.stringify().c_str());
-
-    auto volumeStatus = root["volumeStatus"];
-    LOG_DEBUG("volumeStatus Json Object from Audio = %s \n", volumeStatus.stringify().c_str());
-
-    if( volumeStatus.hasKey("volume"))
-        volume = volumeStatus["volume"].asNumber<int32_t>();
 
     if(pgetStatusRequest->pTTSStatus)
         pgetStatusRequest->pTTSStatus->volume = volume;
@@ -696,25 +1092,13 @@ bool TTSLunaService::handle_getSettings_callback(LSHandle *sh, LSMessage *messag
         return false;
 
     LSMessageRef(message);
-    const char *msgPayload;
-    msgPayload = LSMessageGetPayload(message);
-    pbnjson::JValue root = pbnjson::JDomParser::fromString(msgPayload);
-    if(!LSUtils::parsePayload(msgPayload, root)) {
+    std::string MenuLanghStr;
+    if (!parseMenuLanguage(message, MenuLanghStr)) {
         finalize_getstatus_request(pgetStatusRequest, false);
         LOG_DEBUG("handle_getSettings_callback Failed to Parse message\n");
         LSMessageUnref(message);
         return false;
     }
-
-    LOG_DEBUG("getSettings Json object from Audio = %s \n", root.stringify().c_str());
-    std::string MenuLanghStr;
-    if(root["settings"].isObject())
-    {
-        const pbnjson::JValue& j_locale = root["settings"];
-        if (j_locale.hasKey("menuLanguage")) {
-            MenuLanghStr = j_locale["menuLanguage"].asString();
-        }
-    }
     if(pgetStatusRequest->pTTSStatus)
         pgetStatusRequest->pTTSStatus->ttsMenuLangStr = std::move(MenuLanghStr) ;
 
@@ -735,3 +1119,275 @@ void TTSLunaService::finalize_getstatus_request(GetStatusRequest* getStatusReque
         getStatusRequest->setError();
     }
 }
+
+// Subscription errors, e.g. the service going away, leave the snapshot as is
+static bool isSuccessReply(LSMessage *message)
+{
+    pbnjson::JValue root;
+    if (!LSUtils::parsePayload(LSMessageGetPayload(message), root))
+        return false;
+    return !root.hasKey("returnValue") || root["returnValue"].asBool();
+}
+
+bool TTSLunaService::parseVolume(LSMessage *message, int& volume)
+{
+    const char *msgPayload = LSMessageGetPayload(message);
+    pbnjson::JValue root;
+    if (!LSUtils::parsePayload(msgPayload, root))
+        return false;
+    LOG_DEBUG("getVolume Json object from Audio = %s \n", root.stringify().c_str());
+
+    auto volumeStatus = root["volumeStatus"];
+    if (volumeStatus.hasKey("volume"))
+        volume = volumeStatus["volume"].asNumber<int32_t>();
+    return true;
+}
+
+bool TTSLunaService::parseMenuLanguage(LSMessage *message, std::string& menuLanguage)
+{
+    const char *msgPayload = LSMessageGetPayload(message);
+    pbnjson::JValue root;
+    if (!LSUtils::parsePayload(msgPayload, root))
+        return false;
+    LOG_DEBUG("getSettings Json object from Settings = %s \n", root.stringify().c_str());
+
+    if (root["settings"].isObject())
+    {
+        const pbnjson::JValue& j_locale = root["settings"];
+        if (j_locale.hasKey("menuLanguage"))
+            menuLanguage = j_locale["menuLanguage"].asString();
+    }
+    return true;
+}
+
+// Both services may start after us or restart, so the subscriptions are
+// made whenever they connect and dropped with them
+void TTSLunaService::subscribeSystemState()
+{
+    LSError lserror;
+    LSErrorInit(&lserror);
+    if (!LSRegisterServerStatusEx(lsHandle, AUDIO_SERVICE, handle_audioServerStatus, this,
+            &mSystemState.audioCookie, &lserror))
+    {
+        LOG_ERROR(MSGID_ERROR_CALL, 0, lserror.message);
+        LSErrorFree(&lserror);
+    }
+    if (!LSRegisterServerStatusEx(lsHandle, SETTINGS_SERVICE, handle_settingsServerStatus, this,
+            &mSystemState.settingsCookie, &lserror))
+    {
+        LOG_ERROR(MSGID_ERROR_CALL, 0, lserror.message);
+        LSErrorFree(&lserror);
+    }
+}
+
+void TTSLunaService::unsubscribeSystemState()
+{
+    LSError lserror;
+    LSErrorInit(&lserror);
+    for (void **cookie : {&mSystemState.audioCookie, &mSystemState.settingsCookie})
+    {
+        if (*cookie && !LSCancelServerStatus(lsHandle, *cookie, &lserror))
+            LSErrorFree(&lserror);
+        *cookie = nullptr;
+    }
+    for (LSMessageToken *token : {&mSystemState.volumeToken, &mSystemState.settingsToken})
+    {
+        if (*token != LSMESSAGE_TOKEN_INVALID && !LSCallCancel(lsHandle, *token, &lserror))
+            LSErrorFree(&lserror);
+        *token = LSMESSAGE_TOKEN_INVALID;
+    }
+}
+
+bool TTSLunaService::handle_audioServerStatus(LSHandle *sh, const char *serviceName, bool connected, void *ctx)
+{
+    TTSLunaService *service = static_cast<TTSLunaService*>(ctx);
+    SystemState& state = service->mSystemState;
+    LOG_INFO(MSGID_LUNA_SERVICE, 0, "%s connected: %d", serviceName, connected);
+
+    LSError lserror;
+    LSErrorInit(&lserror);
+    if (state.volumeToken != LSMESSAGE_TOKEN_INVALID && !LSCallCancel(sh, state.volumeToken, &lserror))
+        LSErrorFree(&lserror);
+    state.volumeToken = LSMESSAGE_TOKEN_INVALID;
+    state.volumeKnown = false;
+    if (!connected)
+        return true;
+
+    if (!LSCall(sh, GET_VOLUME, R"({"subscribe": true})",
+            handle_volumeChanged, service, &state.volumeToken, &lserror))
+    {
+        LOG_ERROR(MSGID_ERROR_CALL, 0, lserror.message);
+        LSErrorFree(&lserror);
+    }
+    return true;
+}
+
+bool TTSLunaService::handle_settingsServerStatus(LSHandle *sh, const char *serviceName, bool connected, void *ctx)
+{
+    TTSLunaService *service = static_cast<TTSLunaService*>(ctx);
+    SystemState& state = service->mSystemState;
+    LOG_INFO(MSGID_LUNA_SERVICE, 0, "%s connected: %d", serviceName, connected);
+
+    LSError lserror;
+    LSErrorInit(&lserror);
+    if (state.settingsToken != LSMESSAGE_TOKEN_INVALID && !LSCallCancel(sh, state.settingsToken, &lserror))
+        LSErrorFree(&lserror);
+    state.settingsToken = LSMESSAGE_TOKEN_INVALID;
+    state.menuLanguageKnown = false;
+    if (!connected)
+        return true;
+
+    if (!LSCall(sh, GET_SYSTEM_SETTINGS, R"({"category": "option","keys": ["menuLanguage"],"subscribe": true})",
+            handle_settingsChanged, service, &state.settingsToken, &lserror))
+    {
+        LOG_ERROR(MSGID_ERROR_CALL, 0, lserror.message);
+        LSErrorFree(&lserror);
+    }
+    return true;
+}
+
+bool TTSLunaService::handle_volumeChanged(LSHandle *sh, LSMessage *message, void *ctx)
+{
+    SystemState& state = static_cast<TTSLunaService*>(ctx)->mSystemState;
+    int volume = state.volume;
+    if (!isSuccessReply(message) || !parseVolume(message, volume))
+        return true;
+    state.volume = volume;
+    state.volumeKnown = true;
+    LOG_DEBUG("handle_volumeChanged volume = %d", volume);
+    static_cast<TTSLunaService*>(ctx)->scheduleStatusCheck();
+    return true;
+}
+
+bool TTSLunaService::handle_settingsChanged(LSHandle *sh, LSMessage *message, void *ctx)
+{
+    SystemState& state = static_cast<TTSLunaService*>(ctx)->mSystemState;
+    std::string menuLanguage = state.menuLanguage;
+    if (!isSuccessReply(message) || !parseMenuLanguage(message, menuLanguage))
+        return true;
+    state.menuLanguage = std::move(menuLanguage);
+    state.menuLanguageKnown = true;
+    LOG_DEBUG("handle_settingsChanged menuLanguage = %s", state.menuLanguage.c_str());
+    return true;
+}
+
+pbnjson::JValue TTSLunaService::statusToJson(const TTSStatus& status)
+{
+    pbnjson::JValue configJSON = pbnjson::Object();
+    configJSON.put("pitch", status.pitch);
+    configJSON.put("ttsCurrLang", status.ttsLanguageStr);
+    configJSON.put("speech rate", status.speechRate);
+    configJSON.put("status", status.status);
+    configJSON.put("volume", status.volume);
+    configJSON.put("ttsMenuLang", status.ttsMenuLangStr);
+    configJSON.put("queueDepth", (int)status.queueDepth);
+    return configJSON;
+}
+
+// Same answer as getStatus, with volume and menu language from the snapshot
+bool TTSLunaService::readStatus(unsigned int displayId, TTSStatus& status)
+{
+    GetStatusRequest statusRequest;
+    statusRequest.pTTSStatus = &status;
+    statusRequest.displayId = displayId;
+    TTSRequest ttsRequest(reinterpret_cast<RequestType*>(&statusRequest), mEngineHandler);
+    if (!mRequestHandler || !mRequestHandler->sendRequest(&ttsRequest, displayId))
+        return false;
+    status.pitch = dTTSPitch;
+    status.speechRate = dTTSSpeechRate;
+    status.volume = mSystemState.volume;
+    status.ttsMenuLangStr = mSystemState.menuLanguage;
+    status.queueDepth = mRequestHandler->getQueueDepth(displayId);
+    return true;
+}
+
+void TTSLunaService::recordStatus(unsigned int displayId, const TTSStatus& status)
+{
+    if (displayId >= mStatusFeeds.size())
+        return;
+    StatusFeed& feed = mStatusFeeds[displayId];
+    feed.pushed = true;
+    feed.status = status.status;
+    feed.language = status.ttsLanguageStr;
+    feed.volume = status.volume;
+    feed.queueDepth = status.queueDepth;
+    feed.lastPushUs = g_get_monotonic_time();
+}
+
+void TTSLunaService::scheduleStatusCheck()
+{
+    if (!mStatusCheckPending.exchange(true))
+        g_idle_add(onStatusCheck, this);
+}
+
+// Pushes what changed since the last update of each subscribed display.
+// Updates closer together than mStatusIntervalMs are folded into one,
+// sent when the interval is up with the state at that time.
+void TTSLunaService::pushStatusChanges()
+{
+    gint64 now = g_get_monotonic_time();
+    gint64 nextDueUs = 0;
+    for (unsigned int displayId = 0; displayId < mStatusFeeds.size(); displayId++)
+    {
+        StatusFeed& feed = mStatusFeeds[displayId];
+        std::string key = statusSubscriptionKey(displayId);
+        if (LSSubscriptionGetHandleSubscribersCount(lsHandle, key.c_str()) == 0)
+        {
+            feed.pushed = false;
+            continue;
+        }
+
+        TTSStatus status {};
+        if (!readStatus(displayId, status))
+            continue;
+        if (feed.pushed && feed.status == status.status && feed.language == status.ttsLanguageStr
+                && feed.volume == status.volume && feed.queueDepth == status.queueDepth)
+            continue;
+
+        gint64 dueUs = feed.lastPushUs + (gint64)mStatusIntervalMs * 1000;
+        if (feed.pushed && now < dueUs)
+        {
+            if (!nextDueUs || dueUs < nextDueUs)
+                nextDueUs = dueUs;
+            continue;
+        }
+
+        pbnjson::JValue responseObj = pbnjson::Object();
+        responseObj.put("status", statusToJson(status));
+        responseObj.put("returnValue", true);
+        responseObj.put("subscribed", true);
+        std::string payload;
+        LSUtils::generatePayload(responseObj, payload);
+
+        LSError lserror;
+        LSErrorInit(&lserror);
+        if (!LSSubscriptionReply(lsHandle, key.c_str(), payload.c_str(), &lserror)) {
+            LSErrorPrint(&lserror, stderr);
+            LSErrorFree(&lserror);
+        }
+        recordStatus(displayId, status);
+    }
+
+    if (!nextDueUs || (mStatusTimer && mStatusTimerDueUs <= nextDueUs))
+        return;
+    if (mStatusTimer)
+        g_source_remove(mStatusTimer);
+    mStatusTimer = g_timeout_add((nextDueUs - now + 999) / 1000, onStatusTimer, this);
+    mStatusTimerDueUs = nextDueUs;
+}
+
+gboolean TTSLunaService::onStatusCheck(gpointer data)
+{
+    TTSLunaService *service = static_cast<TTSLunaService*>(data);
+    service->mStatusCheckPending = false;
+    service->pushStatusChanges();
+    return G_SOURCE_REMOVE;
+}
+
+gboolean TTSLunaService::onStatusTimer(gpointer data)
+{
+    TTSLunaService *service = static_cast<TTSLunaService*>(data);
+    service->mStatusTimer = 0;
+    service->pushStatusChanges();
+    return G_SOURCE_REMOVE;
+}
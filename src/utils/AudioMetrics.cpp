@@ -0,0 +1,81 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <AudioMetrics.h>
+
+LatencyHistogram::LatencyHistogram() : mCount(0), mSumUs(0), mMaxUs(0)
+{
+    for (auto &bucket : mBuckets)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::record(uint64_t us)
+{
+    unsigned int bucket = 0;
+    while (bucket < HISTOGRAM_BUCKETS - 1 && (us >> bucket) != 0)
+        bucket++;
+    mBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    mCount.fetch_add(1, std::memory_order_relaxed);
+    mSumUs.fetch_add(us, std::memory_order_relaxed);
+    uint64_t max = mMaxUs.load(std::memory_order_relaxed);
+    while (us > max && !mMaxUs.compare_exchange_weak(max, us, std::memory_order_relaxed))
+        ;
+}
+
+// Only the buckets that counted something, each with its upper bound
+pbnjson::JValue LatencyHistogram::toJson() const
+{
+    uint64_t count = mCount.load(std::memory_order_relaxed);
+    pbnjson::JValue histogram = pbnjson::Object();
+    histogram.put("count", (int64_t) count);
+    histogram.put("avgUs", (int64_t) (count > 0 ? mSumUs.load(std::memory_order_relaxed) / count : 0));
+    histogram.put("maxUs", (int64_t) mMaxUs.load(std::memory_order_relaxed));
+    pbnjson::JValue buckets = pbnjson::Array();
+    for (unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        uint64_t n = mBuckets[i].load(std::memory_order_relaxed);
+        if (n == 0)
+            continue;
+        pbnjson::JValue bucket = pbnjson::Object();
+        if (i < HISTOGRAM_BUCKETS - 1)
+            bucket.put("belowUs", (int64_t) 1 << i);
+        bucket.put("count", (int64_t) n);
+        buckets.append(bucket);
+    }
+    histogram.put("buckets", buckets);
+    return histogram;
+}
+
+uint64_t AudioMetrics::elapsedUs(Clock::time_point since)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since).count();
+}
+
+pbnjson::JValue AudioMetrics::toJson() const
+{
+    pbnjson::JValue metrics = pbnjson::Object();
+    metrics.put("utterances", (int64_t) utterances.load(std::memory_order_relaxed));
+    metrics.put("underruns", (int64_t) underruns.load(std::memory_order_relaxed));
+    metrics.put("streamUnderruns", (int64_t) streamUnderruns.load(std::memory_order_relaxed));
+    metrics.put("trimmedMs", (int64_t) trimmedMs.load(std::memory_order_relaxed));
+    metrics.put("latency", latency.toJson());
+    metrics.put("writeStall", writeStall.toJson());
+    metrics.put("firstSample", firstSample.toJson());
+    metrics.put("drain", drain.toJson());
+    metrics.put("fileRead", fileRead.toJson());
+    return metrics;
+}
@@ -0,0 +1,180 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <cmath>
+#include <AudioMixer.h>
+#include <DspKernels.h>
+
+AudioMixer::AudioMixer() : mDuckLevel(1.0f), mRampStep(1.0f)
+{
+    setDucking(DEFAULT_DUCK_LEVEL, 0);
+}
+
+void AudioMixer::setDucking(float level, size_t rampFrames)
+{
+    mDuckLevel = std::min(1.0f, std::max(0.0f, level));
+    mRampStep = 1.0f;
+    if (rampFrames > 0 && mDuckLevel < 1.0f)
+        mRampStep = (1.0f - mDuckLevel) / rampFrames;
+}
+
+void AudioMixer::reserve(size_t frames)
+{
+    mBlockFrames = std::max<size_t>(frames, 1);
+    mScratch.reserve(mBlockFrames);
+    for (Voice &v : mVoices)
+        v.block.reserve(mBlockFrames);
+}
+
+void AudioMixer::setVoice(AudioVoice voice, std::vector<float> samples)
+{
+    clearVoice(voice);
+    Voice &v = mVoices[voice];
+    v.samples = std::move(samples);
+    // A voice starting under a louder one begins ducked, without a ramp
+    v.gain = getTargetGain(voice);
+}
+
+void AudioMixer::setVoice(AudioVoice voice, std::shared_ptr<SpeechStream> stream)
+{
+    clearVoice(voice);
+    Voice &v = mVoices[voice];
+    v.stream = std::move(stream);
+    v.gain = getTargetGain(voice);
+}
+
+void AudioMixer::clearVoice(AudioVoice voice)
+{
+    (void) releaseVoice(voice);
+}
+
+std::shared_ptr<SpeechStream> AudioMixer::releaseVoice(AudioVoice voice)
+{
+    Voice &v = mVoices[voice];
+    std::vector<float>().swap(v.samples);
+    v.block.clear();
+    v.offset = 0;
+    // Lets a producer blocked on the stream go
+    if (v.stream)
+        v.stream->abort();
+    return std::move(v.stream);
+}
+
+const std::vector<float>& AudioMixer::getSource(const Voice& v)
+{
+    return v.stream ? v.block : v.samples;
+}
+
+bool AudioMixer::isActive(AudioVoice voice) const
+{
+    const Voice &v = mVoices[voice];
+    return v.offset < getSource(v).size() || (v.stream && !v.stream->isDrained());
+}
+
+bool AudioMixer::isActive() const
+{
+    for (unsigned int voice = 0; voice < VOICE_COUNT; voice++) {
+        if (isActive((AudioVoice) voice))
+            return true;
+    }
+    return false;
+}
+
+bool AudioMixer::isStarved() const
+{
+    for (const Voice &v : mVoices) {
+        if (v.stream && v.stream->isStarved())
+            return true;
+    }
+    return false;
+}
+
+float AudioMixer::getTargetGain(unsigned int voice) const
+{
+    for (unsigned int higher = voice + 1; higher < VOICE_COUNT; higher++) {
+        if (isActive((AudioVoice) higher))
+            return mDuckLevel;
+    }
+    return 1.0f;
+}
+
+size_t AudioMixer::mix(float* out, size_t frames)
+{
+    if (mBlockFrames == 0)
+        return mixBlock(out, frames);
+    size_t mixed = 0;
+    while (mixed < frames) {
+        size_t block = std::min(frames - mixed, mBlockFrames);
+        size_t count = mixBlock(out + mixed, block);
+        mixed += count;
+        // Every voice ended within this block
+        if (count < block)
+            break;
+    }
+    return mixed;
+}
+
+size_t AudioMixer::mixBlock(float* out, size_t frames)
+{
+    // Stream voices take this block from their ring
+    for (Voice &v : mVoices) {
+        if (!v.stream || v.stream->isDrained())
+            continue;
+        v.block.resize(frames);
+        v.block.resize(v.stream->read(v.block.data(), frames));
+        v.offset = 0;
+    }
+
+    size_t count = 0;
+    for (const Voice &v : mVoices)
+        count = std::max(count, std::min(frames, getSource(v).size() - v.offset));
+    if (count == 0)
+        return 0;
+
+    const DspKernels &dsp = getDspKernels();
+    std::fill(out, out + count, 0.0f);
+    // Targets are taken before any voice advances, so a voice ending in
+    // this block releases the duck on the next one
+    float targets[VOICE_COUNT];
+    for (unsigned int voice = 0; voice < VOICE_COUNT; voice++)
+        targets[voice] = getTargetGain(voice);
+
+    for (unsigned int voice = 0; voice < VOICE_COUNT; voice++) {
+        Voice &v = mVoices[voice];
+        const std::vector<float> &source = getSource(v);
+        size_t n = std::min(count, source.size() - v.offset);
+        if (n == 0)
+            continue;
+        const float *src = &source[v.offset];
+        float target = targets[voice];
+        if (v.gain == target) {
+            dsp.mixAdd(out, src, n, v.gain);
+        } else {
+            // Ramp towards the target, then hold it for the rest of the block
+            float step = (target > v.gain) ? mRampStep : -mRampStep;
+            size_t needed = (size_t) std::ceil((target - v.gain) / step);
+            size_t ramp = std::min(n, needed);
+            mScratch.assign(src, src + n);
+            dsp.gainRamp(mScratch.data(), ramp, v.gain, step);
+            v.gain = (ramp == needed) ? target : v.gain + ramp * step;
+            dsp.gainRamp(mScratch.data() + ramp, n - ramp, v.gain, 0.0f);
+            dsp.mixAdd(out, mScratch.data(), n, 1.0f);
+        }
+        v.offset += n;
+    }
+    return count;
+}
@@ -0,0 +1,183 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include <AudioTap.h>
+#include <TTSLog.h>
+
+static uint32_t roundUpPow2(uint64_t value)
+{
+    uint32_t size = 1;
+    while (size < value && size < (1u << 30))
+        size <<= 1;
+    return size;
+}
+
+AudioTap::~AudioTap()
+{
+    close();
+}
+
+TapSettings AudioTap::loadSettings(const TTSConfig& config)
+{
+    TapSettings settings;
+    pbnjson::JValue value;
+    (void) config.getValue("tap", "enabled", value);
+    settings.enabled = value.isBoolean() && value.asBool();
+    (void) config.getValue("tap", "capacityMs", value);
+    if (value.isNumber() && value.asNumber<int>() > 0)
+        settings.capacityMs = value.asNumber<int>();
+    LOG_DEBUG("Audio tap %s, %u ms", settings.enabled ? "enabled" : "disabled", settings.capacityMs);
+    return settings;
+}
+
+int64_t AudioTap::nowNs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+bool AudioTap::open(const std::string& name, unsigned int sampleRate, unsigned int capacityMs)
+{
+    if (mHeader && mHeader->sampleRate == sampleRate)
+        return true;
+    close();
+
+    uint32_t capacityFrames = roundUpPow2((uint64_t) sampleRate * capacityMs / 1000);
+    size_t stampsOffset = (sizeof(AudioTapHeader) + 63) & ~(size_t) 63;
+    size_t samplesOffset = stampsOffset + AUDIO_TAP_STAMPS * sizeof(AudioTapStamp);
+    size_t size = samplesOffset + capacityFrames * sizeof(float);
+
+    int fd = memfd_create(name.c_str(), MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0)
+    {
+        LOG_DEBUG("Error: Creating the %s tap failed: %s", name.c_str(), strerror(errno));
+        return false;
+    }
+    // Sealed so a consumer's mapping can never be cut short under it
+    if (ftruncate(fd, size) < 0
+            || fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0)
+    {
+        LOG_DEBUG("Error: Sizing the %s tap failed: %s", name.c_str(), strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    void *map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        LOG_DEBUG("Error: Mapping the %s tap failed: %s", name.c_str(), strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    uint8_t *base = static_cast<uint8_t*>(map);
+    AudioTapHeader *header = new (base) AudioTapHeader;
+    header->magic = AUDIO_TAP_MAGIC;
+    header->version = AUDIO_TAP_VERSION;
+    header->sampleRate = sampleRate;
+    header->channels = 1;
+    header->capacityFrames = capacityFrames;
+    header->stampCapacity = AUDIO_TAP_STAMPS;
+    header->stampsOffset = stampsOffset;
+    header->samplesOffset = samplesOffset;
+    header->writeStart.store(0, std::memory_order_relaxed);
+    header->writeEnd.store(0, std::memory_order_relaxed);
+    header->stampCount.store(0, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mFd = fd;
+    mSize = size;
+    mHeader = header;
+    mStamps = reinterpret_cast<AudioTapStamp*>(base + stampsOffset);
+    mSamples = reinterpret_cast<float*>(base + samplesOffset);
+    LOG_INFO(MSGID_AUDIO_TAP, 0, "%s tap: %u Hz, %u frames", name.c_str(), sampleRate, capacityFrames);
+    return true;
+}
+
+void AudioTap::close()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mHeader)
+        return;
+    // Consumers keep their own mappings of the memfd
+    munmap(mHeader, mSize);
+    ::close(mFd);
+    mFd = -1;
+    mSize = 0;
+    mHeader = nullptr;
+    mStamps = nullptr;
+    mSamples = nullptr;
+}
+
+void AudioTap::stamp(int64_t playNs)
+{
+    if (!mHeader)
+        return;
+    uint64_t count = mHeader->stampCount.load(std::memory_order_relaxed);
+    AudioTapStamp &stamp = mStamps[count % AUDIO_TAP_STAMPS];
+    stamp.frame = mHeader->writeEnd.load(std::memory_order_relaxed);
+    stamp.playNs = playNs;
+    mHeader->stampCount.store(count + 1, std::memory_order_release);
+}
+
+void AudioTap::write(const float* samples, size_t frames)
+{
+    if (!mHeader || frames == 0)
+        return;
+    uint32_t capacity = mHeader->capacityFrames;
+    // Only the newest capacity's worth can stay readable anyway
+    if (frames > capacity)
+    {
+        samples += frames - capacity;
+        frames = capacity;
+    }
+    uint64_t end = mHeader->writeEnd.load(std::memory_order_relaxed);
+    mHeader->writeStart.store(end + frames, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    size_t offset = end % capacity;
+    size_t first = std::min<size_t>(frames, capacity - offset);
+    memcpy(mSamples + offset, samples, first * sizeof(float));
+    memcpy(mSamples, samples + first, (frames - first) * sizeof(float));
+    mHeader->writeEnd.store(end + frames, std::memory_order_release);
+}
+
+int AudioTap::openReadOnly(unsigned int& sampleRate, unsigned int& capacityFrames) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mHeader)
+        return -1;
+    // A fresh read-only open of the memfd, a consumer cannot write through it
+    std::string path = "/proc/self/fd/" + std::to_string(mFd);
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        LOG_DEBUG("Error: Reopening the tap read-only failed: %s", strerror(errno));
+        return -1;
+    }
+    sampleRate = mHeader->sampleRate;
+    capacityFrames = mHeader->capacityFrames;
+    return fd;
+}
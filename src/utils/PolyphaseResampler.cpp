@@ -0,0 +1,102 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <cmath>
+#include <DspKernels.h>
+#include <PolyphaseResampler.h>
+
+#define KAISER_BETA 8.6
+
+static unsigned int gcd(unsigned int a, unsigned int b)
+{
+    while (b) {
+        unsigned int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Zeroth order modified Bessel function of the first kind
+static double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12)
+            break;
+    }
+    return sum;
+}
+
+PolyphaseResampler::PolyphaseResampler(unsigned int inRate,
+        unsigned int outRate, unsigned int taps) :
+        mInRate(inRate), mOutRate(outRate), mTaps(taps)
+{
+    unsigned int g = gcd(inRate, outRate);
+    mUp = outRate / g;
+    mDown = inRate / g;
+
+    // Cut off at the lower Nyquist frequency, relative to the upsampled rate
+    size_t length = (size_t) mUp * mTaps;
+    double cutoff = 0.5 / std::max(mUp, mDown) * 0.95;
+    // Centred on a whole sample so the delay below is exact
+    double center = length / 2;
+    double norm = besselI0(KAISER_BETA);
+
+    mPhases.assign(length, 0.0f);
+    for (size_t i = 0; i < length; i++) {
+        double t = i - center;
+        double sinc = (t == 0.0) ? 2.0 * cutoff
+                : std::sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+        double r = t / (center + 1.0);
+        double window = besselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+        // Gain mUp restores the level lost to zero stuffing
+        unsigned int phase = i % mUp;
+        unsigned int tap = i / mUp;
+        mPhases[phase * mTaps + (mTaps - 1 - tap)] = (float) (sinc * window * mUp);
+    }
+}
+
+void PolyphaseResampler::process(const int16_t* in, size_t count,
+        std::vector<int16_t>& out) const
+{
+    out.clear();
+    if (count == 0)
+        return;
+
+    size_t outCount = (size_t) (((uint64_t) count * mUp + mDown - 1) / mDown);
+    // Zero padding on both sides keeps every filter window in bounds
+    const DspKernels &dsp = getDspKernels();
+    std::vector<float> padded(count + 2 * mTaps, 0.0f);
+    dsp.s16ToFloat(in, &padded[mTaps - 1], count);
+    std::vector<float> filtered(outCount);
+    // Group delay of the prototype in upsampled samples
+    uint64_t delay = ((uint64_t) mUp * mTaps) / 2;
+
+    for (size_t n = 0; n < outCount; n++) {
+        uint64_t pos = (uint64_t) n * mDown + delay;
+        const float *h = &mPhases[(pos % mUp) * mTaps];
+        // First input sample of the window, shifted by the padding
+        size_t first = (size_t) (pos / mUp);
+        filtered[n] = dsp.dot(h, &padded[first], mTaps);
+    }
+    out.resize(outCount);
+    dsp.floatToS16(filtered.data(), out.data(), outCount);
+}
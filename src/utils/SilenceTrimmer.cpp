@@ -0,0 +1,68 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <algorithm>
+#include <cmath>
+#include <DspKernels.h>
+#include <SilenceTrimmer.h>
+#include <TTSLog.h>
+
+void SilenceTrimmer::loadConfig(const TTSConfig& config)
+{
+    pbnjson::JValue value;
+    (void) config.getValue("trim", "enabled", value);
+    if (value.isBoolean())
+        mEnabled = value.asBool();
+    (void) config.getValue("trim", "thresholdDb", value);
+    if (value.isNumber() && value.asNumber<int>() < 0)
+        mThresholdDb = value.asNumber<int>();
+    (void) config.getValue("trim", "padMs", value);
+    if (value.isNumber() && value.asNumber<int>() >= 0)
+        mPadMs = value.asNumber<int>();
+    LOG_DEBUG("Silence trim %s, threshold %d dB, pad %u ms", mEnabled ? "on" : "off", mThresholdDb, mPadMs);
+}
+
+void SilenceTrimmer::findSpeech(const float* samples, size_t count, unsigned int rate,
+        size_t& begin, size_t& end) const
+{
+    begin = 0;
+    end = count;
+    if (!mEnabled || count == 0)
+        return;
+
+    const DspKernels &dsp = getDspKernels();
+    const size_t window = std::max<size_t>((size_t) rate * TRIM_WINDOW_MS / 1000, 1);
+    const float threshold = std::pow(10.0f, mThresholdDb / 10.0f);
+    auto isSpeech = [&](size_t start) {
+        size_t n = std::min(window, count - start);
+        return dsp.dot(samples + start, samples + start, n) >= threshold * n;
+    };
+
+    size_t first = 0;
+    while (first < count && !isSpeech(first))
+        first += window;
+    // Nothing above the threshold, better played as is than dropped
+    if (first >= count)
+        return;
+    size_t last = (count - 1) / window * window;
+    while (last > first && !isSpeech(last))
+        last -= window;
+
+    size_t pad = (size_t) rate * mPadMs / 1000;
+    begin = (first > pad) ? first - pad : 0;
+    end = std::min(count, last + window + pad);
+}
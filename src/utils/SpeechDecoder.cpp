@@ -0,0 +1,99 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <DspKernels.h>
+#include <SpeechDecoder.h>
+#include <TTSLog.h>
+#include <WavHeader.h>
+
+bool SpeechDecoder::readFile(const std::string& path, std::vector<uint8_t>& data)
+{
+    // Small local file, read in one go so playback never waits on disk
+    std::ifstream file(path, std::ifstream::binary);
+    if (!file.is_open())
+    {
+        LOG_DEBUG("Error: File opening failed: %s", strerror(errno));
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool SpeechDecoder::decode(const uint8_t* data, size_t size, unsigned int outRate,
+        std::vector<float>& samples, size_t silence)
+{
+    WavHeader wav;
+    const uint8_t *pcm = data;
+    size_t pcmSize = size;
+    unsigned int rate = RAW_PCM_RATE;
+    unsigned int channels = RAW_PCM_CHANNELS;
+
+    // The header is not played as audio
+    if (parseWavHeader(data, size, wav))
+    {
+        if (wav.audioFormat != WAV_FORMAT_PCM || wav.bitsPerSample != 16)
+        {
+            LOG_DEBUG("Error: Unsupported WAV format %u/%u bits", wav.audioFormat, wav.bitsPerSample);
+            return false;
+        }
+        pcm += wav.dataOffset;
+        pcmSize = wav.dataSize;
+        rate = wav.sampleRate;
+        channels = wav.channels;
+    }
+
+    size_t frames = pcmSize / (sizeof(int16_t) * channels);
+    std::vector<int16_t> mono(frames);
+    for (size_t i = 0; i < frames; i++)
+    {
+        int sum = 0;
+        for (unsigned int ch = 0; ch < channels; ch++)
+        {
+            int16_t sample;
+            memcpy(&sample, pcm + (i * channels + ch) * sizeof(int16_t), sizeof(int16_t));
+            sum += sample;
+        }
+        mono[i] = (int16_t) (sum / (int) channels);
+    }
+
+    if (rate != outRate)
+    {
+        if (!mResampler || mResampler->getInRate() != rate || mResampler->getOutRate() != outRate)
+            mResampler.reset(new PolyphaseResampler(rate, outRate));
+        std::vector<int16_t> resampled;
+        mResampler->process(mono.data(), mono.size(), resampled);
+        mono.swap(resampled);
+    }
+
+    samples.assign(silence + mono.size(), 0.0f);
+    getDspKernels().s16ToFloat(mono.data(), samples.data() + silence, mono.size());
+
+    // Only what synthesis produced is trimmed, not the gap put in front
+    size_t begin = 0;
+    size_t end = mono.size();
+    mTrimmer.findSpeech(samples.data() + silence, mono.size(), outRate, begin, end);
+    samples.erase(samples.begin() + silence + end, samples.end());
+    samples.erase(samples.begin() + silence, samples.begin() + silence + begin);
+    mTrimmedMs = (unsigned int) ((mono.size() - (end - begin)) * 1000 / outRate);
+    if (mTrimmedMs > 0)
+        LOG_INFO("tts:audio:decoder", 0, "Trimmed %u ms of silence (%zu ms leading, %zu ms trailing)",
+                mTrimmedMs, begin * 1000 / outRate, (mono.size() - end) * 1000 / outRate);
+    return true;
+}
@@ -0,0 +1,172 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <algorithm>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib.h>
+#include <sys/eventfd.h>
+#include <SpeechStream.h>
+#include <TTSLog.h>
+
+static size_t toFrames(unsigned int ms, unsigned int rate)
+{
+    return (size_t) rate * ms / 1000;
+}
+
+SpeechStream::SpeechStream(std::vector<float> samples, const StreamLimits& limits, unsigned int rate) :
+        mRing(std::max(toFrames(limits.depthMs, rate), toFrames(limits.highWatermarkMs, rate))),
+        mLowWatermark(toFrames(limits.lowWatermarkMs, rate)),
+        mHighWatermark(std::max<size_t>(toFrames(limits.highWatermarkMs, rate), 1)),
+        mFeedIntervalMs(std::max(limits.lowWatermarkMs / 2, 1u)),
+        mSamples(std::move(samples))
+{
+    mHighWatermark = std::min(mHighWatermark, mRing.capacity());
+    mLowWatermark = std::min(mLowWatermark, mHighWatermark - 1);
+    mWakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (mWakeFd < 0)
+        LOG_DEBUG("Error: eventfd failed, the producer polls: %s", strerror(errno));
+}
+
+SpeechStream::~SpeechStream()
+{
+    if (mWakeFd >= 0)
+        close(mWakeFd);
+}
+
+StreamLimits SpeechStream::loadLimits(const TTSConfig& config)
+{
+    StreamLimits limits;
+    pbnjson::JValue value;
+    (void) config.getValue("stream", "depthMs", value);
+    if (value.isNumber() && value.asNumber<int>() > 0)
+        limits.depthMs = value.asNumber<int>();
+    (void) config.getValue("stream", "lowWatermarkMs", value);
+    if (value.isNumber() && value.asNumber<int>() >= 0)
+        limits.lowWatermarkMs = value.asNumber<int>();
+    (void) config.getValue("stream", "highWatermarkMs", value);
+    if (value.isNumber() && value.asNumber<int>() > 0)
+        limits.highWatermarkMs = value.asNumber<int>();
+    LOG_DEBUG("Stream depth %u ms, watermarks %u/%u ms", limits.depthMs,
+            limits.lowWatermarkMs, limits.highWatermarkMs);
+    return limits;
+}
+
+bool SpeechStream::feed()
+{
+    if (mAborted)
+        return true;
+    size_t fill = mRing.size();
+    if (fill < mHighWatermark && mFed < mSamples.size())
+        mFed += mRing.push(mSamples.data() + mFed, std::min(mHighWatermark - fill, mSamples.size() - mFed));
+    if (mFed < mSamples.size())
+        return false;
+    if (!mFinished)
+    {
+        std::vector<float>().swap(mSamples);
+        mFinished = true;
+    }
+    return true;
+}
+
+bool SpeechStream::waitForSpace()
+{
+    while (true)
+    {
+        mWaiting = true;
+        // Pairs with the fence in read(), so one side always sees the other
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mAborted || mRing.size() <= mLowWatermark)
+            break;
+        // The counter keeps a wakeup sent before poll(); without an
+        // eventfd poll() only sleeps for the interval
+        struct pollfd fd = { mWakeFd, POLLIN, 0 };
+        (void) poll(&fd, 1, mWakeFd >= 0 ? -1 : (int) mFeedIntervalMs);
+        uint64_t value = 0;
+        if (mWakeFd >= 0)
+            (void) ::read(mWakeFd, &value, sizeof(value));
+    }
+    mWaiting = false;
+    return !mAborted;
+}
+
+static gboolean feedSource(gpointer data)
+{
+    auto stream = static_cast<std::shared_ptr<SpeechStream>*>(data);
+    return (*stream)->feed() ? G_SOURCE_REMOVE : G_SOURCE_CONTINUE;
+}
+
+static void releaseSource(gpointer data)
+{
+    delete static_cast<std::shared_ptr<SpeechStream>*>(data);
+}
+
+void SpeechStream::feedOnMainLoop(std::shared_ptr<SpeechStream> stream)
+{
+    if (stream->feed())
+        return;
+    // Polled well inside the low watermark, the render thread has no way
+    // to wake the main loop
+    unsigned int interval = stream->mFeedIntervalMs;
+    g_timeout_add_full(G_PRIORITY_HIGH, interval, feedSource,
+            new std::shared_ptr<SpeechStream>(std::move(stream)), releaseSource);
+}
+
+size_t SpeechStream::read(float* out, size_t frames)
+{
+    // Taken first: anything pushed before finishing is already visible
+    bool finished = mFinished || mAborted;
+    size_t count = mRing.pop(out, frames);
+    if (count < frames && !finished)
+    {
+        std::fill(out + count, out + frames, 0.0f);
+        mUnderruns++;
+        count = frames;
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // One wakeup per wait, the producer sets mWaiting again before sleeping
+    if (mWaiting && mRing.size() <= mLowWatermark && mWaiting.exchange(false))
+        wake();
+    return count;
+}
+
+bool SpeechStream::isDrained() const
+{
+    return mAborted || (mFinished && mRing.size() == 0);
+}
+
+bool SpeechStream::isStarved() const
+{
+    return !mAborted && !mFinished && mRing.size() == 0;
+}
+
+void SpeechStream::abort()
+{
+    mAborted = true;
+    wake();
+}
+
+// A non-blocking eventfd write, safe from the render thread
+void SpeechStream::wake()
+{
+    uint64_t value = 1;
+    if (mWakeFd >= 0)
+        (void) ::write(mWakeFd, &value, sizeof(value));
+}
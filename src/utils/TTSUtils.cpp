@@ -14,10 +14,14 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <fstream>
+#include <sys/resource.h>
 #include <TTSUtils.h>
 #include <TTSLunaUtils.h>
 
-TTSUtils::TTSUtils()
+#define AUDIO_FILE_PREFIX "/tmp/sttsResult"
+
+TTSUtils::TTSUtils() : mDisplayCount(1)
 {}
 
 TTSUtils& TTSUtils::getInstance()
@@ -26,12 +30,51 @@ TTSUtils& TTSUtils::getInstance()
     return obj;
 }
 
+std::string TTSUtils::getAudioFilePath(unsigned int displayId)
+{
+    return AUDIO_FILE_PREFIX + std::to_string(displayId) + ".pcm";
+}
+
+unsigned int TTSUtils::getVoiceSlot(unsigned int displayId, unsigned int voice,
+        unsigned int displayCount)
+{
+    // The speech voice keeps the display id as its slot
+    return voice * displayCount + displayId;
+}
+
+bool TTSUtils::getProcessStats(ProcessStats& stats)
+{
+    std::ifstream status("/proc/self/status");
+    if (!status.is_open())
+        return false;
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 8, "Threads:") == 0)
+            stats.threads = std::stoi(line.substr(8));
+        else if (line.compare(0, 6, "VmRSS:") == 0)
+            stats.rssKb = std::stol(line.substr(6));
+    }
+    // RUSAGE_SELF also counts threads that already exited
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        stats.contextSwitches = usage.ru_nvcsw + usage.ru_nivcsw;
+    return true;
+}
+
+void TTSUtils::setDisplayCount(unsigned int displayCount)
+{
+    mDisplayCount = displayCount;
+}
+
 bool TTSUtils::isValidDisplayId(LS::Message &request, pbnjson::JValue& requestObj, unsigned int &displayId)
 {
     bool valid = true;
     if (requestObj.hasKey("displayId"))
-        displayId = requestObj["displayId"].asNumber<int>();
-    valid = (displayId > 1)? false : true;
+    {
+        int requestedId = requestObj["displayId"].asNumber<int>();
+        displayId = (requestedId < 0) ? mDisplayCount : requestedId;
+    }
+    valid = (displayId >= mDisplayCount)? false : true;
     if (!valid)
     {
         const std::string errorStr = TTSErrors::getTTSErrorString(TTSErrors::INVALID_PARAM);
@@ -0,0 +1,252 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <gio/gio.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <ThreadPolicy.h>
+#include <TTSLog.h>
+
+#define RTKIT_SERVICE       "org.freedesktop.RealtimeKit1"
+#define RTKIT_PATH          "/org/freedesktop/RealtimeKit1"
+#define RTKIT_TIMEOUT_MS    1000
+// rtkit only serves processes that bound their realtime CPU time
+#define RTKIT_RTTIME_US     200000
+
+static const char *roleNames[THREAD_ROLE_COUNT] = { "synthesis", "render", "luna" };
+
+static pid_t currentTid()
+{
+    return (pid_t) syscall(SYS_gettid);
+}
+
+static const char* policyName(int policy)
+{
+    switch (policy & ~SCHED_RESET_ON_FORK)
+    {
+        case SCHED_FIFO:
+            return "SCHED_FIFO";
+        case SCHED_RR:
+            return "SCHED_RR";
+        case SCHED_BATCH:
+            return "SCHED_BATCH";
+        case SCHED_IDLE:
+            return "SCHED_IDLE";
+        default:
+            return "SCHED_OTHER";
+    }
+}
+
+static bool rtkitMakeRealtime(pid_t tid, int priority, std::string& error)
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_RTTIME, &limit) == 0
+            && (limit.rlim_max == RLIM_INFINITY || limit.rlim_max > RTKIT_RTTIME_US))
+    {
+        limit.rlim_cur = RTKIT_RTTIME_US;
+        limit.rlim_max = RTKIT_RTTIME_US;
+        (void) setrlimit(RLIMIT_RTTIME, &limit);
+    }
+
+    GError *err = nullptr;
+    GVariant *reply = nullptr;
+    GDBusConnection *bus = g_bus_get_sync(G_BUS_TYPE_SYSTEM, nullptr, &err);
+    if (bus)
+    {
+        reply = g_dbus_connection_call_sync(bus, RTKIT_SERVICE, RTKIT_PATH, RTKIT_SERVICE,
+                "MakeThreadRealtime", g_variant_new("(tu)", (guint64) tid, (guint32) priority),
+                nullptr, G_DBUS_CALL_FLAGS_NONE, RTKIT_TIMEOUT_MS, nullptr, &err);
+        g_object_unref(bus);
+    }
+    if (!reply)
+    {
+        error = err ? err->message : "no reply";
+        if (err)
+            g_error_free(err);
+        return false;
+    }
+    g_variant_unref(reply);
+    return true;
+}
+
+const ThreadPolicy& ThreadPolicy::get()
+{
+    static const ThreadPolicy policy;
+    return policy;
+}
+
+ThreadPolicy::ThreadPolicy()
+{
+    // The main thread's set, which the threads started later inherit
+    CPU_ZERO(&mProcessCpus);
+    mHaveProcessCpus = sched_getaffinity(getpid(), sizeof(mProcessCpus), &mProcessCpus) == 0;
+    TTSConfig config;
+    if (config.readFile() == TTSErrors::TTS_CONFIG_ERROR_NONE)
+        loadConfig(config);
+}
+
+void ThreadPolicy::loadConfig(const TTSConfig& config)
+{
+    for (unsigned int role = 0; role < THREAD_ROLE_COUNT; role++)
+    {
+        pbnjson::JValue section;
+        (void) config.getValue("threads", roleNames[role], section);
+        if (!section.isObject())
+            continue;
+        Settings &settings = mSettings[role];
+        if (section["policy"].isString())
+            settings.policy = section["policy"].asString();
+        if (section["priority"].isNumber())
+            settings.priority = section["priority"].asNumber<int>();
+        pbnjson::JValue cpus = section["cpus"];
+        if (cpus.isArray())
+        {
+            for (ssize_t i = 0; i < cpus.arraySize(); i++)
+            {
+                if (cpus[i].isNumber() && cpus[i].asNumber<int>() >= 0)
+                    settings.cpus.push_back(cpus[i].asNumber<int>());
+            }
+        }
+        LOG_DEBUG("%s threads: policy %s priority %d, %zu cpus", roleNames[role], settings.policy.c_str(),
+                settings.priority, settings.cpus.size());
+    }
+}
+
+void ThreadPolicy::apply(ThreadRole role) const
+{
+    const Settings &settings = mSettings[role];
+    std::string error;
+    // A thread started from a realtime one would otherwise stay realtime
+    bool applied = (settings.policy == "other") ? setNormal(error) : setRealtime(settings, error);
+    if (!applied)
+    {
+        LOG_WARNING(MSGID_THREAD_POLICY, 0, "%s thread %d stays at its scheduling class, %s failed: %s",
+                roleNames[role], (int) currentTid(), settings.policy.c_str(), error.c_str());
+    }
+    setAffinity(settings, role, 0);
+    logApplied(role, 0);
+}
+
+void ThreadPolicy::applyAffinity(ThreadRole role, pid_t tid) const
+{
+    setAffinity(mSettings[role], role, tid);
+    logApplied(role, tid);
+}
+
+bool ThreadPolicy::setRealtime(const Settings& settings, std::string& error) const
+{
+    int priority = settings.priority;
+    if (settings.policy == "fifo" || settings.policy == "rr")
+    {
+        int policy = (settings.policy == "rr") ? SCHED_RR : SCHED_FIFO;
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        priority = std::min(std::max(priority, sched_get_priority_min(policy)), sched_get_priority_max(policy));
+        param.sched_priority = priority;
+        int err = pthread_setschedparam(pthread_self(), policy, &param);
+        if (err == 0)
+            return true;
+        error = std::string(policyName(policy)) + ": " + strerror(err);
+        // Without CAP_SYS_NICE or an RLIMIT_RTPRIO allowance rtkit may still grant it
+        if (err != EPERM)
+            return false;
+        error += ", ";
+    }
+    else if (settings.policy != "rtkit")
+    {
+        error = "unknown policy";
+        return false;
+    }
+
+    std::string rtkitError;
+    if (rtkitMakeRealtime(currentTid(), priority, rtkitError))
+        return true;
+    error += (settings.policy == "rtkit") ? rtkitError : "rtkit: " + rtkitError;
+    return false;
+}
+
+bool ThreadPolicy::setNormal(std::string& error)
+{
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    int err = pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+    if (err == 0)
+        return true;
+    error = strerror(err);
+    return false;
+}
+
+void ThreadPolicy::setAffinity(const Settings& settings, ThreadRole role, pid_t tid) const
+{
+    // No CPUs configured undoes a set inherited from a pinned thread
+    cpu_set_t set = mProcessCpus;
+    if (settings.cpus.empty() && !mHaveProcessCpus)
+        return;
+    if (!settings.cpus.empty())
+    {
+        CPU_ZERO(&set);
+        for (int cpu : settings.cpus)
+        {
+            if (cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &set);
+        }
+    }
+    if (sched_setaffinity(tid, sizeof(set), &set) != 0)
+    {
+        LOG_WARNING(MSGID_THREAD_POLICY, 0, "%s thread %d keeps its CPU set: %s",
+                roleNames[role], (int) (tid ? tid : currentTid()), strerror(errno));
+    }
+}
+
+// What the kernel actually runs the thread with
+void ThreadPolicy::logApplied(ThreadRole role, pid_t tid)
+{
+    int policy = std::max(sched_getscheduler(tid), 0);
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    (void) sched_getparam(tid, &param);
+
+    std::string cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(tid, sizeof(set), &set) == 0)
+    {
+        // As ranges, "0-3,6"
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (!CPU_ISSET(cpu, &set))
+                continue;
+            int last = cpu;
+            while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, &set))
+                last++;
+            if (!cpus.empty())
+                cpus += ",";
+            cpus += std::to_string(cpu);
+            if (last > cpu)
+                cpus += "-" + std::to_string(last);
+            cpu = last;
+        }
+    }
+    LOG_INFO(MSGID_THREAD_POLICY, 0, "%s thread %d: %s priority %d, cpus %s", roleNames[role],
+            (int) (tid ? tid : currentTid()), policyName(policy), param.sched_priority, cpus.c_str());
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstring>
+#include <WavHeader.h>
+
+#define RIFF_HEADER_SIZE 12
+#define CHUNK_HEADER_SIZE 8
+#define FMT_CHUNK_MIN_SIZE 16
+
+static uint16_t readLE16(const uint8_t* p)
+{
+    return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static uint32_t readLE32(const uint8_t* p)
+{
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16)
+            | ((uint32_t) p[3] << 24);
+}
+
+bool parseWavHeader(const uint8_t* data, size_t size, WavHeader& header)
+{
+    if (size < RIFF_HEADER_SIZE || memcmp(data, "RIFF", 4) != 0
+            || memcmp(data + 8, "WAVE", 4) != 0)
+        return false;
+
+    bool haveFormat = false;
+    size_t pos = RIFF_HEADER_SIZE;
+    while (pos + CHUNK_HEADER_SIZE <= size) {
+        const uint8_t *chunk = data + pos;
+        size_t chunkSize = readLE32(chunk + 4);
+        size_t body = pos + CHUNK_HEADER_SIZE;
+
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            if (chunkSize < FMT_CHUNK_MIN_SIZE || body + FMT_CHUNK_MIN_SIZE > size)
+                return false;
+            header.audioFormat = readLE16(data + body);
+            header.channels = readLE16(data + body + 2);
+            header.sampleRate = readLE32(data + body + 4);
+            header.bitsPerSample = readLE16(data + body + 14);
+            haveFormat = true;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!haveFormat)
+                return false;
+            header.dataOffset = body;
+            // Streamed WAVs may carry a placeholder size, clamp to what we have
+            header.dataSize = (chunkSize > size - body) ? size - body : chunkSize;
+            return header.channels > 0 && header.sampleRate > 0;
+        }
+        // Chunks are padded to an even size
+        pos = body + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
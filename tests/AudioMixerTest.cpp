@@ -0,0 +1,165 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+// Constant sample values make the output the voice's gain, so the duck
+// ramp can be read straight off it.
+
+#include <memory>
+#include <vector>
+#include <gtest/gtest.h>
+#include <AudioMixer.h>
+
+namespace {
+
+const float DUCK_LEVEL = 0.25f;
+const size_t RAMP_FRAMES = 100;
+
+std::vector<float> ramp(size_t count)
+{
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; i++)
+        samples[i] = (float) i / count;
+    return samples;
+}
+
+// Mixes frames frames in blocks, as an engine's write callback would
+std::vector<float> mixBlocks(AudioMixer& mixer, size_t frames, size_t block)
+{
+    std::vector<float> out;
+    std::vector<float> buffer(block);
+    while (out.size() < frames) {
+        size_t count = mixer.mix(buffer.data(), block);
+        if (count == 0)
+            break;
+        out.insert(out.end(), buffer.begin(), buffer.begin() + count);
+    }
+    return out;
+}
+
+TEST(AudioMixerTest, SingleVoicePlaysUnchanged)
+{
+    AudioMixer mixer;
+    std::vector<float> samples = ramp(100);
+    mixer.setVoice(VOICE_SPEECH, samples);
+    EXPECT_TRUE(mixer.isActive(VOICE_SPEECH));
+
+    std::vector<float> out(64);
+    EXPECT_EQ(64u, mixer.mix(out.data(), out.size()));
+    EXPECT_EQ(std::vector<float>(samples.begin(), samples.begin() + 64), out);
+    EXPECT_EQ(36u, mixer.mix(out.data(), out.size()));
+    EXPECT_EQ(std::vector<float>(samples.begin() + 64, samples.end()),
+            std::vector<float>(out.begin(), out.begin() + 36));
+    EXPECT_FALSE(mixer.isActive());
+    EXPECT_EQ(0u, mixer.mix(out.data(), out.size()));
+}
+
+TEST(AudioMixerTest, VoiceEndingEarlyIsPaddedWithSilence)
+{
+    AudioMixer mixer;
+    mixer.setDucking(1.0f, 0);
+    mixer.setVoice(VOICE_SPEECH, std::vector<float>(100, 0.5f));
+    mixer.setVoice(VOICE_ALERT, std::vector<float>(40, 0.25f));
+
+    std::vector<float> out(128, -1.0f);
+    ASSERT_EQ(100u, mixer.mix(out.data(), out.size()));
+    for (size_t i = 0; i < 40; i++)
+        EXPECT_FLOAT_EQ(0.75f, out[i]) << "at " << i;
+    for (size_t i = 40; i < 100; i++)
+        EXPECT_FLOAT_EQ(0.5f, out[i]) << "at " << i;
+    EXPECT_FALSE(mixer.isActive(VOICE_ALERT));
+}
+
+TEST(AudioMixerTest, DuckRampsToTheLevelAndRestoresAfterTheAlert)
+{
+    AudioMixer mixer;
+    mixer.setDucking(DUCK_LEVEL, RAMP_FRAMES);
+    mixer.setVoice(VOICE_SPEECH, std::vector<float>(2000, 1.0f));
+    std::vector<float> before = mixBlocks(mixer, 100, 50);
+    for (float sample : before)
+        ASSERT_FLOAT_EQ(1.0f, sample);
+
+    // Silent, so the output is the speech gain alone. It ends on a block
+    // boundary, releasing the duck from the next block on.
+    const size_t ALERT_FRAMES = 300;
+    mixer.setVoice(VOICE_ALERT, std::vector<float>(ALERT_FRAMES, 0.0f));
+    std::vector<float> out = mixBlocks(mixer, 800, 50);
+    ASSERT_EQ(800u, out.size());
+
+    EXPECT_NEAR(1.0f, out[0], 1e-6f);
+    for (size_t i = 1; i <= RAMP_FRAMES; i++)
+        EXPECT_LE(out[i], out[i - 1]) << "at " << i;
+    for (size_t i = RAMP_FRAMES + 1; i < ALERT_FRAMES; i++)
+        EXPECT_FLOAT_EQ(DUCK_LEVEL, out[i]) << "at " << i;
+
+    EXPECT_NEAR(DUCK_LEVEL, out[ALERT_FRAMES], 1e-6f);
+    for (size_t i = ALERT_FRAMES + 1; i <= ALERT_FRAMES + RAMP_FRAMES; i++)
+        EXPECT_GE(out[i], out[i - 1]) << "at " << i;
+    for (size_t i = ALERT_FRAMES + RAMP_FRAMES + 1; i < out.size(); i++)
+        EXPECT_FLOAT_EQ(1.0f, out[i]) << "at " << i;
+}
+
+TEST(AudioMixerTest, VoiceStartingUnderALouderOneBeginsDucked)
+{
+    AudioMixer mixer;
+    mixer.setDucking(DUCK_LEVEL, RAMP_FRAMES);
+    mixer.setVoice(VOICE_ALERT, std::vector<float>(200, 0.0f));
+    mixer.setVoice(VOICE_SPEECH, std::vector<float>(100, 1.0f));
+
+    std::vector<float> out = mixBlocks(mixer, 100, 100);
+    ASSERT_EQ(100u, out.size());
+    for (size_t i = 0; i < out.size(); i++)
+        EXPECT_FLOAT_EQ(DUCK_LEVEL, out[i]) << "at " << i;
+}
+
+TEST(AudioMixerTest, ReservedBlocksMixTheSameAsOneCall)
+{
+    AudioMixer whole;
+    AudioMixer blocked;
+    blocked.reserve(16);
+    for (AudioMixer *mixer : { &whole, &blocked }) {
+        mixer->setDucking(1.0f, 0);
+        mixer->setVoice(VOICE_SPEECH, ramp(100));
+        mixer->setVoice(VOICE_ALERT, std::vector<float>(37, 0.125f));
+    }
+    std::vector<float> expected(128), actual(128);
+    EXPECT_EQ(100u, whole.mix(expected.data(), expected.size()));
+    EXPECT_EQ(100u, blocked.mix(actual.data(), actual.size()));
+    EXPECT_EQ(expected, actual);
+}
+
+TEST(AudioMixerTest, StarvedStreamVoicePlaysSilence)
+{
+    StreamLimits limits;
+    std::shared_ptr<SpeechStream> stream =
+            std::make_shared<SpeechStream>(std::vector<float>(10, 0.5f), limits, 16000);
+    AudioMixer mixer;
+    mixer.setVoice(VOICE_SPEECH, stream);
+    EXPECT_TRUE(mixer.isStarved());
+
+    std::vector<float> out(16, -1.0f);
+    EXPECT_EQ(16u, mixer.mix(out.data(), out.size()));
+    EXPECT_EQ(std::vector<float>(16, 0.0f), out);
+
+    ASSERT_TRUE(stream->feed());
+    EXPECT_FALSE(mixer.isStarved());
+    EXPECT_EQ(10u, mixer.mix(out.data(), out.size()));
+    EXPECT_EQ(std::vector<float>(10, 0.5f), std::vector<float>(out.begin(), out.begin() + 10));
+    EXPECT_FALSE(mixer.isActive());
+}
+
+} // namespace
@@ -0,0 +1,221 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+// Every SIMD variant this CPU can run against the scalar kernels, over
+// lengths around each vector width so the tails are covered, and from an
+// odd element offset since buffers need no particular alignment.
+// Conversions and the peak must match exactly; the float arithmetic may
+// differ by rounding, mostly from a different summation order in dot().
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <DspKernels.h>
+
+#if defined(__arm__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+namespace {
+
+const size_t LENGTHS[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 1023, 1024, 1025 };
+const size_t OFFSETS[] = { 0, 1 };
+
+// Same checks getDspKernels() makes before handing a variant out
+std::vector<const DspKernels*> getSimdVariants()
+{
+    std::vector<const DspKernels*> variants;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (getSse2DspKernels() && __builtin_cpu_supports("sse2"))
+        variants.push_back(getSse2DspKernels());
+    if (getAvx2DspKernels() && __builtin_cpu_supports("avx2"))
+        variants.push_back(getAvx2DspKernels());
+#elif defined(__aarch64__)
+    variants.push_back(getNeonDspKernels());
+#elif defined(__arm__)
+    if (getNeonDspKernels() && (getauxval(AT_HWCAP) & HWCAP_NEON))
+        variants.push_back(getNeonDspKernels());
+#endif
+    return variants;
+}
+
+std::vector<float> randomFloats(size_t count, float range, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-range, range);
+    std::vector<float> values(count);
+    for (float &value : values)
+        value = dist(rng);
+    return values;
+}
+
+std::vector<int16_t> randomS16(size_t count, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dist(-32768, 32767);
+    std::vector<int16_t> values(count);
+    for (int16_t &value : values)
+        value = (int16_t) dist(rng);
+    return values;
+}
+
+class DspKernelsTest : public ::testing::TestWithParam<const DspKernels*>
+{
+protected:
+    const DspKernels &scalar = getScalarDspKernels();
+    const DspKernels &simd = *GetParam();
+};
+
+TEST_P(DspKernelsTest, S16ToFloatMatchesScalar)
+{
+    for (size_t offset : OFFSETS) {
+        for (size_t length : LENGTHS) {
+            SCOPED_TRACE("length " + std::to_string(length) + " offset " + std::to_string(offset));
+            std::vector<int16_t> in = randomS16(length + offset, length);
+            if (length > 0)
+                in[offset] = -32768;
+            std::vector<float> expected(length + offset), actual(length + offset);
+            scalar.s16ToFloat(in.data() + offset, expected.data() + offset, length);
+            simd.s16ToFloat(in.data() + offset, actual.data() + offset, length);
+            EXPECT_EQ(expected, actual);
+        }
+    }
+}
+
+TEST_P(DspKernelsTest, FloatToS16MatchesScalar)
+{
+    for (size_t offset : OFFSETS) {
+        for (size_t length : LENGTHS) {
+            SCOPED_TRACE("length " + std::to_string(length) + " offset " + std::to_string(offset));
+            // Past full scale, so both ends saturate
+            std::vector<float> in = randomFloats(length + offset, 1.5f, length);
+            // Halfway values, rounded to even
+            for (size_t i = offset; i < in.size() && i < offset + 4; i++)
+                in[i] = (2.5f + (float) i) / 32768.0f;
+            std::vector<int16_t> expected(length + offset), actual(length + offset);
+            scalar.floatToS16(in.data() + offset, expected.data() + offset, length);
+            simd.floatToS16(in.data() + offset, actual.data() + offset, length);
+            EXPECT_EQ(expected, actual);
+        }
+    }
+}
+
+TEST_P(DspKernelsTest, GainRampMatchesScalar)
+{
+    for (size_t offset : OFFSETS) {
+        for (size_t length : LENGTHS) {
+            SCOPED_TRACE("length " + std::to_string(length) + " offset " + std::to_string(offset));
+            std::vector<float> expected = randomFloats(length + offset, 1.0f, length);
+            std::vector<float> actual = expected;
+            // A duck ramp, as the mixer runs it
+            scalar.gainRamp(expected.data() + offset, length, 1.0f, -0.75f / 1024);
+            simd.gainRamp(actual.data() + offset, length, 1.0f, -0.75f / 1024);
+            for (size_t i = 0; i < expected.size(); i++)
+                EXPECT_NEAR(expected[i], actual[i], 1e-6f) << "at " << i;
+        }
+    }
+}
+
+TEST_P(DspKernelsTest, MixAddMatchesScalar)
+{
+    for (size_t offset : OFFSETS) {
+        for (size_t length : LENGTHS) {
+            SCOPED_TRACE("length " + std::to_string(length) + " offset " + std::to_string(offset));
+            std::vector<float> src = randomFloats(length + offset, 1.0f, length);
+            std::vector<float> expected = randomFloats(length + offset, 1.0f, length + 1);
+            std::vector<float> actual = expected;
+            scalar.mixAdd(expected.data() + offset, src.data() + offset, length, 0.25f);
+            simd.mixAdd(actual.data() + offset, src.data() + offset, length, 0.25f);
+            for (size_t i = 0; i < expected.size(); i++)
+                EXPECT_NEAR(expected[i], actual[i], 1e-6f) << "at " << i;
+        }
+    }
+}
+
+TEST_P(DspKernelsTest, DotMatchesScalar)
+{
+    for (size_t offset : OFFSETS) {
+        for (size_t length : LENGTHS) {
+            SCOPED_TRACE("length " + std::to_string(length) + " offset " + std::to_string(offset));
+            std::vector<float> a = randomFloats(length + offset, 1.0f, length);
+            std::vector<float> b = randomFloats(length + offset, 1.0f, length + 1);
+            // Summation order differs, so allow rounding on every term
+            double magnitude = 0.0;
+            for (size_t i = offset; i < a.size(); i++)
+                magnitude += std::fabs(a[i] * b[i]);
+            float expected = scalar.dot(a.data() + offset, b.data() + offset, length);
+            float actual = simd.dot(a.data() + offset, b.data() + offset, length);
+            EXPECT_NEAR(expected, actual, 1e-6 * (magnitude + 1.0));
+        }
+    }
+}
+
+TEST_P(DspKernelsTest, PeakS16MatchesScalarAtEveryPosition)
+{
+    for (size_t offset : OFFSETS) {
+        for (size_t length : LENGTHS) {
+            if (length == 0) {
+                int16_t none = 0;
+                EXPECT_EQ(scalar.peakS16(&none, 0), simd.peakS16(&none, 0));
+                continue;
+            }
+            SCOPED_TRACE("length " + std::to_string(length) + " offset " + std::to_string(offset));
+            // Quiet, so the loud sample is the peak wherever it is
+            std::vector<int16_t> in(length + offset);
+            std::mt19937 rng(length);
+            std::uniform_int_distribution<int> dist(-1000, 1000);
+            for (int16_t &value : in)
+                value = (int16_t) dist(rng);
+            for (size_t position = 0; position < length; position++) {
+                for (int16_t loud : { (int16_t) -32768, (int16_t) 32767, (int16_t) -20000 }) {
+                    int16_t saved = in[offset + position];
+                    in[offset + position] = loud;
+                    int expected = scalar.peakS16(in.data() + offset, length);
+                    EXPECT_EQ(expected, simd.peakS16(in.data() + offset, length))
+                            << "at " << position << " value " << loud;
+                    in[offset + position] = saved;
+                }
+            }
+        }
+    }
+}
+
+std::string variantName(const ::testing::TestParamInfo<const DspKernels*>& info)
+{
+    return info.param->name;
+}
+
+INSTANTIATE_TEST_SUITE_P(Simd, DspKernelsTest, ::testing::ValuesIn(getSimdVariants()), variantName);
+// Nothing to compare on a CPU without a SIMD variant
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(DspKernelsTest);
+
+TEST(DspKernels, SelectedVariantIsAvailable)
+{
+    std::vector<const DspKernels*> variants = getSimdVariants();
+    const DspKernels *selected = &getDspKernels();
+    if (variants.empty())
+        EXPECT_EQ(selected, &getScalarDspKernels());
+    else
+        EXPECT_EQ(selected, variants.back());
+}
+
+}
@@ -0,0 +1,120 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <MPSCRing.h>
+
+namespace {
+
+TEST(MPSCRingTest, CapacityRoundsUpToAPowerOfTwo)
+{
+    EXPECT_EQ(2u, MPSCRing<int>(0).capacity());
+    EXPECT_EQ(2u, MPSCRing<int>(1).capacity());
+    EXPECT_EQ(8u, MPSCRing<int>(5).capacity());
+    EXPECT_EQ(256u, MPSCRing<int>(256).capacity());
+}
+
+TEST(MPSCRingTest, FullAndEmptyBoundaries)
+{
+    MPSCRing<int> ring(4);
+    int value = -1;
+    EXPECT_FALSE(ring.pop(value));
+    for (int i = 0; i < 4; i++)
+        EXPECT_TRUE(ring.push(i));
+    EXPECT_FALSE(ring.push(4));
+
+    EXPECT_TRUE(ring.pop(value));
+    EXPECT_EQ(0, value);
+    EXPECT_TRUE(ring.push(4));
+    EXPECT_FALSE(ring.push(5));
+
+    for (int i = 1; i <= 4; i++) {
+        EXPECT_TRUE(ring.pop(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_FALSE(ring.pop(value));
+}
+
+TEST(MPSCRingTest, KeepsOrderAcrossWraparound)
+{
+    MPSCRing<int> ring(8);
+    int next = 0;
+    int expected = 0;
+    // 3 in, 2 out, so the fill level and the wrap point keep moving
+    for (int round = 0; round < 1000; round++) {
+        for (int i = 0; i < 3; i++) {
+            if (ring.push(next))
+                next++;
+        }
+        int value = -1;
+        for (int i = 0; i < 2 && ring.pop(value); i++)
+            EXPECT_EQ(expected++, value);
+    }
+    int value = -1;
+    while (ring.pop(value))
+        EXPECT_EQ(expected++, value);
+    EXPECT_EQ(next, expected);
+}
+
+TEST(MPSCRingTest, ProducersKeepTheirOrderAndNothingIsLost)
+{
+    const int PRODUCERS = 4;
+    const int PER_PRODUCER = 100000;
+    // Small, so producers keep finding it full
+    MPSCRing<int> ring(64);
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < PRODUCERS; producer++) {
+        producers.emplace_back([&ring, producer]() {
+            for (int i = 0; i < PER_PRODUCER; i++) {
+                while (!ring.push(producer * PER_PRODUCER + i))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<int> next(PRODUCERS, 0);
+    int received = 0;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        int value = -1;
+        if (!ring.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        // Failures are not fatal, the producers must still be joined
+        received++;
+        int producer = value / PER_PRODUCER;
+        if (producer < 0 || producer >= PRODUCERS) {
+            ADD_FAILURE() << "unexpected value " << value;
+            continue;
+        }
+        EXPECT_EQ(next[producer], value % PER_PRODUCER) << "producer " << producer;
+        next[producer] = value % PER_PRODUCER + 1;
+    }
+    for (std::thread &producer : producers)
+        producer.join();
+
+    int value = -1;
+    EXPECT_FALSE(ring.pop(value));
+    for (int producer = 0; producer < PRODUCERS; producer++)
+        EXPECT_EQ(PER_PRODUCER, next[producer]);
+}
+
+} // namespace
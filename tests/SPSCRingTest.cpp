@@ -0,0 +1,114 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include <random>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <SPSCRing.h>
+
+namespace {
+
+std::vector<int> sequence(int first, size_t count)
+{
+    std::vector<int> values(count);
+    for (size_t i = 0; i < count; i++)
+        values[i] = first + (int) i;
+    return values;
+}
+
+TEST(SPSCRingTest, CapacityRoundsUpToAPowerOfTwo)
+{
+    EXPECT_EQ(1u, SPSCRing<int>(1).capacity());
+    EXPECT_EQ(8u, SPSCRing<int>(5).capacity());
+    EXPECT_EQ(1024u, SPSCRing<int>(1024).capacity());
+}
+
+TEST(SPSCRingTest, PushAndPopStopAtFullAndEmpty)
+{
+    SPSCRing<int> ring(8);
+    std::vector<int> out(16, -1);
+    EXPECT_EQ(0u, ring.pop(out.data(), out.size()));
+
+    std::vector<int> in = sequence(0, 12);
+    EXPECT_EQ(8u, ring.push(in.data(), in.size()));
+    EXPECT_EQ(8u, ring.size());
+    EXPECT_EQ(0u, ring.push(in.data(), 1));
+
+    EXPECT_EQ(3u, ring.pop(out.data(), 3));
+    EXPECT_EQ(5u, ring.size());
+    EXPECT_EQ(5u, ring.pop(out.data() + 3, 13));
+    out.resize(8);
+    EXPECT_EQ(sequence(0, 8), out);
+    EXPECT_EQ(0u, ring.size());
+}
+
+TEST(SPSCRingTest, ChunksSplitAcrossTheEnd)
+{
+    SPSCRing<int> ring(8);
+    std::vector<int> out(8);
+    std::vector<int> in = sequence(0, 5);
+    ASSERT_EQ(5u, ring.push(in.data(), 5));
+    ASSERT_EQ(5u, ring.pop(out.data(), 5));
+
+    // Starts at index 5, so 3 items go at the end and 4 at the front
+    in = sequence(100, 7);
+    ASSERT_EQ(7u, ring.push(in.data(), 7));
+    out.assign(7, -1);
+    ASSERT_EQ(7u, ring.pop(out.data(), 7));
+    EXPECT_EQ(in, out);
+}
+
+TEST(SPSCRingTest, StreamsInOrderBetweenTwoThreads)
+{
+    const int TOTAL = 1000000;
+    SPSCRing<int> ring(256);
+
+    std::thread producer([&ring]() {
+        std::mt19937 rng(1);
+        std::uniform_int_distribution<size_t> chunk(1, 100);
+        std::vector<int> in;
+        int next = 0;
+        while (next < TOTAL) {
+            size_t count = std::min<size_t>(chunk(rng), TOTAL - next);
+            in = sequence(next, count);
+            size_t pushed = ring.push(in.data(), count);
+            next += (int) pushed;
+            if (pushed == 0)
+                std::this_thread::yield();
+        }
+    });
+
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<size_t> chunk(1, 100);
+    std::vector<int> out(100);
+    int expected = 0;
+    bool inOrder = true;
+    while (expected < TOTAL) {
+        size_t count = ring.pop(out.data(), chunk(rng));
+        for (size_t i = 0; i < count; i++)
+            inOrder = inOrder && (out[i] == expected++);
+        if (count == 0)
+            std::this_thread::yield();
+    }
+    producer.join();
+    EXPECT_TRUE(inOrder);
+    EXPECT_EQ(0u, ring.size());
+}
+
+} // namespace
@@ -0,0 +1,138 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+// At 1000 Hz a millisecond is one frame: a 64 frame ring filled to 48
+// and refilled once it drains to 16.
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <SpeechStream.h>
+
+namespace {
+
+const unsigned int RATE = 1000;
+
+StreamLimits testLimits()
+{
+    StreamLimits limits;
+    limits.depthMs = 64;
+    limits.highWatermarkMs = 48;
+    limits.lowWatermarkMs = 16;
+    return limits;
+}
+
+std::vector<float> ramp(size_t count)
+{
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; i++)
+        samples[i] = (float) (i + 1);
+    return samples;
+}
+
+TEST(SpeechStreamTest, StarvedUntilFedAndPadsTheUnderrun)
+{
+    SpeechStream stream(ramp(10), testLimits(), RATE);
+    EXPECT_TRUE(stream.isStarved());
+    EXPECT_FALSE(stream.isDrained());
+
+    std::vector<float> out(4, -1.0f);
+    EXPECT_EQ(4u, stream.read(out.data(), out.size()));
+    EXPECT_EQ(std::vector<float>(4, 0.0f), out);
+    EXPECT_EQ(1u, stream.getUnderruns());
+}
+
+TEST(SpeechStreamTest, FeedStopsAtTheHighWatermark)
+{
+    std::vector<float> samples = ramp(200);
+    SpeechStream stream(samples, testLimits(), RATE);
+    EXPECT_FALSE(stream.feed());
+
+    std::vector<float> out(48);
+    EXPECT_EQ(48u, stream.read(out.data(), out.size()));
+    EXPECT_EQ(std::vector<float>(samples.begin(), samples.begin() + 48), out);
+    EXPECT_EQ(0u, stream.getUnderruns());
+    EXPECT_TRUE(stream.isStarved());
+}
+
+TEST(SpeechStreamTest, ReturnsFewerFramesOnlyAtTheEnd)
+{
+    std::vector<float> samples = ramp(30);
+    SpeechStream stream(samples, testLimits(), RATE);
+    EXPECT_TRUE(stream.feed());
+
+    std::vector<float> out(64);
+    EXPECT_EQ(30u, stream.read(out.data(), out.size()));
+    out.resize(30);
+    EXPECT_EQ(samples, out);
+    EXPECT_TRUE(stream.isDrained());
+    EXPECT_EQ(0u, stream.read(out.data(), out.size()));
+    EXPECT_EQ(0u, stream.getUnderruns());
+}
+
+TEST(SpeechStreamTest, ProducerThreadDeliversEverySampleInOrder)
+{
+    std::vector<float> samples = ramp(20000);
+    SpeechStream stream(samples, testLimits(), RATE);
+    std::thread producer([&stream]() {
+        while (!stream.feed()) {
+            if (!stream.waitForSpace())
+                break;
+        }
+    });
+
+    // One frame at a time and only while something is buffered, so the
+    // reader never pads; the producer must be woken at the low watermark
+    std::vector<float> received;
+    while (!stream.isDrained()) {
+        if (stream.isStarved()) {
+            std::this_thread::yield();
+            continue;
+        }
+        float sample = 0.0f;
+        if (stream.read(&sample, 1) == 1)
+            received.push_back(sample);
+    }
+    producer.join();
+    EXPECT_EQ(samples, received);
+    EXPECT_EQ(0u, stream.getUnderruns());
+}
+
+TEST(SpeechStreamTest, AbortReleasesAWaitingProducer)
+{
+    SpeechStream stream(ramp(1000), testLimits(), RATE);
+    bool released = true;
+    std::thread producer([&stream, &released]() {
+        while (!stream.feed()) {
+            if (!stream.waitForSpace()) {
+                released = false;
+                break;
+            }
+        }
+    });
+    // Nothing reads, so the producer sleeps above the low watermark
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    stream.abort();
+    producer.join();
+    EXPECT_FALSE(released);
+    EXPECT_TRUE(stream.isDrained());
+    EXPECT_TRUE(stream.feed());
+}
+
+} // namespace
@@ -0,0 +1,151 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+// Deadlines are placed mid-tick, well clear of the tick boundaries, so
+// the few microseconds between constructing the wheel and reading the
+// clock cannot move an expiry across one.
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <TimerWheel.h>
+
+namespace {
+
+typedef TimerWheel<int> Wheel;
+
+const std::chrono::milliseconds TICK(100);
+const size_t SLOTS = 8;
+
+std::chrono::milliseconds ms(long count)
+{
+    return std::chrono::milliseconds(count);
+}
+
+class TimerWheelTest : public ::testing::Test
+{
+protected:
+    Wheel wheel { TICK, SLOTS };
+    Wheel::Clock::time_point start = Wheel::Clock::now();
+    std::vector<int> expired;
+
+    std::vector<int> advanceTo(std::chrono::milliseconds offset)
+    {
+        expired.clear();
+        wheel.advance(start + offset, expired);
+        std::sort(expired.begin(), expired.end());
+        return expired;
+    }
+};
+
+TEST_F(TimerWheelTest, ExpiresOnceTheDeadlineTickPasses)
+{
+    wheel.schedule(1, start + ms(250));
+    EXPECT_TRUE(advanceTo(ms(150)).empty());
+    EXPECT_TRUE(advanceTo(ms(250)).empty());
+    EXPECT_EQ(std::vector<int>({ 1 }), advanceTo(ms(350)));
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_TRUE(advanceTo(ms(1000)).empty());
+}
+
+TEST_F(TimerWheelTest, CancelledKeysNeverExpire)
+{
+    wheel.schedule(1, start + ms(250));
+    wheel.schedule(2, start + ms(250));
+    EXPECT_TRUE(wheel.cancel(1));
+    EXPECT_FALSE(wheel.cancel(1));
+    EXPECT_FALSE(wheel.cancel(3));
+    EXPECT_EQ(std::vector<int>({ 2 }), advanceTo(ms(550)));
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST_F(TimerWheelTest, RescheduleReplacesTheDeadline)
+{
+    wheel.schedule(1, start + ms(250));
+    wheel.schedule(1, start + ms(650));
+    EXPECT_TRUE(advanceTo(ms(550)).empty());
+    EXPECT_EQ(std::vector<int>({ 1 }), advanceTo(ms(750)));
+}
+
+TEST_F(TimerWheelTest, SameSlotOnLaterRevolutionsWaits)
+{
+    // Ticks 3, 11 and 19 all hash to slot 3
+    wheel.schedule(1, start + ms(250));
+    wheel.schedule(2, start + ms(250) + TICK * SLOTS);
+    wheel.schedule(3, start + ms(250) + TICK * SLOTS * 2);
+    EXPECT_EQ(std::vector<int>({ 1 }), advanceTo(ms(350)));
+    EXPECT_TRUE(advanceTo(ms(1050)).empty());
+    EXPECT_EQ(std::vector<int>({ 2 }), advanceTo(ms(1150)));
+    EXPECT_EQ(std::vector<int>({ 3 }), advanceTo(ms(1950)));
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST_F(TimerWheelTest, GapLongerThanARevolutionExpiresOnlyWhatIsDue)
+{
+    wheel.schedule(1, start + ms(250));
+    wheel.schedule(2, start + ms(2050));
+    wheel.schedule(3, start + ms(50050));
+    EXPECT_EQ(std::vector<int>({ 1, 2 }), advanceTo(ms(10000)));
+    EXPECT_FALSE(wheel.empty());
+    EXPECT_TRUE(advanceTo(ms(49950)).empty());
+    EXPECT_EQ(std::vector<int>({ 3 }), advanceTo(ms(60000)));
+}
+
+TEST_F(TimerWheelTest, PastDeadlineExpiresOnTheNextTick)
+{
+    wheel.schedule(1, start - ms(1000));
+    wheel.schedule(2, start);
+    EXPECT_TRUE(advanceTo(ms(50)).empty());
+    EXPECT_EQ(std::vector<int>({ 1, 2 }), advanceTo(ms(150)));
+}
+
+TEST_F(TimerWheelTest, TimeBeforeTheWheelStartedIsIgnored)
+{
+    wheel.schedule(1, start + ms(250));
+    EXPECT_TRUE(advanceTo(-ms(1000)).empty());
+    EXPECT_EQ(std::vector<int>({ 1 }), advanceTo(ms(350)));
+}
+
+TEST_F(TimerWheelTest, EmptyWheelSkipsIdleTime)
+{
+    EXPECT_TRUE(advanceTo(ms(3600 * 1000)).empty());
+    EXPECT_GT(wheel.nextTick(), start + ms(3600 * 1000));
+    wheel.schedule(1, start + ms(3600 * 1000 + 250));
+    EXPECT_TRUE(advanceTo(ms(3600 * 1000 + 150)).empty());
+    EXPECT_EQ(std::vector<int>({ 1 }), advanceTo(ms(3600 * 1000 + 350)));
+}
+
+TEST(TimerWheelIdleTest, ScheduleCatchesUpWithTheClock)
+{
+    // Nothing advanced the wheel while it sat empty
+    Wheel wheel(std::chrono::milliseconds(1), SLOTS);
+    std::this_thread::sleep_for(ms(50));
+    Wheel::Clock::time_point now = Wheel::Clock::now();
+    wheel.schedule(1, now + ms(20));
+    EXPECT_GE(wheel.nextTick(), now - ms(1));
+
+    std::vector<int> expired;
+    wheel.advance(now + ms(10), expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.advance(now + ms(30), expired);
+    EXPECT_EQ(std::vector<int>({ 1 }), expired);
+}
+
+} // namespace